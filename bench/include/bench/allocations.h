@@ -0,0 +1,16 @@
+#ifndef BENCH_BENCH_ALLOCATIONS_H
+#define BENCH_BENCH_ALLOCATIONS_H
+
+#include <cinttypes>
+
+namespace bench {
+
+// Global operator new of benchmark, which uses this header, is replaced by counting one.
+// Counters are shared by all threads
+[[nodiscard]] uint64_t get_allocations_count() noexcept;
+
+[[nodiscard]] uint64_t get_allocated_bytes() noexcept;
+
+}
+
+#endif //BENCH_BENCH_ALLOCATIONS_H
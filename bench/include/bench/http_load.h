@@ -0,0 +1,42 @@
+#ifndef BENCH_BENCH_HTTP_LOAD_H
+#define BENCH_BENCH_HTTP_LOAD_H
+
+#include <cinttypes>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+
+struct LoadConfig {
+    // cppcheck-suppress unusedStructMember
+    uint16_t port = 0; // server on 127.0.0.1
+    // cppcheck-suppress unusedStructMember
+    size_t connections = 32; // every connection has own client thread
+    // cppcheck-suppress unusedStructMember
+    size_t requests = 10000; // total count, split between connections
+    // cppcheck-suppress unusedStructMember
+    std::string request; // raw request, the same for every response
+};
+
+struct LoadResult {
+    // cppcheck-suppress unusedStructMember
+    size_t responses = 0;
+    // cppcheck-suppress unusedStructMember
+    size_t bytes = 0; // response heads and bodies
+    // cppcheck-suppress unusedStructMember
+    double seconds = 0;
+    // cppcheck-suppress unusedStructMember
+    std::vector<double> latencies_us; // one per response
+};
+
+// Closed loop load: every connection sends next request after response to previous one and
+// is reopened if server closes it. Throws std::runtime_error if server fails or doesn't respond 200
+LoadResult run_load(const LoadConfig &cfg);
+
+// Request with keep-alive, body of POST request is body_size bytes
+[[nodiscard]] std::string make_request(std::string_view method, std::string_view path, size_t body_size = 0);
+
+}
+
+#endif //BENCH_BENCH_HTTP_LOAD_H
@@ -0,0 +1,25 @@
+#ifndef BENCH_BENCH_SAMPLE_REQUESTS_H
+#define BENCH_BENCH_SAMPLE_REQUESTS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+
+struct SampleRequest {
+    // cppcheck-suppress unusedStructMember
+    std::string_view name;
+    // cppcheck-suppress unusedStructMember
+    std::string raw; // whole request with body
+    // cppcheck-suppress unusedStructMember
+    bool is_chunked = false; // parser decodes chunked body in place, so raw copy must be parsed
+};
+
+// Requests as sent by browsers and clients: header sets of Chrome, Firefox and Safari navigations,
+// curl, form POST and chunked upload
+[[nodiscard]] std::vector<SampleRequest> make_sample_requests();
+
+}
+
+#endif //BENCH_BENCH_SAMPLE_REQUESTS_H
@@ -0,0 +1,55 @@
+#ifndef BENCH_BENCH_SERVER_PROCESS_H
+#define BENCH_BENCH_SERVER_PROCESS_H
+
+#include <atomic>
+#include <cinttypes>
+#include <functional>
+#include <string_view>
+#include <thread>
+
+extern "C" {
+#include <sys/types.h>
+}
+
+namespace bench {
+
+// Server under load runs in child process, so its syscalls and cpu time are measured apart from client.
+// Traced process is stopped by ptrace on every syscall entry and exit of all its threads, this makes it
+// many times slower, so latency and throughput must be measured in separate untraced run
+class ServerProcess {
+  public:
+    // run is called in child process and must not return while server works
+    ServerProcess(const std::function<void()> &run, bool is_traced);
+
+    ServerProcess(const ServerProcess &) = delete;
+
+    ServerProcess &operator=(const ServerProcess &) = delete;
+
+    // Waits until server accepts connections on 127.0.0.1:port, throws std::runtime_error on timeout
+    void wait_listening(uint16_t port);
+
+    // Syscalls made by all threads of traced process since start
+    [[nodiscard]] uint64_t get_syscalls_count() const noexcept;
+
+    // User and system cpu time of all threads
+    [[nodiscard]] double get_cpu_seconds() const;
+
+    // Kills server and waits until nothing listens on its port (see wait_listening), so next server
+    // on this port doesn't share connections with listening sockets of killed one
+    void kill() noexcept;
+
+    ~ServerProcess() noexcept;
+
+  private:
+    std::atomic<pid_t> pid_ = -1;
+    std::atomic<uint64_t> syscalls_count_ = 0;
+    uint16_t port_ = 0;
+
+    std::thread tracer_;
+
+    void trace();
+};
+
+}
+
+#endif //BENCH_BENCH_SERVER_PROCESS_H
@@ -0,0 +1,83 @@
+#ifndef BENCH_BENCH_UTILS_H
+#define BENCH_BENCH_UTILS_H
+
+#include <chrono>
+#include <cinttypes>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+using clock_t = std::chrono::steady_clock;
+
+// Command line options like "connections=64", option without value is "1"
+class Args {
+  public:
+    Args(int argc, char **argv);
+
+    [[nodiscard]] long get_int(std::string_view name, long default_value) const;
+
+    [[nodiscard]] std::string get_string(std::string_view name, std::string_view default_value) const;
+
+    // Comma separated lists like "sizes=1K,64K,1M"
+    [[nodiscard]] std::vector<long> get_ints(std::string_view name, std::string_view default_value) const;
+
+    [[nodiscard]] std::vector<std::string> get_strings(std::string_view name,
+                                                       std::string_view default_value) const;
+
+  private:
+    std::vector<std::pair<std::string, std::string>> options_;
+
+    [[nodiscard]] const std::string *find(std::string_view name) const noexcept;
+};
+
+// Keeps value and memory it points to from being optimized out
+template<typename T>
+inline void do_not_optimize(const T &value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Calls op in batches of growing size until batch takes at least min_batch_time, then returns the
+// best nanoseconds per call of several batches of that size, so preemption doesn't spoil result
+template<typename Op>
+double measure_ns(Op &&op, std::chrono::milliseconds min_batch_time = std::chrono::milliseconds(20),
+                  int rounds = 5) {
+    size_t batch_size = 1;
+    for (;;) {
+        const auto start = clock_t::now();
+        for (size_t i = 0; i < batch_size; ++i) {
+            op();
+        }
+        if (clock_t::now() - start >= min_batch_time) {
+            break;
+        }
+        batch_size *= 2;
+    }
+
+    double best = 0;
+    for (int round = 0; round < rounds; ++round) {
+        const auto start = clock_t::now();
+        for (size_t i = 0; i < batch_size; ++i) {
+            op();
+        }
+        const std::chrono::duration<double, std::nano> duration = clock_t::now() - start;
+
+        const auto ns = duration.count() / static_cast<double>(batch_size);
+        if (round == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+// Sorts values, p is in [0, 100]
+[[nodiscard]] double percentile(std::vector<double> &values, double p);
+
+// Prints "name: value unit" line with aligned values
+void report(std::string_view name, double value, std::string_view unit);
+
+}
+
+#endif //BENCH_BENCH_UTILS_H
@@ -0,0 +1,66 @@
+#include "bench/allocations.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations_count = 0;
+std::atomic<uint64_t> allocated_bytes = 0;
+
+void count(size_t size) noexcept {
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+}
+
+namespace bench {
+
+uint64_t get_allocations_count() noexcept {
+    return allocations_count.load(std::memory_order_relaxed);
+}
+
+uint64_t get_allocated_bytes() noexcept {
+    return allocated_bytes.load(std::memory_order_relaxed);
+}
+
+}
+
+// nickeskov: standard library implements array and nothrow forms through these ones
+void *operator new(size_t size) {
+    count(size);
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    count(size);
+    const auto align = static_cast<size_t>(alignment);
+    // nickeskov: aligned_alloc requires size to be multiple of alignment
+    void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
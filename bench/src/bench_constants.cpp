@@ -0,0 +1,188 @@
+// Constant lookups: switch and length grouped tables of constants against std::unordered_map tables, which
+// were used before (built from the same texts), and HttpHeaders::contains against map keyed by lowercase
+// copies of names. Lookups cycle through all known keys, so branch predictor doesn't learn one answer
+#include "bench/allocations.h"
+#include "bench/utils.h"
+
+#include "tinyhttp/constants.h"
+#include "tinyhttp/http_headers.h"
+#include "tinyhttp/utils.h"
+
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+namespace constants = tinyhttp::constants;
+
+using constants::well_known_header;
+
+constexpr uint64_t ALLOCATIONS_LOOKUPS = 100000;
+
+constexpr uint16_t MIN_STATUS_CODE = 100;
+constexpr uint16_t MAX_STATUS_CODE = 599;
+
+// nickeskov: request headers as sent by browsers and sought by server
+constexpr std::string_view HEADER_NAMES[] = {
+        "Host", "Connection", "User-Agent", "Accept", "Accept-Encoding", "Accept-Language", "Cookie",
+        "Referer", "Content-Length", "Content-Type", "Transfer-Encoding", "If-None-Match", "If-Modified-Since",
+        "Range", "If-Range", "Sec-Fetch-Mode", "Upgrade-Insecure-Requests",
+};
+
+template<typename Op>
+void measure(const std::string &name, Op &&op) {
+    const auto ns = bench::measure_ns(op);
+
+    const auto allocations_before = bench::get_allocations_count();
+    for (uint64_t i = 0; i < ALLOCATIONS_LOOKUPS; ++i) {
+        op();
+    }
+    const auto allocations = bench::get_allocations_count() - allocations_before;
+
+    bench::report(name, ns, "ns/lookup");
+    bench::report(name + " allocations", static_cast<double>(allocations) / ALLOCATIONS_LOOKUPS, "per lookup");
+}
+
+// nickeskov: cycles through keys, op is called with next key
+template<typename Key, typename Op>
+void measure_keys(const std::string &name, const std::vector<Key> &keys, Op &&op) {
+    size_t next = 0;
+    measure(name, [&] {
+        bench::do_not_optimize(op(keys[next]));
+        if (++next == keys.size()) {
+            next = 0;
+        }
+    });
+}
+
+std::vector<well_known_header> get_well_known_headers() {
+    std::vector<well_known_header> headers;
+    for (size_t index = 1; index < constants::WELL_KNOWN_HEADERS_COUNT; ++index) {
+        headers.push_back(static_cast<well_known_header>(index));
+    }
+    return headers;
+}
+
+std::vector<constants::http_response_status> get_statuses() {
+    std::vector<constants::http_response_status> statuses;
+    for (auto code = MIN_STATUS_CODE; code <= MAX_STATUS_CODE; ++code) {
+        const auto status = static_cast<constants::http_response_status>(code);
+        try {
+            static_cast<void>(constants::get_http_response_status_text(status));
+            statuses.push_back(status);
+        } catch (std::out_of_range &) {
+            continue;
+        }
+    }
+    return statuses;
+}
+
+void run_methods() {
+    std::vector<constants::http_method> methods;
+    std::vector<std::string_view> texts;
+    std::unordered_map<std::string_view, constants::http_method> codes_map;
+    std::unordered_map<constants::http_method, std::string_view> texts_map;
+
+    for (auto method = constants::http_method::GET; method <= constants::http_method::TRACE;
+         method = static_cast<constants::http_method>(static_cast<uint8_t>(method) + 1)) {
+        const auto text = constants::get_http_method_text(method);
+
+        methods.push_back(method);
+        texts.push_back(text);
+        codes_map.emplace(text, method);
+        texts_map.emplace(method, text);
+    }
+
+    measure_keys("method code switch", texts, [](std::string_view text) {
+        return constants::get_http_method_code(text);
+    });
+    measure_keys("method code unordered_map", texts, [&](std::string_view text) {
+        return codes_map.at(text);
+    });
+
+    measure_keys("method text switch", methods, [](constants::http_method method) {
+        return constants::get_http_method_text(method);
+    });
+    measure_keys("method text unordered_map", methods, [&](constants::http_method method) {
+        return texts_map.at(method);
+    });
+}
+
+void run_statuses() {
+    const auto statuses = get_statuses();
+
+    std::unordered_map<constants::http_response_status, std::string_view> texts_map;
+    for (const auto status : statuses) {
+        texts_map.emplace(status, constants::get_http_response_status_text(status));
+    }
+
+    measure_keys("status text switch", statuses, [](constants::http_response_status status) {
+        return constants::get_http_response_status_text(status);
+    });
+    measure_keys("status text unordered_map", statuses, [&](constants::http_response_status status) {
+        return texts_map.at(status);
+    });
+}
+
+void run_headers() {
+    const std::vector<std::string_view> names(std::begin(HEADER_NAMES), std::end(HEADER_NAMES));
+
+    std::unordered_map<std::string, well_known_header> headers_map;
+    for (const auto header : get_well_known_headers()) {
+        headers_map.emplace(tinyhttp::utils::to_lower(constants::get_well_known_header_text(header)), header);
+    }
+
+    measure_keys("header code length groups", names, [](std::string_view name) {
+        return constants::get_well_known_header(name);
+    });
+    measure_keys("header code unordered_map lowercase", names, [&](std::string_view name) {
+        const auto found = headers_map.find(tinyhttp::utils::to_lower(name));
+        return found == headers_map.end() ? well_known_header::UNKNOWN_ : found->second;
+    });
+
+    // nickeskov: typical static file response, most of sought headers are absent in it
+    tinyhttp::HttpHeaders headers;
+    std::unordered_map<std::string, std::string> lowercase_headers;
+    for (const auto header : {well_known_header::CONTENT_TYPE, well_known_header::CONTENT_LENGTH,
+                              well_known_header::ETAG, well_known_header::LAST_MODIFIED,
+                              well_known_header::ACCEPT_RANGES}) {
+        const auto name = constants::get_well_known_header_text(header);
+        headers.emplace(name, "value");
+        lowercase_headers.emplace(tinyhttp::utils::to_lower(name), "value");
+    }
+
+    const auto sought = get_well_known_headers();
+    std::vector<std::string_view> sought_names;
+    for (const auto header : sought) {
+        sought_names.push_back(constants::get_well_known_header_text(header));
+    }
+
+    measure_keys("HttpHeaders contains enum", sought, [&](well_known_header header) {
+        return headers.contains(header);
+    });
+    measure_keys("HttpHeaders contains name", sought_names, [&](std::string_view name) {
+        return headers.contains(name);
+    });
+    measure_keys("unordered_map contains lowercase", sought_names, [&](std::string_view name) {
+        return lowercase_headers.count(tinyhttp::utils::to_lower(name)) != 0;
+    });
+}
+
+}
+
+int main() {
+    try {
+        run_methods();
+        run_statuses();
+        run_headers();
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
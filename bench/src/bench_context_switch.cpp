@@ -0,0 +1,97 @@
+// Context switch cost: resume/yield pair of coroutine library, bare swap_context pair of its context
+// and ucontext swapcontext pair (which coroutines used before, it makes rt_sigprocmask syscall per switch).
+// Build coroutine with -DENABLE_UCONTEXT=ON to measure library on ucontext.
+#include "bench/utils.h"
+
+#include "coroutine/context.h"
+#include "coroutine/coroutine.h"
+
+#include <cstdio>
+#include <exception>
+#include <memory>
+
+extern "C" {
+#include <ucontext.h>
+}
+
+namespace {
+
+constexpr size_t STACK_SIZE = 1 << 16;
+
+constexpr coroutine::routine_t ROUTINE_ID = 1;
+
+coroutine::Context main_context;
+coroutine::Context routine_context;
+
+[[noreturn]] void context_entry() {
+    for (;;) {
+        coroutine::swap_context(routine_context, main_context);
+    }
+}
+
+ucontext_t main_ucontext;
+ucontext_t routine_ucontext;
+
+void ucontext_entry() {
+    for (;;) {
+        ::swapcontext(&routine_ucontext, &main_ucontext);
+    }
+}
+
+double measure_coroutine() {
+    bool is_stopped = false;
+    coroutine::create(ROUTINE_ID, [&is_stopped] {
+        while (!is_stopped) {
+            coroutine::yield();
+        }
+    });
+
+    const auto ns = bench::measure_ns([] {
+        coroutine::resume(ROUTINE_ID);
+    });
+
+    is_stopped = true;
+    coroutine::resume(ROUTINE_ID);
+    return ns;
+}
+
+double measure_context() {
+    const auto stack = std::make_unique<char[]>(STACK_SIZE);
+    coroutine::make_context(routine_context, stack.get(), STACK_SIZE, context_entry);
+
+    return bench::measure_ns([] {
+        coroutine::swap_context(main_context, routine_context);
+    });
+}
+
+double measure_ucontext() {
+    const auto stack = std::make_unique<char[]>(STACK_SIZE);
+
+    ::getcontext(&routine_ucontext);
+    routine_ucontext.uc_stack.ss_sp = stack.get();
+    routine_ucontext.uc_stack.ss_size = STACK_SIZE;
+    routine_ucontext.uc_link = nullptr;
+    ::makecontext(&routine_ucontext, ucontext_entry, 0);
+
+    return bench::measure_ns([] {
+        ::swapcontext(&main_ucontext, &routine_ucontext);
+    });
+}
+
+}
+
+int main() {
+    try {
+#ifdef COROUTINE_WITH_UCONTEXT
+        bench::report("coroutine resume/yield (ucontext build)", measure_coroutine(), "ns/pair");
+#else
+        bench::report("coroutine resume/yield", measure_coroutine(), "ns/pair");
+#endif
+        bench::report("swap_context pair", measure_context(), "ns/pair");
+        bench::report("ucontext swapcontext pair", measure_ucontext(), "ns/pair");
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Date header: formatting through stringstream with locale (as every response did before date cache)
+// against formatting by hand and per thread cache, and response heads built both ways.
+// Options: locale=en_US.UTF8 (of stringstream formatting, "C" is used if it isn't installed)
+#include "bench/allocations.h"
+#include "bench/utils.h"
+
+#include "tinyhttp/constants.h"
+#include "tinyhttp/http_headers.h"
+#include "tinyhttp/http_response.h"
+#include "tinyhttp/http_response_line.h"
+#include "tinyhttp/utils.h"
+
+#include <array>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <locale>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr const char *DATE_FORMAT = "%a, %d %b %Y %T %Z";
+
+constexpr uint64_t ALLOCATIONS_CALLS = 10000;
+
+template<typename Op>
+void measure(const std::string &name, Op &&op) {
+    const auto ns = bench::measure_ns(op);
+
+    const auto allocations_before = bench::get_allocations_count();
+    for (uint64_t i = 0; i < ALLOCATIONS_CALLS; ++i) {
+        op();
+    }
+    const auto allocations = bench::get_allocations_count() - allocations_before;
+
+    bench::report(name, ns, "ns");
+    bench::report(name + " allocations", static_cast<double>(allocations) / ALLOCATIONS_CALLS, "per call");
+}
+
+std::string get_locale(const bench::Args &args) {
+    auto locale = args.get_string("locale", "en_US.UTF8");
+    try {
+        std::locale{locale};
+    } catch (std::runtime_error &) {
+        std::fprintf(stderr, "locale %s isn't installed, C locale is used\n", locale.c_str());
+        locale = "C";
+    }
+    return locale;
+}
+
+}
+
+int main(int argc, char **argv) {
+    namespace constants = tinyhttp::constants;
+    namespace utils = tinyhttp::utils;
+
+    try {
+        const bench::Args args(argc, argv);
+        const auto locale = get_locale(args);
+
+        measure("date stringstream with locale", [&] {
+            bench::do_not_optimize(utils::now_time_to_str_gmt(DATE_FORMAT, locale.c_str()));
+        });
+
+        std::array<char, utils::HTTP_DATE_LENGTH> date{};
+        measure("date format_http_date", [&] {
+            utils::format_http_date(std::time(nullptr), date.data());
+            bench::do_not_optimize(date);
+        });
+
+        measure("date cached", [] {
+            bench::do_not_optimize(utils::get_cached_date_http_str());
+        });
+
+        // nickeskov: Server and Date were stored in headers map of every response
+        measure("head with formatted date", [&] {
+            const tinyhttp::HttpResponseLine response_line(constants::http_response_status::OK,
+                                                           constants::http_version::V1_1);
+            tinyhttp::HttpHeaders headers;
+            headers.emplace(constants::headers::server, constants::server_name);
+            headers.emplace(constants::headers::date, utils::now_time_to_str_gmt(DATE_FORMAT, locale.c_str()));
+            headers.emplace(constants::headers::connection, constants::connection_types::close);
+
+            bench::do_not_optimize(response_line.to_string() + headers.to_string());
+        });
+
+        std::string head;
+        measure("head with cached basic headers", [&] {
+            const tinyhttp::HttpResponse response(constants::http_response_status::OK);
+
+            head.clear();
+            response.serialize_head(head);
+            bench::do_not_optimize(head);
+        });
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
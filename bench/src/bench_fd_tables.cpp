@@ -0,0 +1,134 @@
+// Lookup of connection state on every event: std::map keyed by fd (client table of worker and routine
+// registry before fd indexed tables) against std::unordered_map and fd indexed vector of unique_ptr.
+// Events come for random connections, so tables don't stay in cache.
+// Then resume/yield of coroutines by id, where routine registry is fd indexed table.
+// Options: connections=10K,100K, routines=1K,10K (every routine maps stack with guard page, so count
+//          is limited by vm.max_map_count)
+#include "bench/utils.h"
+
+#include "coroutine/coroutine.h"
+
+#include <array>
+#include <cstdio>
+#include <exception>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr size_t EVENTS_COUNT = 1 << 20;
+
+// nickeskov: first fds are taken by stdio, listening socket and epoll
+constexpr int FIRST_CLIENT_FD = 5;
+
+// nickeskov: size of worker client (connection, io buffer, arena) without memory it owns
+struct Client {
+    // cppcheck-suppress unusedStructMember
+    uint32_t current_events = 0;
+    // cppcheck-suppress unusedStructMember
+    std::array<char, 252> state{};
+};
+
+std::vector<int> make_events(size_t connections) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> distribution(FIRST_CLIENT_FD,
+                                                    FIRST_CLIENT_FD + static_cast<int>(connections) - 1);
+
+    std::vector<int> events(EVENTS_COUNT);
+    for (auto &fd : events) {
+        fd = distribution(random);
+    }
+    return events;
+}
+
+template<typename Find>
+double measure_events(const std::vector<int> &events, Find &&find) {
+    size_t next = 0;
+    return bench::measure_ns([&] {
+        Client &client = find(events[next]);
+        client.current_events ^= 1u;
+        bench::do_not_optimize(client);
+        next = (next + 1) % events.size();
+    });
+}
+
+void run_tables(size_t connections) {
+    const auto events = make_events(connections);
+    const auto name = std::to_string(connections) + " connections ";
+
+    std::map<int, Client> tree;
+    std::unordered_map<int, Client> hash;
+    std::vector<std::unique_ptr<Client>> table;
+    for (int fd = FIRST_CLIENT_FD; fd < FIRST_CLIENT_FD + static_cast<int>(connections); ++fd) {
+        tree.emplace(fd, Client());
+        hash.emplace(fd, Client());
+
+        if (table.size() <= static_cast<size_t>(fd)) {
+            table.resize(static_cast<size_t>(fd) + 1);
+        }
+        table[static_cast<size_t>(fd)] = std::make_unique<Client>();
+    }
+
+    bench::report(name + "std::map", measure_events(events, [&](int fd) -> Client & {
+        return tree.at(fd);
+    }), "ns/event");
+
+    bench::report(name + "std::unordered_map", measure_events(events, [&](int fd) -> Client & {
+        return hash.at(fd);
+    }), "ns/event");
+
+    bench::report(name + "fd indexed vector", measure_events(events, [&](int fd) -> Client & {
+        return *table.at(static_cast<size_t>(fd));
+    }), "ns/event");
+}
+
+void run_routines(size_t routines) {
+    bool is_stopped = false;
+
+    const auto first_id = static_cast<coroutine::routine_t>(FIRST_CLIENT_FD);
+    for (auto id = first_id; id < first_id + routines; ++id) {
+        coroutine::create(id, [&is_stopped] {
+            while (!is_stopped) {
+                coroutine::yield();
+            }
+        });
+    }
+
+    const auto events = make_events(routines);
+
+    size_t next = 0;
+    const auto ns = bench::measure_ns([&] {
+        coroutine::resume(static_cast<coroutine::routine_t>(events[next]));
+        next = (next + 1) % events.size();
+    });
+    bench::report(std::to_string(routines) + " routines resume/yield by id", ns, "ns/event");
+
+    is_stopped = true;
+    for (auto id = first_id; id < first_id + routines; ++id) {
+        coroutine::resume(id);
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    try {
+        const bench::Args args(argc, argv);
+
+        for (const auto connections : args.get_ints("connections", "10K,100K")) {
+            run_tables(static_cast<size_t>(connections));
+        }
+
+        for (const auto routines : args.get_ints("routines", "1K,10K")) {
+            run_routines(static_cast<size_t>(routines));
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
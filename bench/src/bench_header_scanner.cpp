@@ -0,0 +1,125 @@
+// Header scanning of browser header sets (Chrome, Firefox, Safari) and other sample requests: find_headers_end
+// against std::string_view::find, index_header_lines against separate find passes per line, which
+// parser did before, and full request parse. Kernel is chosen at compile time, see scanner::get_kernel
+#include "bench/sample_requests.h"
+#include "bench/utils.h"
+
+#include "tinyhttp/header_scanner.h"
+#include "tinyhttp/http_request_parser.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+namespace scanner = tinyhttp::scanner;
+
+constexpr std::string_view NEWLINE = "\r\n";
+
+constexpr std::string_view HEADERS_END = "\r\n\r\n";
+
+constexpr size_t MAX_LINES = 64;
+
+bool is_invalid_symbol(char symbol) noexcept {
+    const auto code = static_cast<unsigned char>(symbol);
+    return (code < 0x20 && symbol != '\t') || code == 0x7f;
+}
+
+// nickeskov: line ends, colon and invalid characters are searched by separate passes over every line
+scanner::ScanResult find_header_lines(std::string_view block, scanner::HeaderLine *lines,
+                                      size_t max_lines) noexcept {
+    scanner::ScanResult result{0, 0, true};
+
+    size_t start = 0;
+    while (result.lines_count < max_lines) {
+        const auto end = block.find(NEWLINE, start);
+        if (end == std::string_view::npos) {
+            break;
+        }
+
+        const auto line = block.substr(start, end - start);
+        if (std::find_if(line.begin(), line.end(), is_invalid_symbol) != line.end()) {
+            result.is_valid = false;
+            break;
+        }
+
+        const auto colon = std::min(line.find(':'), line.size());
+        lines[result.lines_count++] = {static_cast<uint32_t>(start), static_cast<uint32_t>(start + colon),
+                                       static_cast<uint32_t>(end)};
+
+        start = end + NEWLINE.size();
+        result.scanned_size = start;
+    }
+    return result;
+}
+
+std::string_view get_headers_block(std::string_view request) {
+    const auto start = request.find(NEWLINE) + NEWLINE.size();
+    const auto end = request.find(HEADERS_END) + NEWLINE.size();
+    return request.substr(start, end - start);
+}
+
+void run_sample(const bench::SampleRequest &sample) {
+    const std::string name(sample.name);
+    const std::string_view request = sample.raw;
+
+    bench::report(name + " request size", static_cast<double>(request.size()), "bytes");
+
+    bench::report(name + " find_headers_end", bench::measure_ns([&] {
+        bench::do_not_optimize(scanner::find_headers_end(request, 0));
+    }), "ns");
+
+    bench::report(name + " std::string_view::find", bench::measure_ns([&] {
+        bench::do_not_optimize(request.find(HEADERS_END));
+    }), "ns");
+
+    const auto block = get_headers_block(request);
+    std::array<scanner::HeaderLine, MAX_LINES> lines{};
+
+    const auto indexed = scanner::index_header_lines(block, lines.data(), lines.size());
+    const auto found = find_header_lines(block, lines.data(), lines.size());
+    if (indexed.lines_count != found.lines_count || !indexed.is_valid || !found.is_valid) {
+        throw std::logic_error("scanners disagree on " + name + " request");
+    }
+
+    bench::report(name + " index_header_lines", bench::measure_ns([&] {
+        bench::do_not_optimize(scanner::index_header_lines(block, lines.data(), lines.size()));
+        bench::do_not_optimize(lines);
+    }), "ns");
+
+    bench::report(name + " find passes per line", bench::measure_ns([&] {
+        bench::do_not_optimize(find_header_lines(block, lines.data(), lines.size()));
+        bench::do_not_optimize(lines);
+    }), "ns");
+
+    tinyhttp::HttpRequestParser parser;
+    std::string buffer;
+    buffer.reserve(request.size());
+
+    bench::report(name + " full parse", bench::measure_ns([&] {
+        buffer.assign(request);
+        parser.reset();
+        bench::do_not_optimize(parser.parse(buffer));
+    }), "ns");
+}
+
+}
+
+int main() {
+    try {
+        std::printf("scanner kernel: %s\n", scanner::to_string(scanner::get_kernel()));
+
+        for (const auto &sample : bench::make_sample_requests()) {
+            run_sample(sample);
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,308 @@
+// Closed loop load of tinyhttp server over loopback: throughput, latency, server cpu and syscalls per request.
+// Options: server=body (handler responds body= bytes, request has upload= bytes body)
+//          server=static (BasicStaticServer downloads of files= sizes, every size takes volume= bytes in total)
+//          connections=16 (4 for static), requests=4000, threads=2 (server workers), mode=lt,et,
+//          backend=epoll,io_uring (event backend of workers), syscalls=1, traced_requests=1000, port=8090
+#include "bench/http_load.h"
+#include "bench/server_process.h"
+#include "bench/utils.h"
+
+#include "tinyhttp/basic_static_server.h"
+#include "tinyhttp/server.h"
+#include "trivilog/safe_stdout_logger.h"
+#include "unixprimwrap/errors.h"
+#include "unixprimwrap/poller.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+namespace {
+
+constexpr double MEGABYTE = 1024 * 1024;
+
+constexpr double GIGABYTE = 1024 * MEGABYTE;
+
+constexpr size_t FILE_WRITE_SIZE = 1 << 20;
+
+class BodyServer : public tinyhttp::Server {
+  public:
+    BodyServer(uint16_t port, trivilog::BaseLogger &logger, size_t body_size)
+            : Server("127.0.0.1", port, logger), body_(body_size, 'b') {}
+
+    tinyhttp::HttpResponse on_request(const tinyhttp::HttpRequest &) override {
+        return make_response(std::pmr::get_default_resource());
+    }
+
+    tinyhttp::HttpResponse on_request_view(const tinyhttp::HttpRequestView &request) override {
+        return make_response(request.get_memory_resource());
+    }
+
+  private:
+    std::string body_;
+
+    [[nodiscard]] tinyhttp::HttpResponse make_response(std::pmr::memory_resource *resource) const {
+        tinyhttp::HttpResponse response(tinyhttp::constants::http_response_status::OK,
+                                        tinyhttp::constants::http_version::V1_1, resource);
+        response.set_body(body_);
+        return response;
+    }
+};
+
+// nickeskov: document root of static server, it is removed with all files
+class TempDirectory {
+  public:
+    TempDirectory() {
+        char path[] = "/tmp/bench_http_load.XXXXXX";
+        if (::mkdtemp(path) == nullptr) {
+            throw std::runtime_error("cannot create temp directory: " + std::string(std::strerror(errno)));
+        }
+        path_ = path;
+    }
+
+    TempDirectory(const TempDirectory &) = delete;
+
+    TempDirectory &operator=(const TempDirectory &) = delete;
+
+    // Returns file name
+    std::string create_file(size_t size) {
+        const auto name = "file_" + std::to_string(size) + ".bin";
+        const auto path = path_ + "/" + name;
+
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("cannot create " + path + ": " + std::strerror(errno));
+        }
+        files_.push_back(path);
+
+        // nickeskov: file isn't sparse, so it is read from page cache as real one
+        const std::string chunk(FILE_WRITE_SIZE, 'f');
+        for (size_t written = 0; written < size;) {
+            const ssize_t bytes = ::write(fd, chunk.data(), std::min(chunk.size(), size - written));
+            if (bytes < 0) {
+                const int errno_code = errno;
+                ::close(fd);
+                throw std::runtime_error("cannot write " + path + ": " + std::strerror(errno_code));
+            }
+            written += static_cast<size_t>(bytes);
+        }
+        ::close(fd);
+
+        return name;
+    }
+
+    [[nodiscard]] const std::string &get_path() const noexcept {
+        return path_;
+    }
+
+    ~TempDirectory() noexcept {
+        for (const auto &file : files_) {
+            ::unlink(file.c_str());
+        }
+        ::rmdir(path_.c_str());
+    }
+
+  private:
+    std::string path_;
+    std::vector<std::string> files_;
+};
+
+using server_factory_t = std::function<std::unique_ptr<tinyhttp::Server>(uint16_t, trivilog::BaseLogger &)>;
+
+struct Variant {
+    // cppcheck-suppress unusedStructMember
+    std::string name;
+    // cppcheck-suppress unusedStructMember
+    tinyhttp::Server::EventLoopConfig cfg;
+};
+
+struct Workload {
+    // cppcheck-suppress unusedStructMember
+    std::string name;
+    // cppcheck-suppress unusedStructMember
+    server_factory_t make_server; // called in server process
+    // cppcheck-suppress unusedStructMember
+    bench::LoadConfig load;
+    // cppcheck-suppress unusedStructMember
+    size_t traced_requests = 0;
+};
+
+bool is_supported(unixprimwrap::poller_backend backend) {
+    try {
+        unixprimwrap::make_poller(backend);
+    } catch (unixprimwrap::errors::PollerError &e) {
+        std::fprintf(stderr, "%s backend is skipped: %s\n", unixprimwrap::to_string(backend), e.what());
+        return false;
+    }
+    return true;
+}
+
+std::vector<Variant> make_variants(const bench::Args &args) {
+    std::vector<Variant> variants;
+
+    for (const auto &backend_name : args.get_strings("backend", "epoll,io_uring")) {
+        auto backend = unixprimwrap::poller_backend::EPOLL;
+        if (backend_name == "io_uring") {
+            backend = unixprimwrap::poller_backend::IO_URING;
+        } else if (backend_name != "epoll") {
+            throw std::invalid_argument("unknown backend: " + backend_name);
+        }
+
+        if (!is_supported(backend)) {
+            continue;
+        }
+
+        for (const auto &mode : args.get_strings("mode", "lt,et")) {
+            Variant variant;
+            variant.name = mode + " " + backend_name;
+            variant.cfg.edge_triggered = mode == "et";
+            variant.cfg.keepalive_max_requests = 0;
+            variant.cfg.event_backend = backend;
+            // nickeskov: io_uring poll has no EPOLLEXCLUSIVE, so every worker accepts on own socket
+            variant.cfg.reuse_port = backend == unixprimwrap::poller_backend::IO_URING;
+            variants.push_back(variant);
+        }
+    }
+    return variants;
+}
+
+Workload make_body_workload(const bench::Args &args) {
+    const auto body_size = static_cast<size_t>(args.get_int("body", 1 << 20));
+    const auto upload_size = static_cast<size_t>(args.get_int("upload", 0));
+
+    Workload workload;
+    workload.name = "body " + std::to_string(body_size) + "b";
+    workload.make_server = [body_size](uint16_t port, trivilog::BaseLogger &logger) {
+        return std::make_unique<BodyServer>(port, logger, body_size);
+    };
+    workload.load.connections = static_cast<size_t>(args.get_int("connections", 16));
+    workload.load.requests = static_cast<size_t>(args.get_int("requests", 4000));
+    workload.load.request = bench::make_request(upload_size > 0 ? "POST" : "GET", "/", upload_size);
+    workload.traced_requests = static_cast<size_t>(args.get_int("traced_requests", 1000));
+
+    return workload;
+}
+
+std::vector<Workload> make_static_workloads(const bench::Args &args, TempDirectory &document_root) {
+    const auto volume = static_cast<size_t>(args.get_int("volume", 2L << 30));
+    const auto connections = static_cast<size_t>(args.get_int("connections", 4));
+
+    std::vector<Workload> workloads;
+    for (const auto size : args.get_ints("files", "1M,64M,1G")) {
+        const auto file_size = static_cast<size_t>(size);
+        const auto file_name = document_root.create_file(file_size);
+
+        Workload workload;
+        workload.name = "file " + std::to_string(file_size) + "b";
+        workload.make_server = [&document_root](uint16_t port, trivilog::BaseLogger &logger) {
+            return std::make_unique<tinyhttp::BasicStaticServer>("127.0.0.1", port, logger,
+                                                                 document_root.get_path());
+        };
+        workload.load.connections = connections;
+        workload.load.requests = std::max(connections, volume / file_size);
+        workload.load.request = bench::make_request("GET", "/" + file_name);
+        workload.traced_requests = workload.load.requests;
+
+        workloads.push_back(std::move(workload));
+    }
+    return workloads;
+}
+
+void run(const bench::Args &args, const Variant &variant, const Workload &workload) {
+    const auto port = static_cast<uint16_t>(args.get_int("port", 8090));
+    const auto threads = static_cast<size_t>(args.get_int("threads", 2));
+
+    const auto run_server = [&] {
+        trivilog::SafeStdoutLogger logger;
+        logger.set_level(trivilog::log_level::ERROR);
+
+        workload.make_server(port, logger)->run(variant.cfg, threads);
+    };
+
+    auto load = workload.load;
+    load.port = port;
+
+    // nickeskov: the first requests of each connection fault in stacks, arenas, socket buffers and page cache
+    auto warmup = load;
+    warmup.requests = std::min(load.requests, load.connections * 4);
+
+    const auto name = variant.name + " " + workload.name;
+
+    {
+        bench::ServerProcess server(run_server, false);
+        server.wait_listening(port);
+        bench::run_load(warmup);
+
+        const auto cpu_before = server.get_cpu_seconds();
+        auto result = bench::run_load(load);
+        const auto cpu_seconds = server.get_cpu_seconds() - cpu_before;
+
+        const auto responses = static_cast<double>(result.responses);
+        const auto bytes = static_cast<double>(result.bytes);
+        bench::report(name + " requests", responses / result.seconds, "req/s");
+        bench::report(name + " responses", bytes / MEGABYTE / result.seconds, "MB/s");
+        bench::report(name + " latency p50", bench::percentile(result.latencies_us, 50), "us");
+        bench::report(name + " latency p99", bench::percentile(result.latencies_us, 99), "us");
+        bench::report(name + " server cpu", cpu_seconds * 1e6 / responses, "us/req");
+        bench::report(name + " server cpu per GB", cpu_seconds / (bytes / GIGABYTE), "s");
+    }
+
+    if (args.get_int("syscalls", 1) != 0) {
+        auto traced = load;
+        traced.requests = workload.traced_requests;
+
+        bench::ServerProcess server(run_server, true);
+        server.wait_listening(port);
+        bench::run_load(warmup);
+
+        const auto syscalls_before = server.get_syscalls_count();
+        const auto result = bench::run_load(traced);
+        const auto syscalls = server.get_syscalls_count() - syscalls_before;
+
+        bench::report(name + " server syscalls",
+                      static_cast<double>(syscalls) / static_cast<double>(result.responses), "per req");
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    try {
+        const bench::Args args(argc, argv);
+
+        const auto server = args.get_string("server", "body");
+
+        std::vector<Workload> workloads;
+        TempDirectory document_root;
+        if (server == "body") {
+            workloads.push_back(make_body_workload(args));
+        } else if (server == "static") {
+            workloads = make_static_workloads(args, document_root);
+        } else {
+            throw std::invalid_argument("unknown server: " + server);
+        }
+
+        const auto variants = make_variants(args);
+        for (const auto &workload : workloads) {
+            for (const auto &variant : variants) {
+                run(args, variant, workload);
+            }
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Logging from several threads into file: SafeFileLogger (mutex and std::endl per line) against AsyncLogger
+// with DROP and BLOCK overflow policies. Time includes final flush, so it is time until all lines are written.
+// Options: threads=1,4, messages=800K (total for all threads), file=path (temporary file by default)
+#include "bench/utils.h"
+
+#include "trivilog/async_logger.h"
+#include "trivilog/safe_file_logger.h"
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include <unistd.h>
+}
+
+namespace {
+
+using trivilog::AsyncLogger;
+
+// nickeskov: typical line of tinyhttp worker
+constexpr std::string_view MESSAGE = "[worker 3] accepted new connection from 127.0.0.1:44452, fd=17";
+
+size_t count_lines(const std::string &filename) {
+    std::ifstream file(filename);
+    size_t lines = 0;
+    for (std::string line; std::getline(file, line);) {
+        ++lines;
+    }
+    return lines;
+}
+
+double log_messages(trivilog::BaseLogger &logger, size_t threads_count, size_t messages) {
+    const auto per_thread = messages / threads_count;
+
+    const auto start = bench::clock_t::now();
+
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count);
+    for (size_t i = 0; i < threads_count; ++i) {
+        threads.emplace_back([&logger, per_thread] {
+            for (size_t message = 0; message < per_thread; ++message) {
+                logger.info(MESSAGE);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+
+    const std::chrono::duration<double, std::nano> duration = bench::clock_t::now() - start;
+    return duration.count() / static_cast<double>(per_thread * threads_count);
+}
+
+class LogFile {
+  public:
+    explicit LogFile(std::string filename) : filename_(std::move(filename)), is_temporary_(filename_.empty()) {
+        if (is_temporary_) {
+            std::string path = "/tmp/bench_logger_XXXXXX";
+            const int fd = ::mkstemp(path.data());
+            if (fd == -1) {
+                throw std::runtime_error("can't create temporary log file");
+            }
+            ::close(fd);
+            filename_ = path;
+        }
+    }
+
+    LogFile(const LogFile &) = delete;
+
+    LogFile &operator=(const LogFile &) = delete;
+
+    ~LogFile() noexcept {
+        if (is_temporary_) {
+            ::unlink(filename_.c_str());
+        }
+    }
+
+    [[nodiscard]] const std::string &get_filename() const noexcept {
+        return filename_;
+    }
+
+  private:
+    std::string filename_;
+    bool is_temporary_;
+};
+
+void run_threads(const std::string &filename, size_t threads_count, size_t messages) {
+    const auto name = std::to_string(threads_count) + " threads ";
+
+    {
+        trivilog::SafeFileLogger logger(filename);
+        bench::report(name + "SafeFileLogger", log_messages(logger, threads_count, messages), "ns/msg");
+    }
+    bench::report(name + "SafeFileLogger lines written", static_cast<double>(count_lines(filename)), "lines");
+
+    for (const auto policy : {AsyncLogger::overflow_policy::DROP, AsyncLogger::overflow_policy::BLOCK}) {
+        const std::string policy_name = policy == AsyncLogger::overflow_policy::DROP ? "DROP" : "BLOCK";
+
+        AsyncLogger::Config config;
+        config.policy = policy;
+
+        uint64_t dropped = 0;
+        {
+            AsyncLogger logger(filename, config);
+            bench::report(name + "AsyncLogger " + policy_name, log_messages(logger, threads_count, messages),
+                          "ns/msg");
+            dropped = logger.get_dropped_count();
+        }
+        // nickeskov: drainer adds line with count of dropped messages
+        bench::report(name + "AsyncLogger " + policy_name + " lines written",
+                      static_cast<double>(count_lines(filename)), "lines");
+        bench::report(name + "AsyncLogger " + policy_name + " dropped", static_cast<double>(dropped), "msgs");
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    try {
+        const bench::Args args(argc, argv);
+
+        const LogFile file(args.get_string("file", ""));
+        const auto messages = static_cast<size_t>(args.get_int("messages", 800000));
+
+        for (const auto threads_count : args.get_ints("threads", "1,4")) {
+            run_threads(file.get_filename(), static_cast<size_t>(threads_count), messages);
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
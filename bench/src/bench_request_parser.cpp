@@ -0,0 +1,110 @@
+// Request parsing: requests/s and heap allocations per request of zero-copy view and owning HttpRequest.
+// Every request is copied into io buffer before parsing, as it is received by worker.
+// Options: read=64 (size of reads of incremental parsing), requests=10000 (to count allocations)
+#include "bench/allocations.h"
+#include "bench/sample_requests.h"
+#include "bench/utils.h"
+
+#include "tinyhttp/http_request.h"
+#include "tinyhttp/http_request_parser.h"
+#include "tinyhttp/request_arena.h"
+
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using parse_status = tinyhttp::HttpRequestParser::parse_status;
+
+template<typename Op>
+void measure(const bench::Args &args, const std::string &name, Op &&op) {
+    const auto ns = bench::measure_ns(op);
+
+    const auto requests = static_cast<uint64_t>(args.get_int("requests", 10000));
+    const auto allocations_before = bench::get_allocations_count();
+    for (uint64_t i = 0; i < requests; ++i) {
+        op();
+    }
+    const auto allocations = bench::get_allocations_count() - allocations_before;
+
+    bench::report(name + " requests", 1e9 / ns, "req/s");
+    bench::report(name + " allocations",
+                  static_cast<double>(allocations) / static_cast<double>(requests), "per req");
+}
+
+void check(parse_status status) {
+    if (status != parse_status::COMPLETE) {
+        throw std::runtime_error("sample request is incomplete");
+    }
+}
+
+void run_sample(const bench::Args &args, const bench::SampleRequest &sample) {
+    const std::string name(sample.name);
+    const auto read_size = static_cast<size_t>(args.get_int("read", 64));
+
+    tinyhttp::HttpRequestParser parser;
+    std::string buffer;
+    buffer.reserve(sample.raw.size());
+
+    measure(args, name + " view", [&] {
+        buffer.assign(sample.raw);
+        parser.reset();
+        check(parser.parse(buffer));
+        bench::do_not_optimize(parser.get_request().get_header(tinyhttp::constants::well_known_header::CONNECTION));
+    });
+
+    // nickeskov: parser resumes from already scanned bytes after every read
+    measure(args, name + " view by " + std::to_string(read_size) + "b reads", [&] {
+        buffer.clear();
+        parser.reset();
+
+        auto status = parse_status::INCOMPLETE;
+        for (size_t pos = 0; pos < sample.raw.size(); pos += read_size) {
+            buffer.append(sample.raw, pos, read_size);
+            status = parser.parse(buffer);
+        }
+        check(status);
+        bench::do_not_optimize(parser.get_request().get_header(tinyhttp::constants::well_known_header::CONNECTION));
+    });
+
+    measure(args, name + " owning HttpRequest", [&] {
+        buffer.assign(sample.raw);
+        parser.reset();
+        check(parser.parse(buffer));
+
+        const tinyhttp::HttpRequest request(parser.get_request());
+        bench::do_not_optimize(request);
+    });
+
+    // nickeskov: as in worker, owning copy is allocated from connection arena
+    tinyhttp::RequestArena arena;
+    parser.set_memory_resource(&arena);
+
+    measure(args, name + " owning HttpRequest in arena", [&] {
+        arena.begin_request();
+        buffer.assign(sample.raw);
+        parser.reset();
+        check(parser.parse(buffer));
+
+        const tinyhttp::HttpRequest request(parser.get_request());
+        bench::do_not_optimize(request);
+    });
+}
+
+}
+
+int main(int argc, char **argv) {
+    try {
+        const bench::Args args(argc, argv);
+
+        for (const auto &sample : bench::make_sample_requests()) {
+            run_sample(args, sample);
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Response sending over loopback TCP: copy of whole response by HttpResponse::to_string written by 2 KB
+// from io buffer (as responses were sent before vectored writes) against serialize_head and IovecWriter.
+// Options: sizes=1K,64K,1M,4M (body sizes), port=8091
+#include "bench/allocations.h"
+#include "bench/utils.h"
+
+#include "tinyhttp/connection.h"
+#include "tinyhttp/http_response.h"
+#include "tinyhttp/iovec_writer.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+namespace {
+
+constexpr size_t OLD_WRITE_SIZE = 2048;
+
+constexpr size_t DRAIN_BUFFER_SIZE = 256 * 1024;
+
+constexpr double MEGABYTE = 1024 * 1024;
+
+// nickeskov: accepts one connection and reads everything from it until EOF in own thread
+class Drain {
+  public:
+    explicit Drain(uint16_t port) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            throw std::runtime_error("cannot create socket: " + std::string(std::strerror(errno)));
+        }
+
+        int reuse = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (::bind(listen_fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) < 0
+            || ::listen(listen_fd_, 1) < 0) {
+            const int errno_code = errno;
+            ::close(listen_fd_);
+            throw std::runtime_error("cannot listen on port " + std::to_string(port) + ": "
+                                     + std::strerror(errno_code));
+        }
+
+        thread_ = std::thread([this] {
+            const int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+
+            std::vector<char> buffer(DRAIN_BUFFER_SIZE);
+            while (::read(fd, buffer.data(), buffer.size()) > 0) {}
+            ::close(fd);
+        });
+    }
+
+    Drain(const Drain &) = delete;
+
+    Drain &operator=(const Drain &) = delete;
+
+    // Connection must be closed before, otherwise it waits forever
+    ~Drain() noexcept {
+        thread_.join();
+        ::close(listen_fd_);
+    }
+
+  private:
+    int listen_fd_ = -1;
+    std::thread thread_;
+};
+
+template<typename Op>
+void measure(const std::string &name, size_t response_size, Op &&op) {
+    const auto ns = bench::measure_ns(op);
+
+    constexpr uint64_t responses = 16;
+    const auto allocations_before = bench::get_allocations_count();
+    const auto bytes_before = bench::get_allocated_bytes();
+    for (uint64_t i = 0; i < responses; ++i) {
+        op();
+    }
+    const auto allocations = bench::get_allocations_count() - allocations_before;
+    const auto bytes = bench::get_allocated_bytes() - bytes_before;
+
+    bench::report(name, ns / 1000, "us");
+    bench::report(name + " throughput", static_cast<double>(response_size) / MEGABYTE / (ns / 1e9), "MB/s");
+    bench::report(name + " allocations", static_cast<double>(allocations) / responses, "per resp");
+    bench::report(name + " allocated", static_cast<double>(bytes) / responses / 1024, "KB/resp");
+}
+
+void run_size(uint16_t port, size_t body_size) {
+    const Drain drain(port);
+    tinyhttp::Connection connection("127.0.0.1", port, false);
+
+    tinyhttp::HttpResponse response(tinyhttp::constants::http_response_status::OK);
+    response.set_body(std::string(body_size, 'b'));
+
+    const auto response_size = response.to_string().size();
+    const auto name = "body " + std::to_string(body_size) + "b";
+
+    measure(name + " to_string", response_size, [&] {
+        auto &io_buffer = connection.get_io_buffer();
+        io_buffer.clear();
+        io_buffer += response.to_string();
+
+        while (!io_buffer.empty()) {
+            connection.write_from_io_buff(OLD_WRITE_SIZE);
+        }
+    });
+
+    std::string head;
+    measure(name + " iovec", response_size, [&] {
+        head.clear();
+        response.serialize_head(head);
+
+        tinyhttp::IovecWriter writer;
+        writer.append(head);
+        writer.append(response.get_body());
+
+        while (!writer.empty()) {
+            writer.write_to(connection);
+        }
+    });
+}
+
+}
+
+int main(int argc, char **argv) {
+    try {
+        const bench::Args args(argc, argv);
+        const auto port = static_cast<uint16_t>(args.get_int("port", 8091));
+
+        for (const auto size : args.get_ints("sizes", "1K,64K,1M,4M")) {
+            run_size(port, static_cast<size_t>(size));
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
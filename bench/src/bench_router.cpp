@@ -0,0 +1,188 @@
+// Route lookup among 300 REST routes (30 resources): radix tree Router against linear chain of
+// segment by segment compares, as handlers match request path by hand.
+// Lookups go to routes in random order, first and last routes of chain and unknown path.
+#include "bench/allocations.h"
+#include "bench/utils.h"
+
+#include "tinyhttp/router.h"
+
+#include <cstdio>
+#include <exception>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using tinyhttp::constants::http_method;
+
+constexpr size_t LOOKUPS_COUNT = 1 << 16;
+
+constexpr uint64_t ALLOCATIONS_LOOKUPS = 100000;
+
+constexpr std::string_view RESOURCES[] = {
+        "users", "groups", "orders", "items", "carts", "payments", "invoices", "shipments", "addresses",
+        "reviews", "categories", "brands", "coupons", "discounts", "warehouses", "suppliers", "returns",
+        "refunds", "tickets", "messages", "notifications", "sessions", "tokens", "devices", "reports",
+        "exports", "imports", "webhooks", "audits", "settings",
+};
+
+struct RouteTemplate {
+    // cppcheck-suppress unusedStructMember
+    http_method method;
+    // cppcheck-suppress unusedStructMember
+    std::string_view pattern; // nickeskov: "{}" is replaced by resource
+    // cppcheck-suppress unusedStructMember
+    std::string_view path;
+};
+
+constexpr RouteTemplate RESOURCE_ROUTES[] = {
+        {http_method::GET, "/api/v1/{}", "/api/v1/{}"},
+        {http_method::POST, "/api/v1/{}", "/api/v1/{}"},
+        {http_method::GET, "/api/v1/{}/:id", "/api/v1/{}/10245"},
+        {http_method::PUT, "/api/v1/{}/:id", "/api/v1/{}/10245"},
+        {http_method::DELETE, "/api/v1/{}/:id", "/api/v1/{}/10245"},
+        {http_method::GET, "/api/v1/{}/:id/history", "/api/v1/{}/10245/history"},
+        {http_method::GET, "/api/v1/{}/:id/comments", "/api/v1/{}/10245/comments"},
+        {http_method::POST, "/api/v1/{}/:id/comments", "/api/v1/{}/10245/comments"},
+        {http_method::GET, "/api/v1/{}/:id/comments/:comment_id", "/api/v1/{}/10245/comments/77"},
+        {http_method::GET, "/static/{}/*path", "/static/{}/css/site.css"},
+};
+
+struct Route {
+    // cppcheck-suppress unusedStructMember
+    http_method method;
+    // cppcheck-suppress unusedStructMember
+    std::string pattern;
+    // cppcheck-suppress unusedStructMember
+    std::string path; // nickeskov: path of request, which matches pattern
+};
+
+std::string expand(std::string_view text, std::string_view resource) {
+    std::string result(text);
+    result.replace(result.find("{}"), 2, resource);
+    return result;
+}
+
+std::vector<Route> make_routes() {
+    std::vector<Route> routes;
+    for (const auto resource : RESOURCES) {
+        for (const auto &route : RESOURCE_ROUTES) {
+            routes.push_back({route.method, expand(route.pattern, resource), expand(route.path, resource)});
+        }
+    }
+    return routes;
+}
+
+// nickeskov: takes next segment without leading '/', path must start with '/'
+std::string_view next_segment(std::string_view &path) noexcept {
+    path.remove_prefix(1);
+    const auto end = std::min(path.find('/'), path.size());
+    const auto segment = path.substr(0, end);
+    path.remove_prefix(end);
+    return segment;
+}
+
+// Routes are checked in order, segments of pattern are compared with segments of path
+class LinearRouter {
+  public:
+    explicit LinearRouter(const std::vector<Route> &routes) : routes_(routes) {}
+
+    [[nodiscard]] const Route *match(http_method method, std::string_view path) const noexcept {
+        for (const auto &route : routes_) {
+            if (route.method == method && is_matched(route.pattern, path)) {
+                return &route;
+            }
+        }
+        return nullptr;
+    }
+
+  private:
+    const std::vector<Route> &routes_;
+
+    static bool is_matched(std::string_view pattern, std::string_view path) noexcept {
+        while (!pattern.empty() && !path.empty()) {
+            const auto pattern_segment = next_segment(pattern);
+            const auto path_segment = next_segment(path);
+
+            if (pattern_segment.front() == '*') {
+                return true;
+            }
+            if (pattern_segment.front() == ':' ? path_segment.empty() : pattern_segment != path_segment) {
+                return false;
+            }
+        }
+        return pattern.empty() && path.empty();
+    }
+};
+
+template<typename Op>
+void measure(const std::string &name, Op &&op) {
+    const auto ns = bench::measure_ns(op);
+
+    const auto allocations_before = bench::get_allocations_count();
+    for (uint64_t i = 0; i < ALLOCATIONS_LOOKUPS; ++i) {
+        op();
+    }
+    const auto allocations = bench::get_allocations_count() - allocations_before;
+
+    bench::report(name, ns, "ns/lookup");
+    bench::report(name + " allocations", static_cast<double>(allocations) / ALLOCATIONS_LOOKUPS, "per lookup");
+}
+
+tinyhttp::HttpResponse respond(const tinyhttp::HttpRequestView &request, const tinyhttp::RouteParams &) {
+    return tinyhttp::HttpResponse(tinyhttp::constants::http_response_status::OK,
+                                  request.get_version(), request.get_memory_resource());
+}
+
+}
+
+int main() {
+    try {
+        const auto routes = make_routes();
+
+        tinyhttp::Router router;
+        for (const auto &route : routes) {
+            router.add(route.method, route.pattern, respond);
+        }
+        const LinearRouter linear_router(routes);
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<size_t> distribution(0, routes.size() - 1);
+        std::vector<const Route *> lookups(LOOKUPS_COUNT);
+        for (auto &lookup : lookups) {
+            lookup = &routes[distribution(random)];
+        }
+
+        const Route unknown{http_method::GET, "", "/api/v1/unknown/10245"};
+
+        const std::pair<std::string, std::vector<const Route *>> cases[] = {
+                {"random routes", lookups},
+                {"first route", {&routes.front()}},
+                {"last route", {&routes.back()}},
+                {"unknown path", {&unknown}},
+        };
+
+        for (const auto &[name, case_lookups] : cases) {
+            size_t next = 0;
+            tinyhttp::RouteParams params;
+            measure(std::to_string(routes.size()) + " routes radix tree, " + name, [&] {
+                const auto *route = case_lookups[next];
+                bench::do_not_optimize(router.match(route->method, route->path, params));
+                next = (next + 1) % case_lookups.size();
+            });
+
+            next = 0;
+            measure(std::to_string(routes.size()) + " routes linear, " + name, [&] {
+                const auto *route = case_lookups[next];
+                bench::do_not_optimize(linear_router.match(route->method, route->path));
+                next = (next + 1) % case_lookups.size();
+            });
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include "bench/http_load.h"
+#include "bench/utils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+extern "C" {
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+namespace bench {
+
+namespace {
+
+constexpr size_t READ_BUFFER_SIZE = 256 * 1024;
+
+constexpr std::string_view HEAD_END = "\r\n\r\n";
+
+bool iequals_prefix(std::string_view str, std::string_view prefix) noexcept {
+    if (str.size() < prefix.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        if ((str[i] | 0x20) != (prefix[i] | 0x20)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class Client {
+  public:
+    explicit Client(const LoadConfig &cfg) : cfg_(cfg), buffer_(READ_BUFFER_SIZE) {}
+
+    Client(const Client &) = delete;
+
+    Client &operator=(const Client &) = delete;
+
+    void run(size_t requests, LoadResult &result) {
+        result.latencies_us.reserve(requests);
+
+        for (size_t i = 0; i < requests; ++i) {
+            if (sock_fd_ < 0) {
+                connect();
+            }
+
+            const auto start = clock_t::now();
+            send_request();
+            result.bytes += read_response();
+            const std::chrono::duration<double, std::micro> latency = clock_t::now() - start;
+
+            result.latencies_us.push_back(latency.count());
+            ++result.responses;
+        }
+
+        disconnect();
+    }
+
+    ~Client() noexcept {
+        disconnect();
+    }
+
+  private:
+    const LoadConfig &cfg_;
+    std::vector<char> buffer_;
+
+    int sock_fd_ = -1;
+    bool is_reused_ = false;
+
+    void connect() {
+        sock_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (sock_fd_ < 0) {
+            throw std::runtime_error("cannot create client socket: " + std::string(std::strerror(errno)));
+        }
+
+        int no_delay = 1;
+        ::setsockopt(sock_fd_, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(cfg_.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (::connect(sock_fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) < 0) {
+            throw std::runtime_error("cannot connect to server: " + std::string(std::strerror(errno)));
+        }
+        is_reused_ = false;
+    }
+
+    void disconnect() noexcept {
+        if (sock_fd_ >= 0) {
+            ::close(sock_fd_);
+            sock_fd_ = -1;
+        }
+    }
+
+    void send_request() {
+        std::string_view rest = cfg_.request;
+        while (!rest.empty()) {
+            const ssize_t bytes_written = ::send(sock_fd_, rest.data(), rest.size(), MSG_NOSIGNAL);
+            if (bytes_written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("cannot send request: " + std::string(std::strerror(errno)));
+            }
+            rest.remove_prefix(static_cast<size_t>(bytes_written));
+        }
+    }
+
+    // nickeskov: body is only counted, so every part overwrites previous one
+    size_t receive_body_part() {
+        for (;;) {
+            const ssize_t bytes_read = ::recv(sock_fd_, buffer_.data(), buffer_.size(), 0);
+            if (bytes_read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes_read <= 0) {
+                throw std::runtime_error("server closed connection in the middle of response");
+            }
+            return static_cast<size_t>(bytes_read);
+        }
+    }
+
+    // nickeskov: closed loop client never has bytes of the next response in buffer
+    size_t read_response() {
+        size_t size = 0;
+        size_t head_size = 0;
+        while (head_size == 0) {
+            if (size == buffer_.size()) {
+                throw std::runtime_error("response head is too large");
+            }
+
+            const ssize_t bytes_read = ::recv(sock_fd_, buffer_.data() + size, buffer_.size() - size, 0);
+            if (bytes_read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes_read <= 0) {
+                // nickeskov: idle keep-alive connection may be closed by server before request is read
+                if (size == 0 && is_reused_) {
+                    disconnect();
+                    connect();
+                    send_request();
+                    continue;
+                }
+                throw std::runtime_error("server closed connection in the middle of response");
+            }
+            size += static_cast<size_t>(bytes_read);
+
+            const std::string_view received(buffer_.data(), size);
+            const auto head_end = received.find(HEAD_END);
+            if (head_end != std::string_view::npos) {
+                head_size = head_end + HEAD_END.size();
+            }
+        }
+
+        const std::string_view head(buffer_.data(), head_size);
+        const auto [content_length, is_closed] = parse_head(head);
+
+        size_t body_size = size - head_size;
+        while (body_size < content_length) {
+            body_size += receive_body_part();
+        }
+
+        if (is_closed) {
+            disconnect();
+        } else {
+            is_reused_ = true;
+        }
+        return head_size + body_size;
+    }
+
+    static std::pair<size_t, bool> parse_head(std::string_view head) {
+        if (head.size() < 12 || head.substr(9, 3) != "200") {
+            throw std::runtime_error("unexpected response: " + std::string(head.substr(0, head.find('\r'))));
+        }
+
+        size_t content_length = 0;
+        bool is_closed = false;
+
+        size_t line_begin = head.find("\r\n") + 2;
+        while (line_begin < head.size()) {
+            const auto line_end = head.find("\r\n", line_begin);
+            const auto line = head.substr(line_begin, line_end - line_begin);
+
+            if (iequals_prefix(line, "content-length:")) {
+                auto value = line.substr(line.find(':') + 1);
+                value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+                std::from_chars(value.data(), value.data() + value.size(), content_length);
+            } else if (iequals_prefix(line, "connection:") && line.find("close") != std::string_view::npos) {
+                is_closed = true;
+            } else if (iequals_prefix(line, "transfer-encoding:")) {
+                throw std::runtime_error("chunked responses are not supported by load client");
+            }
+
+            line_begin = line_end + 2;
+        }
+
+        return {content_length, is_closed};
+    }
+};
+
+}
+
+LoadResult run_load(const LoadConfig &cfg) {
+    std::vector<LoadResult> results(cfg.connections);
+    std::vector<std::thread> threads;
+    threads.reserve(cfg.connections);
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    const auto start = clock_t::now();
+
+    for (size_t i = 0; i < cfg.connections; ++i) {
+        const size_t requests = cfg.requests / cfg.connections + (i < cfg.requests % cfg.connections ? 1 : 0);
+
+        threads.emplace_back([&cfg, &results, &error_mutex, &error, i, requests] {
+            try {
+                Client(cfg).run(requests, results[i]);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(error_mutex);
+                error = std::current_exception();
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const std::chrono::duration<double> duration = clock_t::now() - start;
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    LoadResult total;
+    total.seconds = duration.count();
+    for (auto &result : results) {
+        total.responses += result.responses;
+        total.bytes += result.bytes;
+        total.latencies_us.insert(total.latencies_us.end(), result.latencies_us.begin(), result.latencies_us.end());
+    }
+    return total;
+}
+
+std::string make_request(std::string_view method, std::string_view path, size_t body_size) {
+    std::string request;
+    request.reserve(128 + body_size);
+
+    request.append(method).append(" ").append(path).append(" HTTP/1.1\r\n");
+    request.append("Host: 127.0.0.1\r\n");
+    request.append("User-Agent: tinyhttp-bench\r\n");
+    request.append("Accept: */*\r\n");
+    if (body_size > 0) {
+        request.append("Content-Length: ").append(std::to_string(body_size)).append("\r\n");
+    }
+    request.append("\r\n");
+    request.append(body_size, 'x');
+
+    return request;
+}
+
+}
@@ -0,0 +1,112 @@
+#include "bench/sample_requests.h"
+
+namespace bench {
+
+namespace {
+
+constexpr std::string_view CHROME =
+        "GET /catalog/item.html?id=1024&ref=search HTTP/1.1\r\n"
+        "Host: shop.example.com\r\n"
+        "Connection: keep-alive\r\n"
+        "sec-ch-ua: \"Chromium\";v=\"128\", \"Not;A=Brand\";v=\"24\", \"Google Chrome\";v=\"128\"\r\n"
+        "sec-ch-ua-mobile: ?0\r\n"
+        "sec-ch-ua-platform: \"Linux\"\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+        "Chrome/128.0.0.0 Safari/537.36\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,"
+        "*/*;q=0.8,application/signed-exchange;v=b3;q=0.7\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-User: ?1\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Referer: https://shop.example.com/search?q=lamp\r\n"
+        "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+        "Accept-Language: en-US,en;q=0.9,ru;q=0.8\r\n"
+        "Cookie: session=6f1c0e2a9b7d4f8e8a3c5d2b1e0f9a7c; theme=dark; _ga=GA1.1.1234567890.1700000000; "
+        "_ga_XYZ=GS1.1.1700000000.3.1.1700000100.0.0.0\r\n"
+        "\r\n";
+
+constexpr std::string_view FIREFOX =
+        "GET /catalog/item.html?id=1024&ref=search HTTP/1.1\r\n"
+        "Host: shop.example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:130.0) Gecko/20100101 Firefox/130.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+        "Referer: https://shop.example.com/search?q=lamp\r\n"
+        "Connection: keep-alive\r\n"
+        "Cookie: session=6f1c0e2a9b7d4f8e8a3c5d2b1e0f9a7c; theme=dark\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "Sec-Fetch-User: ?1\r\n"
+        "Priority: u=0, i\r\n"
+        "\r\n";
+
+constexpr std::string_view SAFARI =
+        "GET /catalog/item.html?id=1024&ref=search HTTP/1.1\r\n"
+        "Host: shop.example.com\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "Cookie: session=6f1c0e2a9b7d4f8e8a3c5d2b1e0f9a7c; theme=dark\r\n"
+        "Connection: keep-alive\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/605.1.15 "
+        "(KHTML, like Gecko) Version/17.6 Safari/605.1.15\r\n"
+        "Referer: https://shop.example.com/search?q=lamp\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Accept-Language: en-US,en;q=0.9\r\n"
+        "Priority: u=0, i\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "\r\n";
+
+constexpr std::string_view CURL =
+        "GET /index.html HTTP/1.1\r\n"
+        "Host: shop.example.com\r\n"
+        "User-Agent: curl/8.5.0\r\n"
+        "Accept: */*\r\n"
+        "\r\n";
+
+constexpr std::string_view FORM =
+        "POST /account/login HTTP/1.1\r\n"
+        "Host: shop.example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:130.0) Gecko/20100101 Firefox/130.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Content-Type: application/x-www-form-urlencoded\r\n"
+        "Content-Length: 64\r\n"
+        "Origin: https://shop.example.com\r\n"
+        "Connection: keep-alive\r\n"
+        "Cookie: session=6f1c0e2a9b7d4f8e8a3c5d2b1e0f9a7c\r\n"
+        "\r\n"
+        "login=someone%40example.com&password=correct+horse+battery+stapl";
+
+constexpr std::string_view CHUNKED =
+        "POST /upload HTTP/1.1\r\n"
+        "Host: shop.example.com\r\n"
+        "User-Agent: curl/8.5.0\r\n"
+        "Accept: */*\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "\r\n"
+        "20\r\n0123456789abcdef0123456789abcdef\r\n"
+        "10\r\n0123456789abcdef\r\n"
+        "8\r\n01234567\r\n"
+        "0\r\n\r\n";
+
+}
+
+std::vector<SampleRequest> make_sample_requests() {
+    return {
+            {"chrome", std::string(CHROME), false},
+            {"firefox", std::string(FIREFOX), false},
+            {"safari", std::string(SAFARI), false},
+            {"curl", std::string(CURL), false},
+            {"form", std::string(FORM), false},
+            {"chunked", std::string(CHUNKED), true},
+    };
+}
+
+}
@@ -0,0 +1,235 @@
+#include "bench/server_process.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+
+extern "C" {
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/prctl.h>
+#include <sys/ptrace.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+}
+
+namespace bench {
+
+namespace {
+
+constexpr auto LISTEN_TIMEOUT = std::chrono::seconds(10);
+
+// nickeskov: TRACESYSGOOD sets this bit in signal of syscall stops
+constexpr int SYSCALL_STOP_SIGNAL = SIGTRAP | 0x80;
+
+// nickeskov: TCP_LISTEN state in /proc/net/tcp
+constexpr unsigned TCP_LISTEN_STATE = 0x0A;
+
+bool is_port_listened(uint16_t port) noexcept {
+    std::FILE *tcp = std::fopen("/proc/net/tcp", "r");
+    if (tcp == nullptr) {
+        return false;
+    }
+
+    bool is_listened = false;
+
+    // nickeskov: lines are like "0: 0100007F:1F9A 00000000:0000 0A ...", first line is header
+    char line[256];
+    std::fgets(line, sizeof(line), tcp);
+    while (!is_listened && std::fgets(line, sizeof(line), tcp) != nullptr) {
+        unsigned local_port = 0;
+        unsigned state = 0;
+        if (std::sscanf(line, " %*u: %*x:%x %*x:%*x %x", &local_port, &state) == 2) {
+            is_listened = local_port == port && state == TCP_LISTEN_STATE;
+        }
+    }
+
+    std::fclose(tcp);
+    return is_listened;
+}
+
+pid_t fork_server(const std::function<void()> &run, bool is_traced) {
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+        throw std::runtime_error("cannot fork server process: " + std::string(std::strerror(errno)));
+    }
+
+    if (pid == 0) {
+        // nickeskov: server must not outlive benchmark, even if benchmark is killed
+        ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+        if (is_traced) {
+            ::raise(SIGSTOP); // nickeskov: server starts only after tracer is attached
+        }
+
+        try {
+            run();
+        } catch (std::exception &e) {
+            std::fprintf(stderr, "server process failed: %s\n", e.what());
+            ::_exit(1);
+        }
+        ::_exit(0);
+    }
+
+    return pid;
+}
+
+}
+
+ServerProcess::ServerProcess(const std::function<void()> &run, bool is_traced) {
+    if (!is_traced) {
+        pid_ = fork_server(run, false);
+        return;
+    }
+
+    // nickeskov: ptrace requests are accepted only from thread, which has attached to tracee
+    std::promise<void> attached;
+    auto is_attached = attached.get_future();
+
+    tracer_ = std::thread([this, &run, &attached] {
+        try {
+            const pid_t pid = fork_server(run, true);
+
+            if (::ptrace(PTRACE_SEIZE, pid, nullptr,
+                         PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACECLONE | PTRACE_O_EXITKILL) < 0) {
+                const int errno_code = errno;
+                ::kill(pid, SIGKILL);
+                ::waitpid(pid, nullptr, 0);
+                throw std::runtime_error("cannot trace server process: " + std::string(std::strerror(errno_code)));
+            }
+
+            pid_ = pid;
+            attached.set_value();
+        } catch (...) {
+            attached.set_exception(std::current_exception());
+            return;
+        }
+
+        trace();
+    });
+
+    try {
+        is_attached.get();
+    } catch (...) {
+        tracer_.join();
+        throw;
+    }
+}
+
+void ServerProcess::wait_listening(uint16_t port) {
+    port_ = port;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    const auto deadline = std::chrono::steady_clock::now() + LISTEN_TIMEOUT;
+    while (std::chrono::steady_clock::now() < deadline) {
+        const int sock_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        const int status = ::connect(sock_fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+        ::close(sock_fd);
+
+        if (status == 0) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    throw std::runtime_error("server doesn't listen on port " + std::to_string(port));
+}
+
+uint64_t ServerProcess::get_syscalls_count() const noexcept {
+    // nickeskov: every syscall stops tracee twice, on entry and on exit
+    return syscalls_count_.load(std::memory_order_relaxed) / 2;
+}
+
+double ServerProcess::get_cpu_seconds() const {
+    std::ifstream stat("/proc/" + std::to_string(pid_.load()) + "/stat");
+
+    std::string line;
+    std::getline(stat, line);
+
+    // nickeskov: utime and stime are 12th and 13th fields after process name, which may contain spaces
+    const auto name_end = line.rfind(')');
+    if (name_end == std::string::npos) {
+        throw std::runtime_error("cannot read cpu time of server process");
+    }
+
+    unsigned long utime = 0;
+    unsigned long stime = 0;
+    if (std::sscanf(line.c_str() + name_end + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                    &utime, &stime) != 2) {
+        throw std::runtime_error("cannot read cpu time of server process");
+    }
+
+    return static_cast<double>(utime + stime) / static_cast<double>(::sysconf(_SC_CLK_TCK));
+}
+
+void ServerProcess::kill() noexcept {
+    const pid_t pid = pid_.exchange(-1);
+    if (pid < 0) {
+        return;
+    }
+
+    ::kill(pid, SIGKILL);
+
+    if (tracer_.joinable()) {
+        tracer_.join(); // nickeskov: tracer reaps process
+    } else {
+        ::waitpid(pid, nullptr, 0);
+    }
+
+    // nickeskov: io_uring rings of killed process are destroyed asynchronously, until then
+    //  their listening sockets with SO_REUSEPORT still get connections
+    const auto deadline = std::chrono::steady_clock::now() + LISTEN_TIMEOUT;
+    while (port_ != 0 && is_port_listened(port_) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+ServerProcess::~ServerProcess() noexcept {
+    kill();
+}
+
+void ServerProcess::trace() {
+    const pid_t pid = pid_.load();
+
+    for (;;) {
+        int status = 0;
+        const pid_t stopped = ::waitpid(-1, &status, __WALL);
+        if (stopped < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        if (!WIFSTOPPED(status)) {
+            // nickeskov: process leader is reported after all its threads
+            if (stopped == pid) {
+                return;
+            }
+            continue;
+        }
+
+        int signal = 0;
+        const int stop_signal = WSTOPSIG(status);
+        if (stop_signal == SYSCALL_STOP_SIGNAL) {
+            syscalls_count_.fetch_add(1, std::memory_order_relaxed);
+        } else if ((status >> 16) == 0 && stop_signal != SIGSTOP) {
+            signal = stop_signal; // nickeskov: signal delivery stop, signal is passed to tracee
+        }
+
+        ::ptrace(PTRACE_SYSCALL, stopped, nullptr, signal);
+    }
+}
+
+}
@@ -0,0 +1,107 @@
+#include "bench/utils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace bench {
+
+namespace {
+
+long parse_int(std::string_view name, const std::string &value) {
+    char *end = nullptr;
+    const long result = std::strtol(value.c_str(), &end, 10);
+
+    // nickeskov: sizes may be written with K, M and G suffixes like "body=1M"
+    switch (*end) {
+        case 'K': {
+            return result << 10;
+        }
+        case 'M': {
+            return result << 20;
+        }
+        case 'G': {
+            return result << 30;
+        }
+        case '\0': {
+            return result;
+        }
+        default: {
+            throw std::invalid_argument("bad value of option " + std::string(name) + ": " + value);
+        }
+    }
+}
+
+}
+
+Args::Args(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        const auto delimiter = arg.find('=');
+        if (delimiter == std::string_view::npos) {
+            options_.emplace_back(arg, "1");
+        } else {
+            options_.emplace_back(arg.substr(0, delimiter), arg.substr(delimiter + 1));
+        }
+    }
+}
+
+long Args::get_int(std::string_view name, long default_value) const {
+    const auto *value = find(name);
+    return value == nullptr ? default_value : parse_int(name, *value);
+}
+
+std::vector<long> Args::get_ints(std::string_view name, std::string_view default_value) const {
+    std::vector<long> values;
+    for (const auto &value : get_strings(name, default_value)) {
+        values.push_back(parse_int(name, value));
+    }
+    return values;
+}
+
+std::string Args::get_string(std::string_view name, std::string_view default_value) const {
+    const auto *value = find(name);
+    return value == nullptr ? std::string(default_value) : *value;
+}
+
+std::vector<std::string> Args::get_strings(std::string_view name, std::string_view default_value) const {
+    const auto list = get_string(name, default_value);
+
+    std::vector<std::string> values;
+    for (size_t begin = 0; begin <= list.size();) {
+        const auto end = std::min(list.find(',', begin), list.size());
+        values.push_back(list.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return values;
+}
+
+const std::string *Args::find(std::string_view name) const noexcept {
+    for (const auto &[option_name, value] : options_) {
+        if (option_name == name) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+double percentile(std::vector<double> &values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    const auto index = static_cast<size_t>(p / 100 * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+void report(std::string_view name, double value, std::string_view unit) {
+    std::printf("%-48.*s %14.2f %.*s\n", static_cast<int>(name.size()), name.data(), value,
+                static_cast<int>(unit.size()), unit.data());
+    std::fflush(stdout);
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef COROUTINE_COROUTINE_CONTEXT_H
+#define COROUTINE_COROUTINE_CONTEXT_H
+
+#include <cinttypes>
+#include <cstddef>
+
+#if !defined(COROUTINE_WITH_UCONTEXT) && !defined(__x86_64__) && !defined(__aarch64__)
+#define COROUTINE_WITH_UCONTEXT
+#endif
+
+#ifdef COROUTINE_WITH_UCONTEXT
+extern "C" {
+#include <ucontext.h>
+}
+#endif
+
+namespace coroutine {
+
+// Execution context of routine.
+// On x86-64 and aarch64 only callee-saved registers are switched by hand-written code,
+// without signal mask syscall of swapcontext. ucontext is used on other architectures
+// or if COROUTINE_WITH_UCONTEXT is defined.
+struct Context {
+#ifdef COROUTINE_WITH_UCONTEXT
+    // cppcheck-suppress unusedStructMember
+    ucontext_t ctx{};
+#else
+    // cppcheck-suppress unusedStructMember
+    void *stack_pointer = nullptr; // nickeskov: registers are saved on the stack itself
+#endif
+};
+
+// Prepares context, which runs entry on stack on first switch to it.
+// Entry must never return, it must switch to another context at the end.
+void make_context(Context &context, void *stack, size_t stack_size, void (*entry)()) noexcept;
+
+// Saves current execution to from and continues to, returns false on error
+bool swap_context(Context &from, const Context &to) noexcept;
+
+}
+
+#endif //COROUTINE_COROUTINE_CONTEXT_H
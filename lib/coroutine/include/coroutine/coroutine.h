@@ -1,6 +1,8 @@
 #ifndef COROUTINE_COROUTINE_COROUTINE_H
 #define COROUTINE_COROUTINE_COROUTINE_H
 
+#include "coroutine/stack_pool.h"
+
 #include <cinttypes>
 #include <functional>
 #include <memory>
@@ -8,7 +10,6 @@
 namespace coroutine {
 
 using routine_t = size_t;
-using stack_t = std::unique_ptr<uint8_t[]>;
 using routine_function_t = std::function<void()>;
 
 enum class coroutine_status {
@@ -28,8 +29,17 @@ void yield();
 
 routine_t current();
 
+// Limits count of stacks cached by current thread pool, negative value means unlimited
 void set_freelist_max_size(ssize_t new_size);
 
+// Configures stack pool of current thread, new stack size affects only new routines
+void set_stack_pool_config(const StackPool::Config &cfg);
+
+[[nodiscard]] StackPoolStats get_stack_pool_stats();
+
+// Returns committed pages of idle stacks of current thread to kernel
+void release_idle_stacks();
+
 template<typename F, typename ...Args, typename = std::enable_if_t<!std::is_invocable_v<F>>>
 routine_t create(routine_t id, F &&f, Args &&... args) {
     return create(id, std::bind(std::forward<F>(f), std::forward<Args>(args)...));
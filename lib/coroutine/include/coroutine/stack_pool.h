@@ -0,0 +1,120 @@
+#ifndef COROUTINE_COROUTINE_STACK_POOL_H
+#define COROUTINE_COROUTINE_STACK_POOL_H
+
+#include <cinttypes>
+#include <vector>
+
+extern "C" {
+#include <sys/types.h>
+}
+
+namespace coroutine {
+
+// Routine stack in its own anonymous mapping with PROT_NONE guard page below it,
+// so stack overflow is SIGSEGV instead of silent heap corruption.
+// Pages are committed by kernel lazily, on first touch.
+class Stack {
+  public:
+    Stack() noexcept = default;
+
+    // size is rounded up to page size, throws std::bad_alloc if mapping fails
+    explicit Stack(size_t size);
+
+    Stack(Stack &&other) noexcept;
+
+    Stack &operator=(Stack &&other) noexcept;
+
+    Stack(const Stack &) = delete;
+
+    Stack &operator=(const Stack &) = delete;
+
+    // Lowest usable address, guard page is right below it
+    [[nodiscard]] void *data() const noexcept;
+
+    // Usable bytes, without guard page
+    [[nodiscard]] size_t size() const noexcept;
+
+    // Usable bytes with guard page
+    [[nodiscard]] size_t mapping_size() const noexcept;
+
+    [[nodiscard]] bool is_valid() const noexcept;
+
+    // Returns committed pages to kernel, they are zero filled on next touch
+    void release_pages() noexcept;
+
+    ~Stack() noexcept;
+
+  private:
+    uint8_t *mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+
+    void unmap() noexcept;
+};
+
+struct StackPoolStats {
+    // cppcheck-suppress unusedStructMember
+    size_t stacks_in_use = 0;
+    // cppcheck-suppress unusedStructMember
+    size_t peak_stacks_in_use = 0;
+    // cppcheck-suppress unusedStructMember
+    size_t cached_stacks = 0;
+    // cppcheck-suppress unusedStructMember
+    size_t mapped_bytes = 0; // address space of used and cached stacks, including guard pages
+    // cppcheck-suppress unusedStructMember
+    size_t peak_rss = 0; // peak resident set size of whole process, bytes
+};
+
+// Pool of stacks grouped by power of two size classes, not thread safe.
+// nickeskov: every stack is two mappings (guard and usable part), so count of stacks
+// is limited by vm.max_map_count sysctl, which is 65530 by default.
+class StackPool {
+  public:
+    struct Config {
+        // cppcheck-suppress unusedStructMember
+        size_t stack_size = 1u << 16u; // rounded up to power of two, at least page size
+        // cppcheck-suppress unusedStructMember
+        ssize_t max_cached_stacks = -1; // negative value means unlimited
+        // cppcheck-suppress unusedStructMember
+        bool release_idle_stacks = false; // madvise(MADV_DONTNEED) every stack returned to pool
+    };
+
+    StackPool() = default;
+
+    explicit StackPool(const Config &cfg);
+
+    StackPool(const StackPool &) = delete;
+
+    StackPool &operator=(const StackPool &) = delete;
+
+    // Stack of Config::stack_size
+    [[nodiscard]] Stack acquire();
+
+    [[nodiscard]] Stack acquire(size_t size);
+
+    void release(Stack &&stack) noexcept;
+
+    // Returns committed pages of all cached stacks to kernel
+    void release_idle_stacks() noexcept;
+
+    void set_config(const Config &cfg) noexcept;
+
+    [[nodiscard]] const Config &get_config() const noexcept;
+
+    [[nodiscard]] StackPoolStats get_stats() const noexcept;
+
+    ~StackPool() = default;
+
+  private:
+    Config cfg_{};
+    std::vector<std::vector<Stack>> cached_stacks_; // nickeskov: indexed by size class
+    size_t cached_count_ = 0;
+    size_t in_use_count_ = 0;
+    size_t peak_in_use_count_ = 0;
+    size_t mapped_bytes_ = 0;
+
+    void trim(size_t max_cached_count) noexcept;
+};
+
+}
+
+#endif //COROUTINE_COROUTINE_STACK_POOL_H
@@ -0,0 +1,160 @@
+#include "coroutine/context.h"
+
+namespace coroutine {
+
+#ifdef COROUTINE_WITH_UCONTEXT
+
+void make_context(Context &context, void *stack, size_t stack_size, void (*entry)()) noexcept {
+    getcontext(&context.ctx);
+    context.ctx.uc_stack.ss_sp = stack;
+    context.ctx.uc_stack.ss_size = stack_size;
+    context.ctx.uc_link = nullptr;
+    makecontext(&context.ctx, entry, 0);
+}
+
+bool swap_context(Context &from, const Context &to) noexcept {
+    return swapcontext(&from.ctx, &to.ctx) == 0;
+}
+
+#else
+
+extern "C" {
+// Pushes callee-saved registers, saves stack pointer to *from_stack_pointer,
+// switches to to_stack_pointer and pops registers saved there.
+void coroutine_switch_context(void **from_stack_pointer, void *to_stack_pointer) noexcept;
+}
+
+#if defined(__x86_64__)
+
+// nickeskov: System V AMD64 ABI, callee-saved are rbx, rbp, r12-r15, mxcsr control bits and x87 control word
+asm(R"(
+.text
+.p2align 4
+.hidden coroutine_switch_context
+.type coroutine_switch_context, @function
+coroutine_switch_context:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+.size coroutine_switch_context, .-coroutine_switch_context
+)");
+
+namespace {
+
+constexpr uint32_t DEFAULT_MXCSR = 0x1f80; // nickeskov: all exceptions masked, round to nearest
+constexpr uint16_t DEFAULT_FPU_CONTROL_WORD = 0x037f;
+
+// nickeskov: frame layout, which is popped by coroutine_switch_context, from lowest address
+struct InitialFrame {
+    uint32_t mxcsr;
+    uint16_t fpu_control_word;
+    uint16_t padding;
+    uint64_t r15;
+    uint64_t r14;
+    uint64_t r13;
+    uint64_t r12;
+    uint64_t rbx;
+    uint64_t rbp;
+    uint64_t return_address; // entry
+    uint64_t entry_return_address; // nickeskov: entry never returns, null terminates backtrace
+};
+
+}
+
+#elif defined(__aarch64__)
+
+// nickeskov: AAPCS64, callee-saved are x19-x29, link register x30 and low halves of v8-v15
+asm(R"(
+.text
+.p2align 4
+.hidden coroutine_switch_context
+.type coroutine_switch_context, %function
+coroutine_switch_context:
+    sub sp, sp, #160
+    stp x19, x20, [sp, #0]
+    stp x21, x22, [sp, #16]
+    stp x23, x24, [sp, #32]
+    stp x25, x26, [sp, #48]
+    stp x27, x28, [sp, #64]
+    stp x29, x30, [sp, #80]
+    stp d8, d9, [sp, #96]
+    stp d10, d11, [sp, #112]
+    stp d12, d13, [sp, #128]
+    stp d14, d15, [sp, #144]
+    mov x2, sp
+    str x2, [x0]
+    mov sp, x1
+    ldp x19, x20, [sp, #0]
+    ldp x21, x22, [sp, #16]
+    ldp x23, x24, [sp, #32]
+    ldp x25, x26, [sp, #48]
+    ldp x27, x28, [sp, #64]
+    ldp x29, x30, [sp, #80]
+    ldp d8, d9, [sp, #96]
+    ldp d10, d11, [sp, #112]
+    ldp d12, d13, [sp, #128]
+    ldp d14, d15, [sp, #144]
+    add sp, sp, #160
+    ret
+.size coroutine_switch_context, .-coroutine_switch_context
+)");
+
+namespace {
+
+// nickeskov: frame layout, which is popped by coroutine_switch_context, from lowest address
+struct InitialFrame {
+    uint64_t x19_x28[10];
+    uint64_t x29; // nickeskov: null frame pointer terminates backtrace
+    uint64_t x30; // entry
+    uint64_t d8_d15[8];
+};
+
+}
+
+#endif
+
+void make_context(Context &context, void *stack, size_t stack_size, void (*entry)()) noexcept {
+    // nickeskov: entry must see stack as after call: on x86-64 rsp points to entry_return_address
+    // and is 8 mod 16, on aarch64 sp is 16 bytes aligned
+    const auto stack_top = (reinterpret_cast<uintptr_t>(stack) + stack_size) & ~uintptr_t{15};
+
+    auto *frame = reinterpret_cast<InitialFrame *>(stack_top - sizeof(InitialFrame));
+    *frame = InitialFrame{};
+
+#if defined(__x86_64__)
+    frame->mxcsr = DEFAULT_MXCSR;
+    frame->fpu_control_word = DEFAULT_FPU_CONTROL_WORD;
+    frame->return_address = reinterpret_cast<uint64_t>(entry);
+#elif defined(__aarch64__)
+    frame->x30 = reinterpret_cast<uint64_t>(entry);
+#endif
+
+    context.stack_pointer = frame;
+}
+
+bool swap_context(Context &from, const Context &to) noexcept {
+    coroutine_switch_context(&from.stack_pointer, to.stack_pointer);
+    return true;
+}
+
+#endif
+
+}
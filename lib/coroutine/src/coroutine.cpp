@@ -1,82 +1,87 @@
 #include "coroutine/coroutine.h"
+#include "coroutine/context.h"
+#include "coroutine/stack_pool.h"
 
-#include <deque>
 #include <memory>
-#include <map>
+#include <string>
 #include <utility>
+#include <vector>
 #include <stdexcept>
 
-extern "C" {
-#include <ucontext.h>
-}
-
 namespace coroutine {
 
 class Routine;
 
 namespace {
 
-constexpr inline size_t ROUTINE_STACK_SIZE = 1u << 16u;
+// nickeskov: routines are indexed by id, so ids must be small dense integers (e.g. fds)
+constexpr inline routine_t MAX_ROUTINE_ID = 1u << 24u;
 
 thread_local struct Ordinator {
-    std::map<routine_t, Routine> routines;
-    std::deque<decltype(routines)::node_type> finished;
+    // nickeskov: must be destroyed after routines, they return stacks to pool
+    StackPool stack_pool;
+    // nickeskov: unique_ptr keeps routine address (and its context) stable while table grows
+    std::vector<std::unique_ptr<Routine>> routines;
     routine_t current = 0;
-    ucontext_t ctx{};
-    ssize_t freelist_max_size = -1;
+    Context ctx{};
 } ordinator; // NOLINT (nickeskov)
 // Initialization with thread_local storage
 // duration may throw an exception that cannot be caught
 
 void entry();
 
+Routine &get_routine(routine_t id);
+
 }
 
 class Routine {
   public:
-    explicit Routine(routine_function_t f)
-            : func(std::move(f)), stack(std::make_unique<uint8_t[]>(ROUTINE_STACK_SIZE)) {
-        getcontext(&ctx);
-        ctx.uc_stack.ss_sp = stack.get();
-        ctx.uc_stack.ss_size = ROUTINE_STACK_SIZE;
-        ctx.uc_link = &ordinator.ctx;
-        makecontext(&ctx, entry, 0);
+    Routine(const routine_function_t &f, Stack &&routine_stack)
+            : func(f), stack(std::move(routine_stack)) {
+        make_context(ctx, stack.data(), stack.size(), entry);
     }
 
     Routine(const Routine &) = delete;
 
     Routine &operator=(const Routine &) = delete;
 
-    void reset(const routine_function_t &f) {
-        func = f;
-        finished = false;
-        exception = {};
-        makecontext(&ctx, entry, 0);
+    ~Routine() {
+        ordinator.stack_pool.release(std::move(stack));
     }
 
   public:
     routine_function_t func;
-    stack_t stack;
+    Stack stack;
     bool finished = false;
-    ucontext_t ctx{};
+    Context ctx{};
     std::exception_ptr exception{};
 };
 
 routine_t create(routine_t id, const routine_function_t &function) {
+    if (id > MAX_ROUTINE_ID) {
+        throw std::out_of_range("routine id is too big, id=" + std::to_string(id));
+    }
+
     auto &o = ordinator;
-    if (o.finished.empty()) {
-        o.routines.emplace(std::make_pair(id, function));
-        return id;
-    } else {
-        auto node = std::move(o.finished.back());
-        o.finished.pop_back();
 
-        node.key() = id;
-        node.mapped().reset(function);
+    if (o.routines.size() <= id) {
+        o.routines.resize(id + 1);
+    }
+
+    auto &routine = o.routines[id];
+    if (routine) {
+        throw std::logic_error("routine already exists, id=" + std::to_string(id));
+    }
 
-        o.routines.insert(std::move(node));
-        return id;
+    auto stack = o.stack_pool.acquire();
+    try {
+        routine = std::make_unique<Routine>(function, std::move(stack));
+    } catch (...) {
+        o.stack_pool.release(std::move(stack));
+        throw;
     }
+
+    return id;
 }
 
 coroutine_status resume(routine_t id) {
@@ -86,13 +91,13 @@ coroutine_status resume(routine_t id) {
 
     auto &o = ordinator;
 
-    const auto &routine_ref = o.routines.at(id);
+    const auto &routine_ref = get_routine(id);
     if (routine_ref.finished) {
         return coroutine_status::NONE;
     }
 
     o.current = id;
-    if (swapcontext(&o.ctx, &routine_ref.ctx) < 0) {
+    if (!swap_context(o.ctx, routine_ref.ctx)) {
         o.current = 0;
         return coroutine_status::ERROR;
     }
@@ -100,11 +105,7 @@ coroutine_status resume(routine_t id) {
     if (routine_ref.finished) {
         auto exception_ptr = routine_ref.exception;
 
-        auto routine = o.routines.extract(id);
-        if (o.freelist_max_size < 0
-            || o.finished.size() < static_cast<size_t>(o.freelist_max_size)) {
-            o.finished.emplace_back(std::move(routine));
-        }
+        o.routines[id].reset(); // nickeskov: stack goes back to pool
 
         if (exception_ptr) {
             std::rethrow_exception(exception_ptr);
@@ -124,11 +125,9 @@ void kill(routine_t id, const std::exception_ptr &ptr) {
         throw std::invalid_argument("emtpy exception ptr");
     }
 
-    auto &o = ordinator;
-
-    auto &routine_ref = o.routines.at(id);
+    auto &routine_ref = get_routine(id);
     if (routine_ref.finished) {
-        throw std::logic_error("finished routine in map of active routines");
+        throw std::logic_error("finished routine in table of active routines");
     }
 
     routine_ref.exception = ptr;
@@ -146,10 +145,10 @@ void yield() {
         throw std::logic_error("trying call yield in main routine");
     }
 
-    auto &routine_ref = o.routines.at(id);
+    auto &routine_ref = get_routine(id);
 
     o.current = 0;
-    swapcontext(&routine_ref.ctx, &o.ctx);
+    swap_context(routine_ref.ctx, o.ctx);
 
     if (routine_ref.exception) {
         std::rethrow_exception(routine_ref.exception);
@@ -161,14 +160,21 @@ routine_t current() {
 }
 
 void set_freelist_max_size(ssize_t new_size) {
-    auto &o = ordinator;
+    auto cfg = ordinator.stack_pool.get_config();
+    cfg.max_cached_stacks = new_size;
+    ordinator.stack_pool.set_config(cfg);
+}
+
+void set_stack_pool_config(const StackPool::Config &cfg) {
+    ordinator.stack_pool.set_config(cfg);
+}
 
-    o.freelist_max_size = new_size;
+StackPoolStats get_stack_pool_stats() {
+    return ordinator.stack_pool.get_stats();
+}
 
-    if (new_size >= 0) {
-        o.finished.resize(new_size);
-        o.finished.shrink_to_fit();
-    }
+void release_idle_stacks() {
+    ordinator.stack_pool.release_idle_stacks();
 }
 
 namespace {
@@ -176,7 +182,7 @@ namespace {
 void entry() {
     auto &o = ordinator;
     routine_t id = o.current;
-    auto &routine_ref = o.routines.at(id);
+    auto &routine_ref = get_routine(id);
 
     if (routine_ref.func && !routine_ref.exception) {
         try {
@@ -188,6 +194,17 @@ void entry() {
 
     routine_ref.finished = true;
     o.current = 0;
+
+    // nickeskov: finished routine is never resumed, its context is destroyed with it
+    swap_context(routine_ref.ctx, o.ctx);
+}
+
+Routine &get_routine(routine_t id) {
+    auto &o = ordinator;
+    if (id >= o.routines.size() || !o.routines[id]) {
+        throw std::out_of_range("no routine with id=" + std::to_string(id));
+    }
+    return *o.routines[id];
 }
 
 }
@@ -0,0 +1,221 @@
+#include "coroutine/stack_pool.h"
+
+#include <new>
+#include <utility>
+
+extern "C" {
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+}
+
+namespace coroutine {
+
+namespace {
+
+size_t get_page_size() noexcept {
+    static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+size_t round_up_to_page(size_t size) noexcept {
+    const size_t page_size = get_page_size();
+    return (size + page_size - 1) / page_size * page_size;
+}
+
+size_t get_size_class(size_t size) noexcept {
+    size_t size_class = 0;
+    while ((size_t{1} << size_class) < size || (size_t{1} << size_class) < get_page_size()) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+}
+
+Stack::Stack(size_t size) {
+    const size_t page_size = get_page_size();
+    const size_t mapping_size = round_up_to_page(size) + page_size;
+
+    // nickeskov: MAP_NORESERVE, pages are committed on first touch, not on mapping
+    void *mapping = ::mmap(nullptr,
+                           mapping_size,
+                           PROT_READ | PROT_WRITE, // NOLINT this is system values, it's valid
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, // NOLINT
+                           -1,
+                           0);
+
+    if (mapping == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    // nickeskov: stack grows down, so guard page is the lowest one
+    if (::mprotect(mapping, page_size, PROT_NONE) < 0) {
+        ::munmap(mapping, mapping_size);
+        throw std::bad_alloc();
+    }
+
+    mapping_ = static_cast<uint8_t *>(mapping);
+    mapping_size_ = mapping_size;
+}
+
+Stack::Stack(Stack &&other) noexcept
+        : mapping_(std::exchange(other.mapping_, nullptr)),
+          mapping_size_(std::exchange(other.mapping_size_, 0)) {}
+
+Stack &Stack::operator=(Stack &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+    }
+    return *this;
+}
+
+void *Stack::data() const noexcept {
+    return is_valid() ? mapping_ + get_page_size() : nullptr;
+}
+
+size_t Stack::size() const noexcept {
+    return is_valid() ? mapping_size_ - get_page_size() : 0;
+}
+
+size_t Stack::mapping_size() const noexcept {
+    return mapping_size_;
+}
+
+bool Stack::is_valid() const noexcept {
+    return mapping_ != nullptr;
+}
+
+void Stack::release_pages() noexcept {
+    if (is_valid()) {
+        ::madvise(data(), size(), MADV_DONTNEED);
+    }
+}
+
+Stack::~Stack() noexcept {
+    unmap();
+}
+
+void Stack::unmap() noexcept {
+    if (is_valid()) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+}
+
+StackPool::StackPool(const StackPool::Config &cfg) : cfg_(cfg) {}
+
+Stack StackPool::acquire() {
+    return acquire(cfg_.stack_size);
+}
+
+Stack StackPool::acquire(size_t size) {
+    const size_t size_class = get_size_class(size);
+
+    if (cached_stacks_.size() <= size_class) {
+        cached_stacks_.resize(size_class + 1);
+    }
+
+    auto &class_stacks = cached_stacks_[size_class];
+
+    Stack stack;
+    if (class_stacks.empty()) {
+        stack = Stack(size_t{1} << size_class);
+        mapped_bytes_ += stack.mapping_size();
+    } else {
+        stack = std::move(class_stacks.back());
+        class_stacks.pop_back();
+        --cached_count_;
+    }
+
+    ++in_use_count_;
+    if (in_use_count_ > peak_in_use_count_) {
+        peak_in_use_count_ = in_use_count_;
+    }
+
+    return stack;
+}
+
+void StackPool::release(Stack &&stack) noexcept {
+    if (!stack.is_valid()) {
+        return;
+    }
+
+    --in_use_count_;
+
+    const size_t mapping_size = stack.mapping_size();
+
+    if (cfg_.max_cached_stacks >= 0 && cached_count_ >= static_cast<size_t>(cfg_.max_cached_stacks)) {
+        mapped_bytes_ -= mapping_size;
+        stack = Stack();
+        return;
+    }
+
+    if (cfg_.release_idle_stacks) {
+        stack.release_pages();
+    }
+
+    try {
+        cached_stacks_[get_size_class(stack.size())].emplace_back(std::move(stack));
+        ++cached_count_;
+    } catch (std::bad_alloc &) {
+        // nickeskov: stack is unmapped if it can't be cached
+        mapped_bytes_ -= mapping_size;
+        stack = Stack();
+    }
+}
+
+void StackPool::release_idle_stacks() noexcept {
+    for (auto &class_stacks : cached_stacks_) {
+        for (auto &stack : class_stacks) {
+            stack.release_pages();
+        }
+    }
+}
+
+void StackPool::set_config(const StackPool::Config &cfg) noexcept {
+    cfg_ = cfg;
+
+    if (cfg_.max_cached_stacks >= 0) {
+        trim(static_cast<size_t>(cfg_.max_cached_stacks));
+    }
+    if (cfg_.release_idle_stacks) {
+        release_idle_stacks();
+    }
+}
+
+const StackPool::Config &StackPool::get_config() const noexcept {
+    return cfg_;
+}
+
+StackPoolStats StackPool::get_stats() const noexcept {
+    StackPoolStats stats;
+    stats.stacks_in_use = in_use_count_;
+    stats.peak_stacks_in_use = peak_in_use_count_;
+    stats.cached_stacks = cached_count_;
+    stats.mapped_bytes = mapped_bytes_;
+
+    rusage usage{};
+    if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats.peak_rss = static_cast<size_t>(usage.ru_maxrss) * 1024; // nickeskov: ru_maxrss is in kilobytes
+    }
+
+    return stats;
+}
+
+void StackPool::trim(size_t max_cached_count) noexcept {
+    // nickeskov: biggest stacks are unmapped first
+    for (auto class_it = cached_stacks_.rbegin();
+         class_it != cached_stacks_.rend() && cached_count_ > max_cached_count; ++class_it) {
+        while (!class_it->empty() && cached_count_ > max_cached_count) {
+            mapped_bytes_ -= class_it->back().mapping_size();
+            class_it->pop_back();
+            --cached_count_;
+        }
+    }
+}
+
+}
@@ -266,8 +266,8 @@ class Map {
 
     template<typename RetT, typename Type, typename AllocT = allocator_type,
             std::enable_if_t<
-                    std::is_pod_v<RetT> &&
-                    std::is_pod_v<Type>, void> * = nullptr>
+                    std::is_standard_layout_v<RetT> && std::is_trivial_v<RetT> &&
+                    std::is_standard_layout_v<Type> && std::is_trivial_v<Type>, void> * = nullptr>
     RetT get_obj_copy(const Type &obj) const {
         return {obj};
     }
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <functional>
 #include <csignal>
+#include <memory>
 
 extern "C" {
 #include <sys/epoll.h>
@@ -12,6 +13,7 @@ extern "C" {
 
 #include "tcpcon/async/connection.h"
 #include "unixprimwrap/descriptor.h"
+#include "unixprimwrap/poller.h"
 
 namespace tcpcon::async::ipv4 {
 
@@ -58,6 +60,8 @@ class Server {
         sigset_t *epoll_sigmask = nullptr;
         // cppcheck-suppress unusedStructMember
         int max_accept_clients_per_loop = -1;
+        // cppcheck-suppress unusedStructMember
+        unixprimwrap::poller_backend event_backend = unixprimwrap::poller_backend::EPOLL;
     };
 
     void event_loop(const connection_handler_t &handler, const EventLoopConfig &cfg);
@@ -76,7 +80,7 @@ class Server {
 
   private:
     unixprimwrap::Descriptor server_sock_fd_;
-    unixprimwrap::Descriptor epoll_fd_;
+    std::unique_ptr<unixprimwrap::Poller> poller_;
 
     std::string src_addr_;
     uint16_t src_port_{};
@@ -1,6 +1,6 @@
 #include "tcpcon/async/epoll/server.h"
-#include "tcpcon/async/utils.h"
 #include "tcpcon/errors.h"
+#include "unixprimwrap/errors.h"
 
 #include <string>
 #include <vector>
@@ -12,29 +12,6 @@ extern "C" {
 #include <arpa/inet.h>
 }
 
-namespace {
-
-int epoll_act(int epoll_fd, int act, int fd, uint32_t events) {
-    struct epoll_event epoll_event{};
-    epoll_event.events = events;
-    epoll_event.data.fd = fd;
-    return epoll_ctl(epoll_fd, act, fd, &epoll_event);
-}
-
-int epoll_add(int epoll_fd, int fd, uint32_t events) {
-    return epoll_act(epoll_fd, EPOLL_CTL_ADD, fd, events);
-}
-
-int epoll_mod(int epoll_fd, int fd, uint32_t new_events) {
-    return epoll_act(epoll_fd, EPOLL_CTL_MOD, fd, new_events);
-}
-
-int epoll_del(int epoll_fd, int fd) {
-    return epoll_act(epoll_fd, EPOLL_CTL_DEL, fd, 0);
-}
-
-}
-
 namespace tcpcon::async::ipv4 {
 
 Server::Server(std::string_view ip, uint16_t port)
@@ -164,8 +141,7 @@ bool Server::add_to_event_loop(Connection &&connection, uint32_t events) {
         throw;
     }
 
-    if (epoll_fd_.is_valid()
-        && epoll_add(epoll_fd_.data(), conn_io_service, events) < 0) {
+    if (poller_ && poller_->add(conn_io_service, events) < 0) {
         // Fallback if epoll_ctl fails
         connection = std::move(clients_.at(conn_io_service).connection);
         clients_.erase(conn_io_service);
@@ -175,8 +151,7 @@ bool Server::add_to_event_loop(Connection &&connection, uint32_t events) {
 }
 
 bool Server::remove_from_event_loop(int connection_io_service) {
-    if (epoll_fd_.is_valid()
-        && epoll_del(epoll_fd_.data(), connection_io_service) < 0) {
+    if (poller_ && poller_->remove(connection_io_service) < 0) {
         return false;
     }
     // Not throws any exceptions, because key type == int
@@ -187,8 +162,7 @@ bool Server::remove_from_event_loop(int connection_io_service) {
 bool Server::change_event(const Connection &connection, uint32_t epoll_events) {
     int conn_io_service = connection.get_io_service().data();
 
-    if (epoll_fd_.is_valid()
-        && epoll_mod(epoll_fd_.data(), conn_io_service, epoll_events) < 0) {
+    if (poller_ && poller_->modify(conn_io_service, epoll_events) < 0) {
         return false;
     }
 
@@ -204,15 +178,14 @@ void Server::event_loop(const connection_handler_t &handler, const EventLoopConf
 
     is_stoped_ = false;
 
-    epoll_fd_ = unixprimwrap::Descriptor{epoll_create(1)};
-    if (!epoll_fd_.is_valid()) {
-        throw errors::EpollCreateError("cannot create epoll entity");
+    try {
+        poller_ = unixprimwrap::make_poller(cfg.event_backend);
+    } catch (unixprimwrap::errors::PollerError &e) {
+        throw errors::EpollCreateError(std::string("cannot create event loop: ") + e.what());
     }
 
     // add server socket to epoll
-    int srv_status = ::epoll_add(epoll_fd_.data(),
-                                 server_sock_fd_.data(),
-                                 cfg.epoll_server_flags | EPOLLIN);
+    int srv_status = poller_->add_acceptor(server_sock_fd_.data(), cfg.epoll_server_flags | EPOLLIN);
     if (srv_status < 0) {
         std::string msg = "cannot add to epoll server socket, server_sock_fd=";
         msg += std::to_string(server_sock_fd_.data());
@@ -224,7 +197,7 @@ void Server::event_loop(const connection_handler_t &handler, const EventLoopConf
 
     // add prepared connections to epoll
     for (const auto &[conn_io_service, conn_with_event] : clients_) {
-        int cli_status = epoll_add(epoll_fd_.data(), conn_io_service, conn_with_event.events);
+        int cli_status = poller_->add(conn_io_service, conn_with_event.events);
 
         if (cli_status < 0) {
             std::string msg = "cannot add to epoll connection with sock_fd=";
@@ -239,11 +212,10 @@ void Server::event_loop(const connection_handler_t &handler, const EventLoopConf
     // start event loop
     std::vector<struct epoll_event> fd_events(cfg.epoll_max_events);
     while (!is_stoped_) {
-        int loop_events_count = epoll_pwait(epoll_fd_.data(),
-                                            fd_events.data(),
-                                            cfg.epoll_max_events,
-                                            cfg.epoll_timeout,
-                                            cfg.epoll_sigmask);
+        int loop_events_count = poller_->wait(fd_events.data(),
+                                              cfg.epoll_max_events,
+                                              cfg.epoll_timeout,
+                                              cfg.epoll_sigmask);
         if (loop_events_count < 0) {
             if (errno != EINTR) {
                 throw errors::EpollWaitError(
@@ -276,7 +248,7 @@ void Server::event_loop(const connection_handler_t &handler, const EventLoopConf
         }
     }
 
-    epoll_fd_.close();
+    poller_.reset();
 }
 
 void Server::set_after_accept_handler(const connection_handler_t &handler) {
@@ -293,6 +265,9 @@ void Server::close_connection(Connection &connection, uint32_t events) {
             before_close_handler_(connection, events);
         } catch (...) {}
     }
+    if (poller_) {
+        poller_->forget(connection.get_io_service().data());
+    }
     clients_.erase(connection.get_io_service().data());
 }
 
@@ -302,8 +277,9 @@ void Server::accept_connections(uint32_t epoll_accept_flags, uint32_t accept_typ
     char buff[INET_ADDRSTRLEN];
 
     while (!is_stoped_ && max_count != 0) {
+        // nickeskov: poller accepts like accept4 with SOCK_NONBLOCK, io_uring poller may accept in advance
         unixprimwrap::Descriptor client_fd{
-                ::accept(
+                poller_->accept(
                         server_sock_fd_.data(),
                         reinterpret_cast<sockaddr *>(&client_addr),
                         &addr_size)
@@ -323,12 +299,6 @@ void Server::accept_connections(uint32_t epoll_accept_flags, uint32_t accept_typ
                 }
             }
         }
-        if (utils::set_nonblock(client_fd.data(), true) < 0) {
-            throw errors::AcceptError(
-                    "cannot cannot set nonblock for new connection, server_sock_fd="
-                    + std::to_string(server_sock_fd_.data()));
-        }
-
         inet_ntop(AF_INET, &client_addr.sin_addr, buff, INET_ADDRSTRLEN);
 
         std::string dst_addr = buff;
@@ -2,6 +2,7 @@
 #define TINYHTTP_TINYHTTP_STATIC_SERVER_H
 
 #include "tinyhttp/server.h"
+#include "tinyhttp/file_cache.h"
 
 #include <string>
 #include <string_view>
@@ -12,14 +13,37 @@ class BasicStaticServer final : public Server {
   public:
 
     BasicStaticServer(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger,
-                      std::string_view document_root);
+                      std::string_view document_root,
+                      const FileCache::Config &file_cache_cfg = FileCache::Config());
 
     HttpResponse on_request(const HttpRequest &request) override;
 
+    HttpResponse on_request_view(const HttpRequestView &request) override;
+
+    [[nodiscard]] const FileCache &get_file_cache() const noexcept;
+
     ~BasicStaticServer() override = default;
 
   private:
-    std::string document_root_;
+    // Values of request headers, which select representation and its part, empty if header not exists
+    struct FileRequestHeaders {
+        // cppcheck-suppress unusedStructMember
+        std::string_view if_none_match;
+        // cppcheck-suppress unusedStructMember
+        std::string_view if_modified_since;
+        // cppcheck-suppress unusedStructMember
+        std::string_view range;
+        // cppcheck-suppress unusedStructMember
+        std::string_view if_range;
+        // cppcheck-suppress unusedStructMember
+        std::string_view accept_encoding;
+    };
+
+    FileCache file_cache_;
+
+    HttpResponse serve_file(constants::http_method method, constants::http_version http_version,
+                            std::string_view url, const FileRequestHeaders &request_headers,
+                            std::pmr::memory_resource *resource);
 
 };
 
@@ -6,12 +6,50 @@
 #include <cinttypes>
 
 #include "unixprimwrap/descriptor.h"
+#include "unixprimwrap/poller.h"
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+#include <coroutine>
+#include <exception>
+#include <utility>
+#endif
+
+extern "C" {
+#include <sys/uio.h>
+}
 
 namespace tinyhttp {
 
 class Connection {
   public:
 
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    // Suspends awaiting task until worker gets next event of connection.
+    // Rethrows exception, which worker closes connection with (e.g. errors::TimeoutError)
+    class IoAwaiter {
+      public:
+        explicit IoAwaiter(Connection &connection) noexcept : connection_(connection) {}
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            connection_.io_waiter_ = awaiting;
+        }
+
+        void await_resume() {
+            connection_.io_waiter_ = nullptr;
+            if (connection_.io_error_) {
+                std::rethrow_exception(std::exchange(connection_.io_error_, nullptr));
+            }
+        }
+
+      private:
+        Connection &connection_;
+    };
+#endif
+
     Connection(std::string_view ip, uint16_t port, bool set_nonblock = true);
 
     Connection(const Connection &) = delete;
@@ -44,6 +82,10 @@ class Connection {
 
     ssize_t write(const void *buf, size_t len);
 
+    // Gathering write, returns -1 if socket is not ready for writing.
+    // Flags are passed to sendmsg, e.g. MSG_MORE if more data will be sent right after this call
+    ssize_t writev(const iovec *iov, size_t iovcnt, int flags = 0);
+
     ssize_t read_in_io_buff(size_t len);
 
     ssize_t write_from_io_buff(size_t len);
@@ -58,6 +100,14 @@ class Connection {
 
     [[nodiscard]] bool is_readable() const noexcept;
 
+    // If true, io must be performed until EAGAIN before waiting for the next event
+    [[nodiscard]] bool is_edge_triggered() const noexcept;
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    // Only one task may wait for connection events at a time
+    [[nodiscard]] IoAwaiter wait_io() noexcept;
+#endif
+
     void close();
 
     ~Connection() noexcept;
@@ -73,9 +123,24 @@ class Connection {
 
     bool is_readable_ = true;
 
+    bool is_edge_triggered_ = false;
+
+    // nickeskov: set by worker, poller may receive data of connection in advance, so it is read through poller
+    unixprimwrap::Poller *poller_ = nullptr;
+
     std::string io_buffer_;
 
-    std::string tmp_read_buffer_;
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    std::coroutine_handle<> io_waiter_;
+    std::exception_ptr io_error_;
+
+    [[nodiscard]] bool has_io_waiter() const noexcept;
+
+    void resume_io_waiter();
+
+    // Resumes waiting task, which gets io_error from wait_io
+    void cancel_io_waiter(const std::exception_ptr &io_error);
+#endif
 
     friend class Server;
     friend class EpollWorker;
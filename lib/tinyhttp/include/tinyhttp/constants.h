@@ -13,6 +13,7 @@ namespace strings {
 constexpr std::string_view newline = "\r\n";
 constexpr std::string_view headers_end = "\r\n\r\n";
 constexpr std::string_view colon = ":";
+constexpr std::string_view comma = ",";
 constexpr std::string_view space = " ";
 constexpr std::string_view question = "?";
 constexpr std::string_view ampersand = "&";
@@ -23,6 +24,7 @@ constexpr std::string_view slash = "/";
 constexpr std::string_view dash = "-";
 constexpr std::string_view http_upper = "HTTP";
 constexpr std::string_view http_lower = "http";
+constexpr std::string_view last_chunk = "0\r\n\r\n";
 
 }
 
@@ -33,6 +35,46 @@ constexpr std::string_view date = "Date";
 constexpr std::string_view connection = "Connection";
 constexpr std::string_view content_type = "Content-Type";
 constexpr std::string_view content_length = "Content-Length";
+constexpr std::string_view content_range = "Content-Range";
+constexpr std::string_view accept_ranges = "Accept-Ranges";
+constexpr std::string_view range = "Range";
+constexpr std::string_view if_range = "If-Range";
+constexpr std::string_view etag = "ETag";
+constexpr std::string_view last_modified = "Last-Modified";
+constexpr std::string_view if_none_match = "If-None-Match";
+constexpr std::string_view if_modified_since = "If-Modified-Since";
+constexpr std::string_view accept_encoding = "Accept-Encoding";
+constexpr std::string_view content_encoding = "Content-Encoding";
+constexpr std::string_view vary = "Vary";
+constexpr std::string_view allow = "Allow";
+constexpr std::string_view transfer_encoding = "Transfer-Encoding";
+
+}
+
+namespace content_codings {
+
+constexpr std::string_view gzip = "gzip";
+constexpr std::string_view identity = "identity";
+constexpr std::string_view any = "*";
+
+}
+
+namespace transfer_codings {
+
+constexpr std::string_view chunked = "chunked";
+
+}
+
+namespace range_units {
+
+constexpr std::string_view bytes = "bytes";
+
+}
+
+namespace connection_types {
+
+constexpr std::string_view close = "close";
+constexpr std::string_view keep_alive = "keep-alive";
 
 }
 
@@ -55,6 +97,31 @@ enum class http_method : uint8_t {
     TRACE,
 };
 
+// Headers used by server itself, parsed requests and responses keep indexed slots for them
+enum class well_known_header : uint8_t {
+    UNKNOWN_,
+    SERVER = 1,
+    DATE,
+    CONNECTION,
+    CONTENT_TYPE,
+    CONTENT_LENGTH,
+    CONTENT_RANGE,
+    ACCEPT_RANGES,
+    RANGE,
+    IF_RANGE,
+    ETAG,
+    LAST_MODIFIED,
+    IF_NONE_MATCH,
+    IF_MODIFIED_SINCE,
+    ACCEPT_ENCODING,
+    CONTENT_ENCODING,
+    VARY,
+    ALLOW,
+    TRANSFER_ENCODING,
+};
+
+constexpr size_t WELL_KNOWN_HEADERS_COUNT = static_cast<size_t>(well_known_header::TRANSFER_ENCODING) + 1;
+
 enum class http_response_status : uint16_t {
     Continue                        = 100, // RFC 7231, 6.2.1
     SwitchingProtocols              = 101, // RFC 7231, 6.2.2
@@ -135,6 +202,11 @@ std::string_view get_http_method_text(http_method method);
 
 http_method get_http_method_code(std::string_view method_text) noexcept;
 
+std::string_view get_well_known_header_text(well_known_header header) noexcept;
+
+// Case insensitive, returns UNKNOWN_ if header is not well known
+well_known_header get_well_known_header(std::string_view header_text) noexcept;
+
 }
 
 #endif //TINYHTTP_TINYHTTP_CONSTANTS_H
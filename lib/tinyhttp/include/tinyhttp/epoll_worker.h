@@ -3,12 +3,24 @@
 
 #include "tinyhttp/connection.h"
 #include "tinyhttp/server.h"
+#include "tinyhttp/http_request_parser.h"
+#include "tinyhttp/http_body_reader.h"
+#include "tinyhttp/timer_wheel.h"
+#include "tinyhttp/handler_pool.h"
+#include "tinyhttp/task.h"
+#include "coroutine/coroutine.h"
 #include "unixprimwrap/descriptor.h"
+#include "unixprimwrap/poller.h"
 #include "trivilog/base_logger.h"
 
 #include <cinttypes>
 #include <chrono>
-#include <map>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 extern "C" {
 #include <sys/epoll.h>
@@ -21,6 +33,10 @@ class EpollWorker {
 
     explicit EpollWorker(int worker_id, Server &server);
 
+    // If acceptor_service is valid, worker accepts connections only on it (SO_REUSEPORT mode),
+    // otherwise server acceptor service is shared between all workers
+    EpollWorker(int worker_id, Server &server, unixprimwrap::Descriptor &&acceptor_service);
+
     EpollWorker(const EpollWorker &) = delete;
 
     EpollWorker &operator=(const EpollWorker &) = delete;
@@ -38,33 +54,162 @@ class EpollWorker {
   private:
 
     using basic_io_service_t = int;
+    using clock_t = TimerWheel::clock_t;
+
+    // nickeskov: every phase has its own timeout, only one timer per client is active
+    enum class client_phase : uint8_t {
+        IDLE, // keep-alive connection waits for next request
+        HEADERS, // absolute deadline from first byte (or accept) to end of headers
+        BODY, // deadline is moved on every event
+        WRITE, // deadline is moved on every event
+    };
 
     struct Client {
+        Client(Connection &&conn, uint32_t events, size_t arena_size, AllocationCounter &counter)
+                : connection(std::move(conn)), current_events(events), arena(arena_size, &counter) {}
+
         Connection connection;
         // cppcheck-suppress unusedStructMember
         uint32_t current_events;
-        //std::chrono::high_resolution_clock::time_point timeout;
+        // cppcheck-suppress unusedStructMember
+        size_t requests_count = 0;
+        // nickeskov: bytes of pipelined requests, saved while io buffer is used for response sending
+        std::string pipelined_input;
+        // cppcheck-suppress unusedStructMember
+        client_phase phase = client_phase::HEADERS;
+        RequestArena arena; // nickeskov: is reset at the beginning of every request
+        // cppcheck-suppress unusedStructMember
+        bool is_offloaded = false; // nickeskov: handler runs in pool, only its completion resumes client
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+        Task<> task; // nickeskov: frame of client task is the only per-connection state besides Client
+        // cppcheck-suppress unusedStructMember
+        bool is_task_started = false;
+#endif
+    };
+
+    // nickeskov: lives in client routine (or task frame) until handler completion is received
+    struct OffloadedRequest {
+        const HttpRequestView &request;
+        std::optional<HttpResponse> response;
+        std::exception_ptr error;
+    };
+
+    // nickeskov: lives in client routine (or task frame) while streamed request is handled
+    class BodyReader final : public HttpBodyReader {
+      public:
+        BodyReader(EpollWorker &worker, Client &client, HttpRequestParser &parser) noexcept;
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+        Task<std::string_view> read_async() override;
+#else
+        std::string_view read() override;
+#endif
+
+        [[nodiscard]] bool is_finished() const noexcept override;
+
+      private:
+        EpollWorker &worker_;
+        Client &client_;
+        HttpRequestParser &parser_;
+        bool is_part_returned_ = false; // nickeskov: body parsed with headers isn't returned yet
     };
 
     const int worker_id_;
     Server &server_;
     trivilog::BaseLogger &logger_;
-    unixprimwrap::Descriptor epoll_fd_;
-    std::map<basic_io_service_t, Client> clients_;
+    std::unique_ptr<unixprimwrap::Poller> poller_; // nickeskov: created in event_loop with configured backend
+    unixprimwrap::Descriptor own_acceptor_service_;
+    const basic_io_service_t basic_acceptor_service_;
+    // nickeskov: indexed by fd, fds are small dense integers, unique_ptr keeps client address stable
+    std::vector<std::unique_ptr<Client>> clients_;
+    Server::EventLoopConfig cfg_;
+    uint32_t client_events_flags_ = 0;
+    TimerWheel timers_;
+    std::vector<basic_io_service_t> expired_clients_;
+    CompletionQueue completions_;
+    std::vector<basic_io_service_t> completed_clients_;
+    size_t offloaded_count_ = 0;
 
     bool add_to_event_loop(Connection &&connection, uint32_t events);
 
+    Client &get_client(basic_io_service_t basic_io_service);
+
 //    bool remove_from_event_loop(Connection &connection);
 
     bool change_event(Client &client, uint32_t epoll_events);
 
     void close_connection(basic_io_service_t basic_io_service);
 
-    void accept_connections(size_t max_count);
+    // killer exception must be derived from errors::RuntimeError
+    void kill_client(basic_io_service_t basic_io_service, const std::exception_ptr &killer_exception);
+
+    void set_phase(Client &client, client_phase phase, clock_t::time_point now);
+
+    [[nodiscard]] int get_phase_timeout(client_phase phase) const noexcept;
+
+    void close_expired_connections(clock_t::time_point now);
+
+    void accept_connections(int max_count);
 
     void handle_client(epoll_event fd_event);
 
+    // Resumes client and closes connection if client is finished
+    void run_client(basic_io_service_t basic_io_service);
+
+    // Submits handler of request to handler pool, returns false if pool is disabled or full
+    bool offload_request(Client &client, OffloadedRequest &offloaded);
+
+    void complete_offloaded_requests();
+
+    void wait_offloaded_requests();
+
+    // Resumes client routine or task, returns AGAIN if it waits for the next event
+    coroutine::coroutine_status resume_client(Client &client);
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    Task<> client_task(Client &client);
+
+    Task<> serve_client_async(Client &client);
+
+    Task<> read_http_request_async(Client &client, HttpRequestParser &parser);
+
+    Task<HttpResponse> call_handler_async(Client &client, const HttpRequestView &request);
+
+    Task<HttpResponse> call_stream_handler_async(Client &client, HttpRequestParser &parser);
+
+    Task<> send_error_response_async(Client &client, constants::http_response_status status);
+#else
     void client_routine(); // coroutine function
+
+    void serve_client(Client &client);
+
+    const HttpRequestView &read_http_request(Client &client, HttpRequestParser &parser);
+
+    HttpResponse call_handler(Client &client, const HttpRequestView &request);
+
+    HttpResponse call_stream_handler(Client &client, HttpRequestParser &parser);
+
+    // Sends response without body, connection must be closed after it
+    void send_error_response(Client &client, constants::http_response_status status);
+#endif
+
+    // Reads next part of request, returns false if socket is not ready
+    bool read_http_request_part(Client &client, const HttpRequestParser &parser);
+
+    // Asks server once headers are parsed, returns true if body isn't buffered anymore
+    bool try_stream_body(Client &client, HttpRequestParser &parser);
+
+    // Drops input and prepares connection for sending of error response
+    void begin_error_response(Client &client, HttpResponse &response);
+
+    // Returns true if connection must be kept alive after response
+    bool begin_request(Client &client, const HttpRequestView &request);
+
+    // Prepares connection and response for sending, request must be handled already.
+    // Returns false if connection must be closed after response, even if keep alive was requested
+    bool begin_response(Client &client, const HttpRequestView &request, HttpResponse &response, bool keep_alive);
+
+    void end_response(Client &client, bool keep_alive);
 };
 
 }
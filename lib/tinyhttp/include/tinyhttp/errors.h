@@ -43,6 +43,9 @@ class HttpVersionInvalid : public HttpSyntaxError {
 class HttpMethodInvalid : public HttpSyntaxError {
 };
 
+class HttpInvalidChunkedBody : public HttpSyntaxError {
+};
+
 class HttpStandardError : public HttpBaseError {
   public:
     explicit HttpStandardError(constants::http_response_status status_code);
@@ -87,6 +90,11 @@ class EofError : public ReadError {
     explicit EofError(std::string_view what_arg);
 };
 
+class TimeoutError : public IoError {
+  public:
+    explicit TimeoutError(std::string_view what_arg);
+};
+
 class TcpError : public IoError {
   public:
     explicit TcpError(std::string_view what_arg);
@@ -122,6 +130,11 @@ class InvalidAddressError : public ConnOpenError {
     explicit InvalidAddressError(std::string_view what_arg);
 };
 
+class RouterError : public RuntimeError {
+  public:
+    explicit RouterError(std::string_view what_arg);
+};
+
 class ServerError : public RuntimeError {
   public:
     explicit ServerError(std::string_view what_arg);
@@ -147,6 +160,11 @@ class ServerCloseError : public ServerError {
     explicit ServerCloseError(std::string_view what_arg);
 };
 
+class HandlerPoolError : public ServerError {
+  public:
+    explicit HandlerPoolError(std::string_view what_arg);
+};
+
 class EpollError : public ServerError {
   public:
     explicit EpollError(std::string_view what_arg);
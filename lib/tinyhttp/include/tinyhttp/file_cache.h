@@ -0,0 +1,159 @@
+#ifndef TINYHTTP_TINYHTTP_FILE_CACHE_H
+#define TINYHTTP_TINYHTTP_FILE_CACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cinttypes>
+
+#include "tinyhttp/constants.h"
+#include "unixprimwrap/descriptor.h"
+
+extern "C" {
+#include <sys/stat.h>
+}
+
+namespace tinyhttp {
+
+// Thread safe LRU cache of opened files and their metadata, keyed by decoded url path.
+// Entry is revalidated by stat() after ttl expiration and reloaded if file was changed.
+// Small files are kept in memory entirely, total size of their content is limited.
+// Entry may have gzip variant, which is precompressed "file.gz" sibling or compressed once text file.
+class FileCache {
+  public:
+
+    struct Config {
+        // cppcheck-suppress unusedStructMember
+        size_t max_entries = 1024;
+        // cppcheck-suppress unusedStructMember
+        int ttl = 1000; // milliseconds, 0 means revalidate on every lookup, negative value means never
+        // cppcheck-suppress unusedStructMember
+        size_t max_in_memory_file_size = 65536; // bytes, 0 disables in-memory content
+        // cppcheck-suppress unusedStructMember
+        size_t max_memory_usage = 64 * 1024 * 1024; // bytes of in-memory content for all entries
+        // cppcheck-suppress unusedStructMember
+        bool gzip_static = true; // serve precompressed "file.gz" sibling if it exists
+        // cppcheck-suppress unusedStructMember
+        bool gzip_compress = false; // compress text files once and keep result in memory, needs zlib
+        // cppcheck-suppress unusedStructMember
+        size_t max_gzip_compress_file_size = 1024 * 1024; // bytes
+    };
+
+    struct Entry {
+        // cppcheck-suppress unusedStructMember
+        std::string path; // canonical
+        // cppcheck-suppress unusedStructMember
+        unixprimwrap::Descriptor fd; // not valid if file is in memory
+        // cppcheck-suppress unusedStructMember
+        size_t size = 0;
+        // cppcheck-suppress unusedStructMember
+        timespec mtime{};
+        // cppcheck-suppress unusedStructMember
+        ino_t inode = 0;
+        // cppcheck-suppress unusedStructMember
+        std::string_view mime_type;
+        // cppcheck-suppress unusedStructMember
+        bool is_in_memory = false;
+        // cppcheck-suppress unusedStructMember
+        std::string content; // whole file if is_in_memory
+        // cppcheck-suppress unusedStructMember
+        std::string etag; // strong entity tag with quotes
+        // cppcheck-suppress unusedStructMember
+        std::string last_modified; // IMF-fixdate
+        // cppcheck-suppress unusedStructMember
+        std::string validator_headers; // preformatted ETag and Last-Modified lines, each ends with CRLF
+        // cppcheck-suppress unusedStructMember
+        std::string headers; // preformatted entity headers of full (200) response, including validators
+        // cppcheck-suppress unusedStructMember
+        std::string_view content_encoding; // empty for identity
+        // cppcheck-suppress unusedStructMember
+        std::shared_ptr<const Entry> gzip_variant; // precompressed sibling or compressed content, may be nullptr
+    };
+
+    // nickeskov: entry is shared, so evicted file stays opened until all senders finish
+    using entry_ptr_t = std::shared_ptr<const Entry>;
+
+    struct LookupResult {
+        // cppcheck-suppress unusedStructMember
+        constants::http_response_status status = constants::http_response_status::OK;
+        // cppcheck-suppress unusedStructMember
+        entry_ptr_t entry; // nullptr if status is not OK
+    };
+
+    FileCache(std::string_view document_root, const Config &cfg);
+
+    FileCache(const FileCache &) = delete;
+
+    FileCache &operator=(const FileCache &) = delete;
+
+    [[nodiscard]] LookupResult lookup(std::string_view url);
+
+    [[nodiscard]] const std::string &get_document_root() const noexcept;
+
+    [[nodiscard]] uint64_t get_hits_count() const noexcept;
+
+    [[nodiscard]] uint64_t get_misses_count() const noexcept;
+
+    // Hits to all lookups ratio, 0 if there were no lookups
+    [[nodiscard]] double get_hit_rate() const noexcept;
+
+    // Bytes of in-memory content held by cache
+    [[nodiscard]] size_t get_memory_usage() const noexcept;
+
+    [[nodiscard]] size_t size() const;
+
+    // Removes entry, which has this entry or its gzip variant, so the next lookup reloads file
+    void invalidate(const Entry &entry);
+
+    void clear();
+
+  private:
+    using clock_t = std::chrono::steady_clock;
+
+    struct Node {
+        entry_ptr_t entry;
+        clock_t::time_point revalidate_at;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    // nickeskov: key points into url owned by lru list node, so lookup by string_view doesn't allocate
+    using entries_map_t = std::unordered_map<std::string_view, Node>;
+
+    std::string document_root_;
+    Config cfg_;
+
+    mutable std::mutex mutex_;
+    entries_map_t entries_;
+    std::list<std::string> lru_; // nickeskov: most recently used url at front
+
+    std::atomic<uint64_t> hits_count_ = 0;
+    std::atomic<uint64_t> misses_count_ = 0;
+    std::atomic<size_t> memory_usage_ = 0; // nickeskov: changed only under lock, atomic for lock-free reading
+
+    [[nodiscard]] LookupResult load(std::string_view url) const;
+
+    [[nodiscard]] std::shared_ptr<Entry> make_entry(std::string &&path, unixprimwrap::Descriptor &&fd,
+                                                    const struct stat &file_stat,
+                                                    std::string_view mime_type) const;
+
+    [[nodiscard]] entry_ptr_t load_precompressed_variant(const Entry &entry) const;
+
+    [[nodiscard]] entry_ptr_t compress_variant(const Entry &entry) const;
+
+    [[nodiscard]] clock_t::time_point next_revalidation(clock_t::time_point now) const noexcept;
+
+    void insert(std::string_view url, const entry_ptr_t &entry, clock_t::time_point now);
+
+    void erase(entries_map_t::iterator node_it);
+};
+
+std::string_view get_mime_type(std::string_view extension);
+
+}
+
+#endif //TINYHTTP_TINYHTTP_FILE_CACHE_H
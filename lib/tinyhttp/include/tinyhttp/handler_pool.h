@@ -0,0 +1,70 @@
+#ifndef TINYHTTP_TINYHTTP_HANDLER_POOL_H
+#define TINYHTTP_TINYHTTP_HANDLER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "unixprimwrap/descriptor.h"
+
+namespace tinyhttp {
+
+// Bounded pool of threads for blocking or CPU heavy request handlers.
+// Destructor waits for queued jobs and joins threads.
+class HandlerPool {
+  public:
+    using job_t = std::function<void()>;
+
+    HandlerPool(size_t threads_count, size_t max_queued_jobs);
+
+    HandlerPool(const HandlerPool &) = delete;
+
+    HandlerPool &operator=(const HandlerPool &) = delete;
+
+    // Returns false and leaves job untouched if queue is full
+    bool try_submit(job_t &&job);
+
+    ~HandlerPool() noexcept;
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable has_jobs_;
+    std::deque<job_t> jobs_;
+    const size_t max_queued_jobs_;
+    bool is_stopped_ = false;
+    std::vector<std::thread> threads_;
+
+    void thread_routine();
+};
+
+// Ids of finished jobs for one event loop. Pool threads push ids, event loop is woken up
+// by eventfd, which is signalled only when queue becomes non-empty.
+class CompletionQueue {
+  public:
+    // throws errors::HandlerPoolError if eventfd can't be created
+    CompletionQueue();
+
+    CompletionQueue(const CompletionQueue &) = delete;
+
+    CompletionQueue &operator=(const CompletionQueue &) = delete;
+
+    void push(int id);
+
+    // Replaces content of ids with finished ids, blocks until any id is pushed if wait is true
+    void pop_all(std::vector<int> &ids, bool wait);
+
+    [[nodiscard]] const unixprimwrap::Descriptor &get_event_service() const noexcept;
+
+  private:
+    unixprimwrap::Descriptor event_fd_;
+    std::mutex mutex_;
+    std::condition_variable has_ids_;
+    std::vector<int> ids_;
+};
+
+}
+
+#endif //TINYHTTP_TINYHTTP_HANDLER_POOL_H
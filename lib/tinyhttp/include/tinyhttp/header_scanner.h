@@ -0,0 +1,50 @@
+#ifndef TINYHTTP_TINYHTTP_HEADER_SCANNER_H
+#define TINYHTTP_TINYHTTP_HEADER_SCANNER_H
+
+#include <string_view>
+#include <cinttypes>
+
+namespace tinyhttp::scanner {
+
+// nickeskov: kernels are chosen at compile time, Release build uses -march=native
+enum class scanner_kernel : uint8_t {
+    SCALAR,
+    SSE2,
+    AVX2,
+};
+
+// Line of headers block, positions are relative to the scanned block
+struct HeaderLine {
+    // cppcheck-suppress unusedStructMember
+    uint32_t start;
+    // cppcheck-suppress unusedStructMember
+    uint32_t colon; // first colon of line, equal to end if line has no colon
+    // cppcheck-suppress unusedStructMember
+    uint32_t end; // position of CR
+};
+
+struct ScanResult {
+    // cppcheck-suppress unusedStructMember
+    size_t lines_count;
+    // cppcheck-suppress unusedStructMember
+    size_t scanned_size; // size of indexed lines (and empty line), next scan can start from here
+    // cppcheck-suppress unusedStructMember
+    bool is_valid;
+};
+
+[[nodiscard]] scanner_kernel get_kernel() noexcept;
+
+const char *to_string(scanner_kernel kernel) noexcept;
+
+// Position of first "\r\n\r\n" at or after from, npos if there is no one
+[[nodiscard]] size_t find_headers_end(std::string_view buffer, size_t from) noexcept;
+
+// Indexes CRLF terminated lines in one pass: line ends, first colons and invalid characters
+// (control characters except HTAB, bare CR or LF) are located by the same vector comparisons.
+// Scanning stops after empty line, when lines are full, on invalid character or incomplete last line.
+// Block size must be less than 4 GiB
+ScanResult index_header_lines(std::string_view block, HeaderLine *lines, size_t max_lines) noexcept;
+
+}
+
+#endif //TINYHTTP_TINYHTTP_HEADER_SCANNER_H
@@ -0,0 +1,39 @@
+#ifndef TINYHTTP_TINYHTTP_HTTP_BODY_READER_H
+#define TINYHTTP_TINYHTTP_HTTP_BODY_READER_H
+
+#include <string_view>
+
+#include "tinyhttp/task.h"
+
+namespace tinyhttp {
+
+// Body of streamed request. Parts are read from connection only when handler asks for them,
+// so slow handler stops reading and socket buffers apply backpressure to client.
+// Io buffer may be reallocated by reading, views of request (headers, path) taken before read
+// must not be used after it.
+class HttpBodyReader {
+  public:
+    HttpBodyReader() = default;
+
+    HttpBodyReader(const HttpBodyReader &) = delete;
+
+    HttpBodyReader &operator=(const HttpBodyReader &) = delete;
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    // Same as read in stackful build, but awaits connection events instead of yielding
+    virtual Task<std::string_view> read_async() = 0;
+#else
+    // Returns next decoded part of body, empty view after body end. Part is valid until next read.
+    // Yields current coroutine while socket is not ready, throws errors::EofError if connection
+    // is closed and errors::HttpStandardError (RequestEntityTooLarge) if body is larger than limit
+    virtual std::string_view read() = 0;
+#endif
+
+    [[nodiscard]] virtual bool is_finished() const noexcept = 0;
+
+    virtual ~HttpBodyReader() noexcept = default;
+};
+
+}
+
+#endif //TINYHTTP_TINYHTTP_HTTP_BODY_READER_H
@@ -1,6 +1,8 @@
 #ifndef TINYHTTP_TINYHTTP_HTTP_HEADERS_H
 #define TINYHTTP_TINYHTTP_HTTP_HEADERS_H
 
+#include <bitset>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -12,13 +14,14 @@ namespace tinyhttp {
 class HttpHeaders {
   public:
 
-    using headers_storage_t = std::unordered_map<std::string, std::string>;
+    using headers_storage_t = std::pmr::unordered_map<std::pmr::string, std::pmr::string>;
 
-    HttpHeaders() = default;
+    explicit HttpHeaders(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
-    explicit HttpHeaders(std::string_view headers_values_view);
+    explicit HttpHeaders(std::string_view headers_values_view,
+                         std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
-    const std::string &at(std::string_view header) const;
+    const std::pmr::string &at(std::string_view header) const;
 
     void insert_or_assign(std::string_view header, std::string_view value);
 
@@ -28,6 +31,12 @@ class HttpHeaders {
 
     bool contains(std::string_view header) const;
 
+    // Throws std::out_of_range if header not exists
+    const std::pmr::string &at(constants::well_known_header header) const;
+
+    // Presence bit check, without key allocation and hashing
+    [[nodiscard]] bool contains(constants::well_known_header header) const noexcept;
+
     void clear() noexcept;
 
     size_t size() const noexcept;
@@ -48,10 +57,23 @@ class HttpHeaders {
 
     headers_storage_t::const_iterator cend() const noexcept;
 
+    [[nodiscard]] std::pmr::memory_resource *get_memory_resource() const noexcept;
+
     std::string to_string() const;
 
+    // Appends headers, unlike to_string every header line ends with CRLF
+    void append_to(std::string &buf) const;
+
   private:
     headers_storage_t headers_;
+
+    // nickeskov: values are stored in map anyway, bits only answer if well known header is present
+    std::bitset<constants::WELL_KNOWN_HEADERS_COUNT> well_known_headers_;
+
+    void set_well_known(std::string_view header, bool is_present) noexcept;
+
+    // nickeskov: key is allocated from storage memory resource
+    [[nodiscard]] std::pmr::string make_key(std::string_view header) const;
 };
 
 }
@@ -1,6 +1,7 @@
 #ifndef TINYHTTP_TINYHTTP_HTTP_QUERY_PARAMETERS_H
 #define TINYHTTP_TINYHTTP_HTTP_QUERY_PARAMETERS_H
 
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -10,13 +11,14 @@ namespace tinyhttp {
 class HttpQueryParameters {
   public:
 
-    using param_storage_t = std::unordered_map<std::string, std::string>;
+    using param_storage_t = std::pmr::unordered_map<std::pmr::string, std::pmr::string>;
 
-    HttpQueryParameters() = default;
+    explicit HttpQueryParameters(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
-    explicit HttpQueryParameters(std::string_view query_string);
+    explicit HttpQueryParameters(std::string_view query_string,
+                                 std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
-    const std::string &at(std::string_view key) const;
+    const std::pmr::string &at(std::string_view key) const;
 
     void insert_or_assign(std::string_view key, std::string_view value);
 
@@ -46,10 +48,14 @@ class HttpQueryParameters {
 
     param_storage_t::const_iterator cend() const noexcept;
 
+    [[nodiscard]] std::pmr::memory_resource *get_memory_resource() const noexcept;
+
     std::string to_string() const;
 
   private:
     param_storage_t parameters_;
+
+    [[nodiscard]] std::pmr::string make_key(std::string_view key) const;
 };
 
 }
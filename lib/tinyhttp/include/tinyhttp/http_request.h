@@ -3,7 +3,9 @@
 
 #include "tinyhttp/http_headers.h"
 #include "tinyhttp/http_request_line.h"
+#include "tinyhttp/http_request_view.h"
 
+#include <memory_resource>
 #include <string>
 #include <string_view>
 
@@ -13,10 +15,14 @@ namespace tinyhttp {
 class HttpRequest {
   public:
 
+    // nickeskov: body is allocated from memory resource of headers
     HttpRequest(HttpRequestLine request_line, HttpHeaders headers);
 
     HttpRequest(HttpRequestLine request_line, HttpHeaders headers, std::string_view body);
 
+    // Creates owning copy of request view, which is allocated from memory resource of request view
+    explicit HttpRequest(const HttpRequestView &request_view);
+
     HttpRequestLine &get_request_line() noexcept;
 
     const HttpRequestLine &get_request_line() const noexcept;
@@ -25,22 +31,24 @@ class HttpRequest {
 
     const HttpHeaders &get_headers() const noexcept;
 
-    std::string &get_body() noexcept;
+    std::pmr::string &get_body() noexcept;
 
     void set_body(std::string_view body);
 
-    void set_body(std::string &&body) noexcept;
+    void set_body(std::pmr::string &&body);
 
-    const std::string &get_body() const noexcept;
+    const std::pmr::string &get_body() const noexcept;
 
     size_t get_content_length() const noexcept;
 
+    [[nodiscard]] std::pmr::memory_resource *get_memory_resource() const noexcept;
+
     std::string to_string() const;
 
   private:
     HttpRequestLine request_line_;
     HttpHeaders headers_;
-    std::string body_;
+    std::pmr::string body_;
 };
 
 }
@@ -1,6 +1,7 @@
 #ifndef TINYHTTP_TINYHTTP_HTTP_REQUEST_LINE_H
 #define TINYHTTP_TINYHTTP_HTTP_REQUEST_LINE_H
 
+#include <memory_resource>
 #include <string>
 #include <string_view>
 
@@ -11,13 +12,14 @@ namespace tinyhttp {
 
 class HttpRequestLine {
   public:
-    explicit HttpRequestLine(std::string_view request_line);
+    explicit HttpRequestLine(std::string_view request_line,
+                             std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     constants::http_version get_version() const;
 
     constants::http_method get_method() const;
 
-    const std::string &get_url() const;
+    const std::pmr::string &get_url() const;
 
     const HttpQueryParameters &get_query_string() const;
 
@@ -26,7 +28,7 @@ class HttpRequestLine {
   private:
     constants::http_version version_;
     constants::http_method method_;
-    std::string url_;
+    std::pmr::string url_;
 
     HttpQueryParameters query_params_;
 };
@@ -0,0 +1,103 @@
+#ifndef TINYHTTP_TINYHTTP_HTTP_REQUEST_PARSER_H
+#define TINYHTTP_TINYHTTP_HTTP_REQUEST_PARSER_H
+
+#include <string>
+#include <string_view>
+#include <cinttypes>
+
+#include "tinyhttp/http_request_view.h"
+
+namespace tinyhttp {
+
+// Incremental zero-copy request parser. Parsing can be resumed after every read,
+// already scanned bytes are not scanned again. Parser not allocates memory.
+// Chunked body is decoded in place: chunk data is moved to the end of previous chunk data,
+// so body is contiguous in buffer and buffer bytes after it (up to the request end) are garbage.
+class HttpRequestParser {
+  public:
+    static constexpr size_t DEFAULT_MAX_HEADERS_SIZE = 64 * 1024;
+
+    enum class parse_status : uint8_t {
+        INCOMPLETE,
+        COMPLETE,
+    };
+
+    // Buffer must start at the request beginning and contain all previously passed bytes
+    // (as they were left by parser), throws errors::HttpSyntaxError or errors::HttpStandardError
+    // on invalid request, errors::HttpNotImplemented on unsupported transfer coding
+    parse_status parse(std::string &buffer);
+
+    [[nodiscard]] const HttpRequestView &get_request() const noexcept;
+
+    [[nodiscard]] bool is_headers_parsed() const noexcept;
+
+    // Count of bytes, which are needed to complete request (or current chunk), 0 if unknown
+    [[nodiscard]] size_t get_missing_size() const noexcept;
+
+    void reset() noexcept;
+
+    // Memory resource of parsed requests, it isn't changed by reset
+    void set_memory_resource(std::pmr::memory_resource *resource) noexcept;
+
+    // Decoded body size limit, 0 means no limit, it isn't changed by reset.
+    // Larger body throws errors::HttpStandardError (RequestEntityTooLarge)
+    void set_max_body_size(size_t max_body_size) noexcept;
+
+    // Size limit of request line with headers, 0 means no limit, it isn't changed by reset.
+    // Larger headers (or incomplete headers, which already exceed it) throw
+    // errors::HttpStandardError (RequestHeaderFieldsTooLarge)
+    void set_max_headers_size(size_t max_headers_size) noexcept;
+
+    // Switches request to body streaming, headers must be parsed. In this mode body isn't accumulated:
+    // parse decodes available bytes into body view and completes only after body end,
+    // consume_body drops decoded part from buffer, so next parse decodes following bytes into its place
+    void stream_body() noexcept;
+
+    void consume_body(std::string &buffer);
+
+    [[nodiscard]] bool is_body_streamed() const noexcept;
+
+    [[nodiscard]] bool is_body_finished() const noexcept;
+
+  private:
+    enum class chunk_state : uint8_t {
+        SIZE,
+        DATA,
+        DATA_END,
+        TRAILERS,
+        DONE,
+    };
+
+    HttpRequestView request_;
+
+    size_t request_start_ = 0;
+    size_t scanned_size_ = 0;
+    size_t buffer_size_ = 0;
+    bool is_headers_parsed_ = false;
+
+    size_t max_headers_size_ = DEFAULT_MAX_HEADERS_SIZE;
+    size_t max_body_size_ = 0;
+    size_t body_size_ = 0; // nickeskov: size of all decoded and announced chunks, including consumed
+
+    bool is_chunked_ = false;
+    bool is_body_streamed_ = false;
+    chunk_state chunk_state_ = chunk_state::SIZE;
+    size_t chunk_pos_ = 0; // nickeskov: position of first not decoded byte
+    size_t chunk_remaining_ = 0;
+
+    void parse_request_line(size_t line_end);
+
+    void parse_headers(size_t headers_start, size_t headers_end);
+
+    void parse_body_length(size_t body_start);
+
+    // Decodes chunked or streamed body, returns true if whole body (with trailers) is received
+    bool decode_body(std::string &buffer);
+
+    // Returns position of chunk size or trailer line end, npos if line is incomplete
+    size_t find_chunk_line_end(std::string_view buffer) const;
+};
+
+}
+
+#endif //TINYHTTP_TINYHTTP_HTTP_REQUEST_PARSER_H
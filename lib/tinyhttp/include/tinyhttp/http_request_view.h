@@ -0,0 +1,116 @@
+#ifndef TINYHTTP_TINYHTTP_HTTP_REQUEST_VIEW_H
+#define TINYHTTP_TINYHTTP_HTTP_REQUEST_VIEW_H
+
+#include <array>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <cinttypes>
+
+#include "tinyhttp/constants.h"
+
+namespace tinyhttp {
+
+// Non-owning request representation, all parts are views into connection io buffer.
+// View is valid until io buffer is modified or next request is parsed.
+class HttpRequestView {
+  public:
+
+    static constexpr size_t MAX_HEADERS_COUNT = 64;
+
+    struct Header {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    [[nodiscard]] constants::http_method get_method() const noexcept;
+
+    [[nodiscard]] constants::http_version get_version() const noexcept;
+
+    // Request line without trailing CRLF
+    [[nodiscard]] std::string_view get_request_line() const noexcept;
+
+    // Raw (not decoded) url path without query string
+    [[nodiscard]] std::string_view get_path() const noexcept;
+
+    // Raw query string without '?'
+    [[nodiscard]] std::string_view get_query_string() const noexcept;
+
+    // Decodes url path, allocates memory only if path contains encoded symbols
+    [[nodiscard]] std::string decode_path() const;
+
+    [[nodiscard]] bool is_path_encoded() const noexcept;
+
+    [[nodiscard]] size_t headers_count() const noexcept;
+
+    [[nodiscard]] Header get_header(size_t index) const noexcept;
+
+    // Case insensitive lookup, returns empty view if header not exists
+    [[nodiscard]] std::string_view get_header(std::string_view name) const noexcept;
+
+    [[nodiscard]] bool contains(std::string_view name) const noexcept;
+
+    // Indexed slot lookup, without comparison of names
+    [[nodiscard]] std::string_view get_header(constants::well_known_header header) const noexcept;
+
+    [[nodiscard]] bool contains(constants::well_known_header header) const noexcept;
+
+    // Headers block, every header line ends with CRLF
+    [[nodiscard]] std::string_view get_raw_headers() const noexcept;
+
+    // Chunked body is already decoded by parser
+    [[nodiscard]] std::string_view get_body() const noexcept;
+
+    [[nodiscard]] size_t get_content_length() const noexcept;
+
+    // Size of whole request in buffer, including body (with chunked framing and trailers)
+    [[nodiscard]] size_t size() const noexcept;
+
+    // Memory resource for objects of this request (owning request copy, response), worker sets it
+    // to arena of connection, so these objects must not outlive request handling
+    [[nodiscard]] std::pmr::memory_resource *get_memory_resource() const noexcept;
+
+  private:
+    // nickeskov: offsets are used instead of pointers, because io buffer may be reallocated while reading
+    struct Span {
+        // cppcheck-suppress unusedStructMember
+        uint32_t pos = 0;
+        // cppcheck-suppress unusedStructMember
+        uint32_t len = 0;
+    };
+
+    struct HeaderSpan {
+        // cppcheck-suppress unusedStructMember
+        Span name;
+        // cppcheck-suppress unusedStructMember
+        Span value;
+    };
+
+    std::string_view buffer_;
+
+    constants::http_method method_ = constants::http_method::UNSUPPORTED_;
+    constants::http_version version_ = constants::http_version::UNSUPPORTED_;
+
+    Span request_line_;
+    Span path_;
+    Span query_string_;
+    Span raw_headers_;
+    Span body_;
+    uint32_t size_ = 0;
+
+    size_t headers_count_ = 0;
+    std::array<HeaderSpan, MAX_HEADERS_COUNT> headers_{};
+
+    // nickeskov: index + 1 of the first header with this name, 0 if there is no one. Parser fills it
+    std::array<uint8_t, constants::WELL_KNOWN_HEADERS_COUNT> well_known_headers_{};
+
+    std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();
+
+    [[nodiscard]] std::string_view view(Span span) const noexcept;
+
+    friend class HttpRequestParser;
+};
+
+}
+
+#endif //TINYHTTP_TINYHTTP_HTTP_REQUEST_VIEW_H
@@ -2,11 +2,14 @@
 #define TINYHTTP_TINYHTTP_HTTP_RESPONSE_H
 
 #include <functional>
+#include <memory_resource>
+#include <string>
 
 #include "tinyhttp/constants.h"
 #include "tinyhttp/connection.h"
 #include "tinyhttp/http_response_line.h"
 #include "tinyhttp/http_headers.h"
+#include "tinyhttp/task.h"
 
 namespace tinyhttp {
 
@@ -14,10 +17,21 @@ class HttpResponse {
   public:
     using response_sender_t = typename std::function<void(Connection &, HttpResponse &)>;
 
-    HttpResponse();
+    // Appends next part of body to cleared part buffer, returns false after last part.
+    // Parts are sent as they are produced, with chunked encoding if Content-Length isn't set
+    using body_producer_t = typename std::function<bool(std::pmr::string &part)>;
 
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    // nickeskov: stackless build can't yield from synchronous sender, so senders must be async
+    using async_response_sender_t = typename std::function<Task<>(Connection &, HttpResponse &)>;
+#endif
+
+    explicit HttpResponse(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    // nickeskov: handlers should pass request memory resource (HttpRequestView::get_memory_resource)
     explicit HttpResponse(constants::http_response_status response_status,
-                          constants::http_version http_version = constants::http_version::V1_1);
+                          constants::http_version http_version = constants::http_version::V1_1,
+                          std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     HttpResponseLine &get_response_line() noexcept;
 
@@ -33,27 +47,52 @@ class HttpResponse {
 
     void set_headers(const HttpHeaders &headers);
 
-    const std::string &get_body() const noexcept;
+    const std::pmr::string &get_body() const noexcept;
 
     void set_body(std::string_view body);
 
     void append_to_body(std::string_view part);
 
+    const body_producer_t &get_body_producer() const noexcept;
+
+    // Clears body and its Content-Length, producer is called by worker after head is serialized
+    void set_body_producer(body_producer_t &&producer);
+
     const response_sender_t &get_sender() const noexcept;
 
     void set_sender(const response_sender_t &sender);
 
     void set_sender(response_sender_t &&sender);
 
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    const async_response_sender_t &get_async_sender() const noexcept;
+
+    void set_async_sender(async_response_sender_t &&sender);
+#endif
+
+    [[nodiscard]] std::pmr::memory_resource *get_memory_resource() const noexcept;
+
     std::string to_string() const;
 
+    // Appends response line and headers, terminated by empty line, body is not serialized
+    void serialize_head(std::string &buf) const;
+
+    // Same as above, raw_headers are preformatted header lines (each ends with CRLF) appended after headers
+    void serialize_head(std::string &buf, std::string_view raw_headers) const;
+
   private:
     HttpResponseLine response_line_;
     HttpHeaders headers_;
-    std::string body_;
+    std::pmr::string body_;
+
+    body_producer_t body_producer_;
 
     response_sender_t sender_;
 
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    async_response_sender_t async_sender_;
+#endif
+
     void set_basic_headers();
 };
 
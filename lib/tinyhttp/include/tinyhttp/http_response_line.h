@@ -23,6 +23,9 @@ class HttpResponseLine {
 
     [[nodiscard]] std::string to_string() const;
 
+    // Appends response line without trailing CRLF
+    void append_to(std::string &buf) const;
+
   private:
     constants::http_version http_version_ = constants::http_version::V1_1;
     constants::http_response_status response_status_ = constants::http_response_status::OK;
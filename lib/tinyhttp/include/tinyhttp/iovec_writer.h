@@ -0,0 +1,58 @@
+#ifndef TINYHTTP_TINYHTTP_IOVEC_WRITER_H
+#define TINYHTTP_TINYHTTP_IOVEC_WRITER_H
+
+#include <array>
+#include <string_view>
+#include <cinttypes>
+
+#include "tinyhttp/connection.h"
+#include "tinyhttp/task.h"
+
+extern "C" {
+#include <sys/uio.h>
+}
+
+namespace tinyhttp {
+
+// Writes several non-owning buffers with one gathering call without copying them.
+// Partial writes are tracked, so writing can be resumed from the middle of any part.
+// Buffers must be alive until all bytes are written.
+class IovecWriter {
+  public:
+
+    static constexpr size_t MAX_PARTS_COUNT = 8;
+
+    // Empty parts are skipped, throws std::length_error if there are too many parts
+    void append(std::string_view part);
+
+    // One gathering write of remaining parts, returns -1 if socket is not ready for writing
+    ssize_t write_to(Connection &connection, int flags = 0);
+
+    // Writes all remaining parts, yields current coroutine while socket is not ready.
+    // Flags are passed to every write, see Connection::writev
+    void flush(Connection &connection, int flags = 0);
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    // Same as flush, but awaits connection events instead of yielding
+    Task<> flush_async(Connection &connection, int flags = 0);
+#endif
+
+    [[nodiscard]] bool empty() const noexcept;
+
+    [[nodiscard]] size_t remaining_size() const noexcept;
+
+    void clear() noexcept;
+
+  private:
+    std::array<iovec, MAX_PARTS_COUNT> parts_{};
+
+    size_t first_part_ = 0;
+    size_t parts_count_ = 0;
+    size_t remaining_size_ = 0;
+
+    void consume(size_t bytes) noexcept;
+};
+
+}
+
+#endif //TINYHTTP_TINYHTTP_IOVEC_WRITER_H
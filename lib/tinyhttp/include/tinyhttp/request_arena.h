@@ -0,0 +1,88 @@
+#ifndef TINYHTTP_TINYHTTP_REQUEST_ARENA_H
+#define TINYHTTP_TINYHTTP_REQUEST_ARENA_H
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace tinyhttp {
+
+// Allocation statistics of request arenas, shared between workers
+class AllocationCounter {
+  public:
+    struct Stats {
+        // cppcheck-suppress unusedStructMember
+        uint64_t requests = 0;
+        // cppcheck-suppress unusedStructMember
+        uint64_t allocations = 0; // all allocations of request objects from arenas
+        // cppcheck-suppress unusedStructMember
+        uint64_t heap_allocations = 0; // allocations, which didn't fit in arenas initial buffers
+        // cppcheck-suppress unusedStructMember
+        uint64_t heap_bytes = 0;
+    };
+
+    void add(const Stats &stats) noexcept;
+
+    [[nodiscard]] Stats get_stats() const noexcept;
+
+  private:
+    std::atomic<uint64_t> requests_ = 0;
+    std::atomic<uint64_t> allocations_ = 0;
+    std::atomic<uint64_t> heap_allocations_ = 0;
+    std::atomic<uint64_t> heap_bytes_ = 0;
+};
+
+// Monotonic per-connection arena for request and response objects (see HttpRequestView::get_memory_resource).
+// Deallocation is no-op, memory is released in begin_request, so objects allocated from arena
+// must not outlive their request. Arena is used by one thread at a time.
+class RequestArena final : public std::pmr::memory_resource {
+  public:
+    static constexpr size_t DEFAULT_INITIAL_SIZE = 4096;
+
+    explicit RequestArena(size_t initial_size = DEFAULT_INITIAL_SIZE, AllocationCounter *counter = nullptr);
+
+    RequestArena(const RequestArena &) = delete;
+
+    RequestArena &operator=(const RequestArena &) = delete;
+
+    // Reports statistics of previous request to counter and releases its memory
+    void begin_request() noexcept;
+
+    ~RequestArena() noexcept override;
+
+  private:
+    // nickeskov: upstream of arena, counts allocations of memory beyond initial buffer
+    class HeapResource final : public std::pmr::memory_resource {
+      public:
+        explicit HeapResource(AllocationCounter::Stats &stats) noexcept : stats_(stats) {}
+
+      private:
+        AllocationCounter::Stats &stats_;
+
+        void *do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+    };
+
+    AllocationCounter *counter_;
+    AllocationCounter::Stats stats_; // nickeskov: of current request
+    std::unique_ptr<std::byte[]> initial_buffer_;
+    HeapResource heap_;
+    std::pmr::monotonic_buffer_resource arena_;
+
+    void report() noexcept;
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+};
+
+}
+
+#endif //TINYHTTP_TINYHTTP_REQUEST_ARENA_H
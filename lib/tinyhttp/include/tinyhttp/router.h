@@ -0,0 +1,170 @@
+#ifndef TINYHTTP_TINYHTTP_ROUTER_H
+#define TINYHTTP_TINYHTTP_ROUTER_H
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cinttypes>
+
+#include "tinyhttp/constants.h"
+#include "tinyhttp/http_request_view.h"
+#include "tinyhttp/http_response.h"
+
+namespace tinyhttp {
+
+// Values of path parameters of matched route, views into request path (not decoded)
+class RouteParams {
+  public:
+    static constexpr size_t MAX_PARAMS_COUNT = 8;
+
+    struct Param {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    [[nodiscard]] size_t size() const noexcept;
+
+    [[nodiscard]] Param get(size_t index) const noexcept;
+
+    // Returns empty view if param not exists
+    [[nodiscard]] std::string_view get(std::string_view name) const noexcept;
+
+  private:
+    friend class Router;
+
+    std::array<Param, MAX_PARAMS_COUNT> params_{};
+    size_t size_ = 0;
+};
+
+// Pattern is path with optional parameter segments: "/users/:id/posts/*rest".
+// ":name" matches one non-empty segment, "*name" matches the rest of path and must be last.
+// Can be used in static_assert, so static route tables are checked at compile time.
+constexpr bool is_valid_route_pattern(std::string_view pattern) noexcept {
+    if (pattern.empty() || pattern.front() != '/') {
+        return false;
+    }
+
+    size_t params_count = 0;
+    for (size_t i = 1; i < pattern.size(); ++i) {
+        const char symbol = pattern[i];
+        if (symbol != ':' && symbol != '*') {
+            continue;
+        }
+
+        size_t name_end = pattern.find('/', i);
+        if (name_end == std::string_view::npos) {
+            name_end = pattern.size();
+        }
+
+        if (pattern[i - 1] != '/' || name_end == i + 1
+            || (symbol == '*' && name_end != pattern.size())
+            || ++params_count > RouteParams::MAX_PARAMS_COUNT) {
+            return false;
+        }
+
+        for (size_t j = i + 1; j < name_end; ++j) {
+            if (pattern[j] == ':' || pattern[j] == '*') {
+                return false;
+            }
+        }
+        i = name_end;
+    }
+    return true;
+}
+
+// Radix tree of routes. Static edges are preferred to parameters, parameters to wildcards.
+// Lookup doesn't allocate memory. Router is not changed by lookups, so it can be shared
+// between workers after all routes are added.
+class Router {
+  public:
+    using handler_t = std::function<HttpResponse(const HttpRequestView &, const RouteParams &)>;
+    using plain_handler_t = HttpResponse (*)(const HttpRequestView &, const RouteParams &);
+
+    // Route of static table, see make_routes
+    struct Route {
+        // cppcheck-suppress unusedStructMember
+        constants::http_method method = constants::http_method::UNSUPPORTED_;
+        // cppcheck-suppress unusedStructMember
+        std::string_view pattern;
+        // cppcheck-suppress unusedStructMember
+        plain_handler_t handler = nullptr;
+    };
+
+    Router();
+
+    Router(const Router &) = delete;
+
+    Router &operator=(const Router &) = delete;
+
+    Router(Router &&) noexcept = default;
+
+    Router &operator=(Router &&) noexcept = default;
+
+    // throws errors::RouterError if pattern is invalid, conflicts with other route or route exists
+    void add(constants::http_method method, std::string_view pattern, handler_t handler);
+
+    template<size_t N>
+    void add(const std::array<Route, N> &routes) {
+        for (const auto &route : routes) {
+            add(route.method, route.pattern, route.handler);
+        }
+    }
+
+    // Returns nullptr if no route matches path and method
+    [[nodiscard]] const handler_t *match(constants::http_method method, std::string_view path,
+                                         RouteParams &params) const noexcept;
+
+    // Calls handler of matched route. Responds 404 if path is unknown and 405 with Allow header
+    // if path has no route for request method
+    [[nodiscard]] HttpResponse dispatch(const HttpRequestView &request) const;
+
+    ~Router() noexcept;
+
+  private:
+    static constexpr size_t METHODS_COUNT = static_cast<size_t>(constants::http_method::TRACE) + 1;
+
+    struct Node {
+        // cppcheck-suppress unusedStructMember
+        std::string prefix; // nickeskov: label of edge from parent, empty for parameter nodes
+        // cppcheck-suppress unusedStructMember
+        std::string indices; // nickeskov: first symbols of static children prefixes
+        std::vector<std::unique_ptr<Node>> children;
+        std::unique_ptr<Node> param_child;
+        std::unique_ptr<Node> wildcard_child;
+        // cppcheck-suppress unusedStructMember
+        std::string param_name; // nickeskov: name of parameter for parameter and wildcard nodes
+        std::array<handler_t, METHODS_COUNT> handlers;
+        // cppcheck-suppress unusedStructMember
+        bool has_handlers = false;
+    };
+
+    std::unique_ptr<Node> root_;
+
+    static Node &insert_static(Node &node, std::string_view label);
+
+    static Node &insert_param(std::unique_ptr<Node> &param_node, std::string_view name);
+
+    // Returns node with handler for method, first node matching only path is saved to path_node
+    static const Node *find(const Node &node, std::string_view path, size_t method_index,
+                            RouteParams &params, const Node *&path_node) noexcept;
+};
+
+// Checks static route table at compile time, if result is constexpr:
+// constexpr auto ROUTES = make_routes<2>({{{GET, "/", &index}, {GET, "/users/:id", &user}}});
+template<size_t N>
+constexpr std::array<Router::Route, N> make_routes(const std::array<Router::Route, N> &routes) {
+    for (const auto &route : routes) {
+        if (!is_valid_route_pattern(route.pattern) || route.handler == nullptr) {
+            throw std::invalid_argument("invalid static route"); // nickeskov: compile error in constexpr context
+        }
+    }
+    return routes;
+}
+
+}
+
+#endif //TINYHTTP_TINYHTTP_ROUTER_H
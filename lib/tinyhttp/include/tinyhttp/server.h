@@ -2,14 +2,23 @@
 #define TINYHTTP_TINYHTTP_SERVER_H
 
 #include <string_view>
+#include <memory>
 #include <thread>
 #include <atomic>
 #include <chrono>
 
 #include "unixprimwrap/descriptor.h"
+#include "unixprimwrap/poller.h"
 #include "trivilog/base_logger.h"
+#include "coroutine/stack_pool.h"
+#include "tinyhttp/handler_pool.h"
+#include "tinyhttp/request_arena.h"
+#include "tinyhttp/http_body_reader.h"
 #include "tinyhttp/http_request.h"
+#include "tinyhttp/http_request_parser.h"
+#include "tinyhttp/http_request_view.h"
 #include "tinyhttp/http_response.h"
+#include "tinyhttp/task.h"
 
 extern "C" {
 #include <sys/epoll.h>
@@ -30,6 +39,47 @@ class Server {
         sigset_t *epoll_sigmask = nullptr;
         // cppcheck-suppress unusedStructMember
         int epoll_timeout = -1;
+        // cppcheck-suppress unusedStructMember
+        int keepalive_timeout = 5000; // milliseconds, negative value means no idle limit
+        // cppcheck-suppress unusedStructMember
+        int header_timeout = 10000; // milliseconds to receive request headers, negative value means no limit
+        // cppcheck-suppress unusedStructMember
+        int body_timeout = 30000; // milliseconds between body reads, negative value means no limit
+        // cppcheck-suppress unusedStructMember
+        int write_timeout = 30000; // milliseconds between response writes, negative value means no limit
+        // cppcheck-suppress unusedStructMember
+        size_t keepalive_max_requests = 100; // 0 means no limit
+        // cppcheck-suppress unusedStructMember
+        bool edge_triggered = false; // EPOLLET for client connections, io is drained until EAGAIN
+        // cppcheck-suppress unusedStructMember
+        int max_accept_clients_per_loop = 1; // negative value means accept until EAGAIN
+        // cppcheck-suppress unusedStructMember
+        bool reuse_port = false; // each worker accepts on its own SO_REUSEPORT listening socket, run rebinds
+                                 // server socket, otherwise it is bound exclusively
+        // cppcheck-suppress unusedStructMember
+        bool pin_workers_to_cpus = false; // worker with worker_id runs on cpu (worker_id % cpu_count)
+        // cppcheck-suppress unusedStructMember
+        coroutine::StackPool::Config client_stacks; // stacks of client routines, every worker has own pool,
+                                                    // not used in stackless (C++20 coroutines) build
+        // nickeskov: io_uring backend accepts by multishot accept and receives by multishot recv into
+        //  provided buffers (kernel 6.0), so connections and requests are taken without syscalls.
+        //  Its poll has no EPOLLEXCLUSIVE, so use IO_URING and AUTO with reuse_port
+        // cppcheck-suppress unusedStructMember
+        unixprimwrap::poller_backend event_backend = unixprimwrap::poller_backend::EPOLL;
+        // nickeskov: handlers run in pool threads, so they don't stall other connections of worker.
+        // With pool on_request_view is called instead of on_request_async in stackless build
+        // cppcheck-suppress unusedStructMember
+        size_t handler_threads = 0; // 0 means handlers run in worker threads
+        // cppcheck-suppress unusedStructMember
+        size_t handler_queue_size = 1024; // requests over limit are handled in worker threads
+        // cppcheck-suppress unusedStructMember
+        size_t request_arena_size = RequestArena::DEFAULT_INITIAL_SIZE; // initial arena of every connection
+        // nickeskov: limit of request line with headers, larger headers (or not ended ones, which exceed it)
+        //  get RequestHeaderFieldsTooLarge, so client can't grow connection buffer until header timeout
+        // cppcheck-suppress unusedStructMember
+        size_t max_headers_size = HttpRequestParser::DEFAULT_MAX_HEADERS_SIZE; // bytes, 0 means no limit
+        // cppcheck-suppress unusedStructMember
+        size_t max_body_size = 0; // bytes, 0 means no limit, larger requests get RequestEntityTooLarge
     };
 
     Server(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger);
@@ -55,6 +105,16 @@ class Server {
 
     [[nodiscard]] const unixprimwrap::Descriptor &get_acceptor_service() const noexcept;
 
+    // Returns nullptr if handlers run in worker threads
+    [[nodiscard]] HandlerPool *get_handler_pool() const noexcept;
+
+    // Allocations of request and response objects from connection arenas
+    [[nodiscard]] AllocationCounter &get_allocation_counter() noexcept;
+
+    // Creates new listening socket bound to the same address with SO_REUSEPORT, kernel balances
+    // incoming connections between all such sockets. Server socket must be rebound with SO_REUSEPORT too
+    [[nodiscard]] unixprimwrap::Descriptor create_acceptor_service() const;
+
     [[nodiscard]] bool is_opened() const noexcept;
 
     [[nodiscard]] bool is_stopped() const noexcept;
@@ -65,6 +125,32 @@ class Server {
 
     virtual HttpResponse on_request(const HttpRequest &request) = 0;
 
+    // Called by workers for every request. Default implementation creates owning
+    // HttpRequest and calls on_request, override it to handle request without copies
+    virtual HttpResponse on_request_view(const HttpRequestView &request);
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    // Called by workers instead of on_request_view in stackless build, handler may await
+    // events of connection (Connection::wait_io), but must not change its io buffer,
+    // which request points into. Default implementation calls on_request_view
+    virtual Task<HttpResponse> on_request_async(const HttpRequestView &request, Connection &connection);
+#endif
+
+    // Called by workers right after request headers are received. If it returns true, body isn't
+    // buffered and request is passed to on_request_stream (on_request_stream_async in stackless build)
+    // with empty body view. Default implementation returns false
+    virtual bool is_body_streamed(const HttpRequestView &request);
+
+    // Handler of streamed requests, it reads body by parts in worker thread (never in handler pool).
+    // Connection is closed after response if body isn't read to the end.
+    // Default implementation responds NotImplemented
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    virtual Task<HttpResponse> on_request_stream_async(const HttpRequestView &request, HttpBodyReader &body,
+                                                       Connection &connection);
+#else
+    virtual HttpResponse on_request_stream(const HttpRequestView &request, HttpBodyReader &body);
+#endif
+
     virtual ~Server() noexcept = default;
 
   protected:
@@ -77,6 +163,10 @@ class Server {
   private:
     std::string src_addr_;
     uint16_t src_port_{};
+
+    std::unique_ptr<HandlerPool> handler_pool_;
+
+    AllocationCounter allocation_counter_;
 };
 
 }
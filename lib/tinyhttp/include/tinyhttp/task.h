@@ -0,0 +1,176 @@
+#ifndef TINYHTTP_TINYHTTP_TASK_H
+#define TINYHTTP_TINYHTTP_TASK_H
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace tinyhttp {
+
+template<typename T>
+class Task;
+
+class TaskPromiseBase {
+  public:
+    // nickeskov: resumes awaiting task without recursion, root task just stops
+    struct FinalAwaiter {
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+            auto continuation = handle.promise().continuation_;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    [[nodiscard]] std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    [[nodiscard]] FinalAwaiter final_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        exception_ = std::current_exception();
+    }
+
+    void set_continuation(std::coroutine_handle<> continuation) noexcept {
+        continuation_ = continuation;
+    }
+
+    void rethrow_if_failed() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+  private:
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr exception_;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase {
+  public:
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U &&value) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T take_value() {
+        rethrow_if_failed();
+        return std::move(*value_);
+    }
+
+  private:
+    std::optional<T> value_;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase {
+  public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void take_value() const {
+        rethrow_if_failed();
+    }
+};
+
+// Lazy stackless task, starts when it is awaited or started by owner.
+// Exception of task is rethrown in awaiting task. Task frame is destroyed with Task object,
+// so suspended task can be cancelled by destruction.
+template<typename T = void>
+class [[nodiscard]] Task {
+  public:
+    using promise_type = TaskPromise<T>;
+    using handle_t = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+
+    explicit Task(handle_t handle) noexcept : handle_(handle) {}
+
+    Task(const Task &) = delete;
+
+    Task &operator=(const Task &) = delete;
+
+    Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return !handle_ || handle_.done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().set_continuation(awaiting);
+        return handle_;
+    }
+
+    T await_resume() {
+        return handle_.promise().take_value();
+    }
+
+    // Runs root task until its first suspension, task must not be started yet
+    void start() {
+        handle_.resume();
+    }
+
+    [[nodiscard]] bool is_valid() const noexcept {
+        return static_cast<bool>(handle_);
+    }
+
+    [[nodiscard]] bool is_done() const noexcept {
+        return handle_ && handle_.done();
+    }
+
+    void rethrow_if_failed() const {
+        handle_.promise().rethrow_if_failed();
+    }
+
+    ~Task() noexcept {
+        destroy();
+    }
+
+  private:
+    handle_t handle_;
+
+    void destroy() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+};
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(Task<T>::handle_t::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(Task<void>::handle_t::from_promise(*this));
+}
+
+}
+
+#endif
+
+#endif //TINYHTTP_TINYHTTP_TASK_H
@@ -0,0 +1,81 @@
+#ifndef TINYHTTP_TINYHTTP_TIMER_WHEEL_H
+#define TINYHTTP_TINYHTTP_TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include <cinttypes>
+
+namespace tinyhttp {
+
+// Hierarchical timer wheel with O(1) schedule and cancel, not thread safe.
+// Every id has at most one timer, scheduling of existing id moves its deadline.
+// Deadline moved later keeps slot entry, which is reinserted when wheel reaches it.
+// Cancelled and moved earlier timers are removed lazily, when wheel reaches their slot.
+// Timers are indexed by id, so ids must be small non-negative integers (e.g. fds).
+class TimerWheel {
+  public:
+    using clock_t = std::chrono::steady_clock;
+    using timer_id_t = int;
+
+    static constexpr size_t LEVELS_COUNT = 4;
+    static constexpr size_t SLOTS_BITS = 6;
+    static constexpr size_t SLOTS_COUNT = 1u << SLOTS_BITS;
+
+    TimerWheel(std::chrono::milliseconds tick, clock_t::time_point now);
+
+    void schedule(timer_id_t id, clock_t::time_point deadline);
+
+    void cancel(timer_id_t id);
+
+    // Advances wheel to now and appends ids of expired timers to expired_ids
+    void expire(clock_t::time_point now, std::vector<timer_id_t> &expired_ids);
+
+    // Milliseconds to wait before next expire call, -1 if there are no timers
+    [[nodiscard]] int get_timeout(clock_t::time_point now) const;
+
+    [[nodiscard]] size_t size() const noexcept;
+
+    [[nodiscard]] bool empty() const noexcept;
+
+  private:
+    struct SlotEntry {
+        // cppcheck-suppress unusedStructMember
+        timer_id_t id;
+        // cppcheck-suppress unusedStructMember
+        uint64_t generation;
+    };
+
+    struct Timer {
+        // cppcheck-suppress unusedStructMember
+        uint64_t deadline_tick = 0;
+        // cppcheck-suppress unusedStructMember
+        uint64_t generation = 0; // nickeskov: 0 means that timer is not scheduled
+    };
+
+    using slot_t = std::vector<SlotEntry>;
+
+    const std::chrono::milliseconds tick_;
+    const clock_t::time_point start_;
+
+    uint64_t current_tick_ = 0;
+    uint64_t generation_ = 0;
+
+    std::array<std::array<slot_t, SLOTS_COUNT>, LEVELS_COUNT> levels_;
+    std::vector<Timer> timers_;
+    size_t timers_count_ = 0;
+
+    [[nodiscard]] uint64_t to_tick(clock_t::time_point time_point) const noexcept;
+
+    void insert(const SlotEntry &entry, uint64_t deadline_tick);
+
+    void cascade(size_t level);
+
+    [[nodiscard]] bool is_scheduled(timer_id_t id) const noexcept;
+
+    [[nodiscard]] bool is_actual(const SlotEntry &entry) const noexcept;
+};
+
+}
+
+#endif //TINYHTTP_TINYHTTP_TIMER_WHEEL_H
@@ -3,11 +3,23 @@
 
 #include <string>
 #include <string_view>
+#include <ctime>
 
 namespace tinyhttp::utils {
 
 std::string to_lower(std::string_view view);
 
+// HTTP tokens are ASCII, so case is folded without locale lookup
+constexpr char to_lower_ascii(char symbol) noexcept {
+    return symbol >= 'A' && symbol <= 'Z' ? static_cast<char>(symbol - 'A' + 'a') : symbol;
+}
+
+// ASCII case insensitive comparison
+bool iequals(std::string_view lhs, std::string_view rhs) noexcept;
+
+// Checks if comma separated header value (like "keep-alive, Upgrade") contains token
+bool contains_token(std::string_view header_value, std::string_view token) noexcept;
+
 std::string decode_url(std::string_view url_view);
 
 int set_nonblock(int fd, bool opt);
@@ -16,6 +28,25 @@ std::string now_time_to_str_gmt(const char *fmt, const char *locale);
 
 std::string get_date_http_str();
 
+// RFC 7231, 7.1.1.1: IMF-fixdate, like "Sun, 06 Nov 1994 08:49:37 GMT"
+constexpr size_t HTTP_DATE_LENGTH = 29;
+
+// Writes exactly HTTP_DATE_LENGTH chars into out, not null terminated
+void format_http_date(time_t time, char *out) noexcept;
+
+std::string format_http_date(time_t time);
+
+// Parses IMF-fixdate only, obsolete formats are treated as invalid. Returns false if date is invalid
+bool parse_http_date(std::string_view text, time_t &time) noexcept;
+
+// Current date in IMF-fixdate format, refreshed at most once per second for each thread.
+// View is valid until next call in the same thread
+std::string_view get_cached_date_http_str() noexcept;
+
+// Preformatted "Server: ...\r\nDate: ...\r\n" block, refreshed with date.
+// View is valid until next call in the same thread
+std::string_view get_cached_basic_headers() noexcept;
+
 }
 
 #endif //TINYHTTP_TINYHTTP_UTILS_H
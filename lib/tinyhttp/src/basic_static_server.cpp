@@ -1,18 +1,24 @@
 #include "tinyhttp/basic_static_server.h"
+#include "tinyhttp/errors.h"
+#include "tinyhttp/iovec_writer.h"
+#include "tinyhttp/utils.h"
 #include "coroutine/coroutine.h"
 #include "unixprimwrap/descriptor.h"
 
 #include <filesystem>
 #include <stdexcept>
-#include <unordered_map>
+#include <algorithm>
+#include <charconv>
+#include <limits>
 #include <utility>
-#include <cstring>
+#include <cerrno>
 
 extern "C" {
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/sendfile.h>
+#include <sys/socket.h>
 }
 
 namespace tinyhttp {
@@ -23,149 +29,434 @@ namespace fs = std::filesystem;
 
 namespace {
 
-const std::unordered_map<std::string_view, std::string_view> mime_type_by_extension = {
-        {".html", "text/html"},
-        {".css",  "text/css"},
-        {".js",   "application/javascript"},
-        {".jpg",  "image/jpeg"},
-        {".jpeg", "image/jpeg"},
-        {".png",  "image/png"},
-        {".gif",  "image/gif"},
-        {".swf",  "application/x-shockwave-flash"},
-};
+// nickeskov: maximum of bytes, which can be transferred by sendfile per call
+constexpr size_t MAX_SENDFILE_BYTES_PER_CALL = 0x7ffff000;
 
-constexpr size_t MAX_WRITE_BYTES_PER_CALL = 16384;
-constexpr std::string_view mime_octet_stream = "application/octet-stream";
+std::string get_canonical_directory(std::string_view path) {
+    fs::path document_path = fs::canonical(path); // nickeskov: if no such directory throw exception
 
-inline std::string_view get_mime_type(std::string_view extension) {
-    if (mime_type_by_extension.count(extension) > 0) {
-        return mime_type_by_extension.at(extension);
+    if (!fs::is_directory(document_path)) {
+        throw std::runtime_error("document_root="s + document_path.native() + " is not a directory");
     }
-    return mime_octet_stream;
-}
-
 
+    return document_path;
 }
 
-BasicStaticServer::BasicStaticServer(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger,
-                                     std::string_view document_root) : Server(
-        ip, port, logger) {
-
+// One sendfile call, returns false if socket is not ready
+bool send_file_chunk(Connection &connection, FileCache &file_cache, const FileCache::Entry &file,
+                     off_t &offset, off_t end) {
+    const auto left_size = static_cast<size_t>(end - offset);
 
-    fs::path document_path = fs::canonical(document_root); // nickeskov: if no such directory throw exception
-    document_root_ = document_path;
+    auto bytes = sendfile(connection.get_io_service().data(), file.fd.data(),
+                          &offset, std::min(left_size, MAX_SENDFILE_BYTES_PER_CALL));
 
-    if (!fs::is_directory(document_path)) {
-        throw std::runtime_error("document_root=" + document_root_ + " is not a directory");
+    if (bytes < 0) {
+        if (errno != EAGAIN) {
+            throw errors::WriteError("sendfile error occurs while writing to endpoint, sock_fd="
+                                     + std::to_string(connection.get_io_service().data()));
+        }
+        return false;
     }
 
+    if (bytes == 0) {
+        // nickeskov: file was truncated after it was cached, so only this connection is dropped
+        file_cache.invalidate(file);
+
+        errno = EIO; // nickeskov: sendfile doesn't set errno on end of file, but it is captured by error
+        throw errors::WriteError("sendfile error: file was truncated, path=" + file.path);
+    }
+    return true;
 }
 
-HttpResponse BasicStaticServer::on_request(const HttpRequest &request) {
-    auto http_version = request.get_request_line().get_version();
-    auto method = request.get_request_line().get_method();
+// Sends as much as socket accepts per call, yields only if socket is not ready
+void send_file_part(Connection &connection, FileCache &file_cache, const FileCache::Entry &file,
+                    size_t first, size_t length) {
+    // nickeskov: fd is shared between connections, so explicit offset must be used
+    auto offset = static_cast<off_t>(first);
+    const auto end = static_cast<off_t>(first + length);
 
-    if (method != constants::http_method::HEAD
-        && method != constants::http_method::GET) {
-        return HttpResponse(constants::http_response_status::MethodNotAllowed, http_version);
+    while (offset < end) {
+        if (!send_file_chunk(connection, file_cache, file, offset, end)) {
+            coroutine::yield();
+        }
     }
+}
 
-    fs::path file_path = document_root_ + request.get_request_line().get_url();
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
 
-    std::error_code error_code;
+Task<> send_file_part_async(Connection &connection, FileCache &file_cache, const FileCache::Entry &file,
+                            size_t first, size_t length) {
+    auto offset = static_cast<off_t>(first);
+    const auto end = static_cast<off_t>(first + length);
 
-    if (!fs::exists(file_path, error_code)) { // nickeskov: if exists file
-        if (error_code && error_code.value() == EACCES) {
-            return HttpResponse(constants::http_response_status::Forbidden, http_version);
+    while (offset < end) {
+        if (!send_file_chunk(connection, file_cache, file, offset, end)) {
+            co_await connection.wait_io();
         }
-        return HttpResponse(constants::http_response_status::NotFound, http_version);
     }
+}
 
-    file_path = fs::canonical(file_path);
+#endif
 
-    if (file_path.native().find(document_root_) != 0) { // nickeskov: check if file not in document root
-        return HttpResponse(constants::http_response_status::BadRequest, http_version);
+// Sends head with preformatted entity headers and part of file from memory or by sendfile
+struct FileSender {
+    // cppcheck-suppress unusedStructMember
+    FileCache *file_cache; // nickeskov: owned by server, which outlives all responses
+    // cppcheck-suppress unusedStructMember
+    FileCache::entry_ptr_t file;
+    // cppcheck-suppress unusedStructMember
+    std::string_view raw_headers; // nickeskov: points into file entry, so it is alive while sender is alive
+    // cppcheck-suppress unusedStructMember
+    size_t first;
+    // cppcheck-suppress unusedStructMember
+    size_t length;
+
+    void operator()(Connection &connection, HttpResponse &http_response) const {
+        IovecWriter writer;
+        prepare_head(connection, http_response, writer);
+
+        // nickeskov: MSG_MORE corks head, so it goes out together with the first file segment
+        writer.flush(connection, is_file_sent() ? MSG_MORE : 0);
+
+        connection.get_io_buffer().clear();
+
+        if (is_file_sent()) {
+            send_file_part(connection, *file_cache, *file, first, length);
+        }
     }
 
-    if (fs::is_directory(file_path)) { // nickeskov: display index file
-        file_path = file_path / "index.html";
-        if (!fs::exists(file_path, error_code)) { // nickeskov: check if index file exists
-            if (error_code) {
-                return HttpResponse(constants::http_response_status::InternalServerError, http_version);
-            }
-            return HttpResponse(constants::http_response_status::Forbidden, http_version);
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    Task<> send_async(Connection &connection, HttpResponse &http_response) const {
+        IovecWriter writer;
+        prepare_head(connection, http_response, writer);
+
+        co_await writer.flush_async(connection, is_file_sent() ? MSG_MORE : 0);
+
+        connection.get_io_buffer().clear();
+
+        if (is_file_sent()) {
+            co_await send_file_part_async(connection, *file_cache, *file, first, length);
         }
     }
+#endif
+
+    [[nodiscard]] bool is_file_sent() const noexcept {
+        return !file->is_in_memory && length != 0;
+    }
+
+    // Serializes head into io buffer of connection
+    void prepare_head(Connection &connection, HttpResponse &http_response, IovecWriter &writer) const {
+        auto &head = connection.get_io_buffer();
+
+        head.clear();
+        http_response.serialize_head(head, raw_headers);
+
+        writer.append(head);
 
-    if (!fs::exists(file_path, error_code)) { // nickeskov: check if index file exists
-        if (error_code && error_code.value() == EACCES) {
-            return HttpResponse(constants::http_response_status::Forbidden, http_version);
+        if (file->is_in_memory) {
+            // nickeskov: whole response with single writev
+            writer.append(std::string_view(file->content).substr(first, length));
         }
-        return HttpResponse(constants::http_response_status::NotFound, http_version);
     }
+};
+
+void set_file_sender(HttpResponse &response, FileSender &&sender) {
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    response.set_async_sender([sender = std::move(sender)](Connection &connection, HttpResponse &http_response) {
+        return sender.send_async(connection, http_response);
+    });
+#else
+    response.set_sender(std::move(sender));
+#endif
+}
+
+struct ByteRange {
+    // cppcheck-suppress unusedStructMember
+    size_t first;
+    // cppcheck-suppress unusedStructMember
+    size_t length;
+};
+
+enum class range_status : uint8_t {
+    NONE, // nickeskov: no range or invalid range, whole file must be sent
+    SATISFIABLE,
+    UNSATISFIABLE,
+};
 
-    auto content_length = fs::file_size(file_path);
-    auto mime_type = get_mime_type(file_path.extension().string());
+std::string_view trim_whitespace(std::string_view view) noexcept {
+    const auto begin = view.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    return view.substr(begin, view.find_last_not_of(" \t") - begin + 1);
+}
 
-    HttpResponse response(constants::http_response_status::OK, http_version);
+bool parse_size(std::string_view text, size_t &value) noexcept {
+    const auto text_end = text.data() + text.size();
+    const auto[parsed_end, error_code] = std::from_chars(text.data(), text_end, value);
+    return !text.empty() && error_code == std::errc() && parsed_end == text_end;
+}
 
-    auto &headers = response.get_headers();
+// RFC 7233, 2.1: only single byte range is supported, multiple ranges are ignored
+range_status parse_byte_range(std::string_view range, size_t file_size, ByteRange &byte_range) noexcept {
+    range = trim_whitespace(range);
 
-    headers.emplace(constants::headers::content_length, std::to_string(content_length));
-    headers.emplace(constants::headers::content_type, mime_type);
+    const auto unit = constants::range_units::bytes;
+    if (range.substr(0, unit.size()) != unit || range.substr(unit.size(), 1) != constants::strings::equal) {
+        return range_status::NONE;
+    }
 
-    if (method == constants::http_method::HEAD) {
-        return response; // nickeskov: if head request response must have empty body
+    const auto spec = trim_whitespace(range.substr(unit.size() + constants::strings::equal.size()));
+    const auto dash_pos = spec.find(constants::strings::dash);
+    if (spec.find(constants::strings::comma) != std::string_view::npos || dash_pos == std::string_view::npos) {
+        return range_status::NONE;
     }
 
-    auto sender = [file_path, content_length](Connection &connection, HttpResponse &http_response) {
-        auto fd_file = unixprimwrap::Descriptor(open(file_path.c_str(), O_RDONLY));
-        if (!fd_file.is_valid()) {
-            http_response.reset_headers();
-            http_response.get_response_line().set_response_status(
-                    constants::http_response_status::InternalServerError);
+    const auto first_text = spec.substr(0, dash_pos);
+    const auto last_text = spec.substr(dash_pos + constants::strings::dash.size());
+
+    if (first_text.empty()) { // nickeskov: suffix range "-N", last N bytes
+        size_t suffix_length = 0;
+        if (!parse_size(last_text, suffix_length)) {
+            return range_status::NONE;
+        }
+        if (suffix_length == 0 || file_size == 0) {
+            return range_status::UNSATISFIABLE;
         }
+        byte_range.length = std::min(suffix_length, file_size);
+        byte_range.first = file_size - byte_range.length;
+        return range_status::SATISFIABLE;
+    }
 
-        connection.get_io_buffer().clear();
-        connection.get_io_buffer() += http_response.to_string();
+    size_t first = 0;
+    size_t last = std::numeric_limits<size_t>::max();
+    if (!parse_size(first_text, first) || (!last_text.empty() && !parse_size(last_text, last))) {
+        return range_status::NONE;
+    }
 
-        auto write_size = connection.get_io_buffer().size();
-        for (size_t written = 0; written < write_size;) {
-            auto bytes = connection.write_from_io_buff(MAX_WRITE_BYTES_PER_CALL);
+    if (last < first) {
+        return range_status::NONE;
+    }
 
-            if (bytes < 0) {
-                coroutine::yield();
-                continue;
-            }
+    if (first >= file_size) {
+        return range_status::UNSATISFIABLE;
+    }
+
+    byte_range.first = first;
+    byte_range.length = std::min(last, file_size - 1) - first + 1;
+    return range_status::SATISFIABLE;
+}
+
+std::string format_content_range(const ByteRange &byte_range, size_t file_size) {
+    return std::string(constants::range_units::bytes) + " "
+           + std::to_string(byte_range.first) + "-" + std::to_string(byte_range.first + byte_range.length - 1)
+           + "/" + std::to_string(file_size);
+}
+
+std::string format_unsatisfied_range(size_t file_size) {
+    return std::string(constants::range_units::bytes) + " */" + std::to_string(file_size);
+}
+
+inline std::string_view remove_weak_prefix(std::string_view etag) noexcept {
+    constexpr std::string_view weak_prefix = "W/";
+    if (etag.substr(0, weak_prefix.size()) == weak_prefix) {
+        etag.remove_prefix(weak_prefix.size());
+    }
+    return etag;
+}
+
+// RFC 7232, 3.2: weak comparison for If-None-Match
+bool is_etag_listed(std::string_view etags, std::string_view etag) noexcept {
+    etag = remove_weak_prefix(etag);
+
+    while (!etags.empty()) {
+        const auto comma_pos = etags.find(constants::strings::comma);
+        const auto candidate = trim_whitespace(etags.substr(0, comma_pos));
 
-            written += bytes;
+        if (candidate == "*" || remove_weak_prefix(candidate) == etag) {
+            return true;
+        }
 
-            coroutine::yield(); // nickeskov: using level triggered mode
+        if (comma_pos == std::string_view::npos) {
+            break;
         }
+        etags.remove_prefix(comma_pos + constants::strings::comma.size());
+    }
+
+    return false;
+}
 
-        if (fd_file.is_valid()) {
-            write_size = content_length;
-            for (size_t written = 0; written < write_size;) {
-                // nickeskov: send maximum of possible bytes per call
-                auto bytes = sendfile(connection.get_io_service().data(), fd_file.data(),
-                                      nullptr, MAX_WRITE_BYTES_PER_CALL);
+// RFC 7231, 5.3.4: coding is acceptable if it is listed or "*" is listed and its qvalue is not 0
+bool is_gzip_accepted(std::string_view accept_encoding) noexcept {
+    while (!accept_encoding.empty()) {
+        const auto comma_pos = accept_encoding.find(constants::strings::comma);
+        const auto item = accept_encoding.substr(0, comma_pos);
 
-                if (bytes < 0) {
-                    if (errno != EAGAIN) {
-                        throw std::runtime_error("sendfile error: "s + (std::strerror(errno)));
-                    }
-                    coroutine::yield();
-                    continue;
-                }
+        const auto params_pos = item.find(';');
+        const auto coding = trim_whitespace(item.substr(0, params_pos));
 
-                written += bytes;
+        if (utils::iequals(coding, constants::content_codings::gzip) || coding == constants::content_codings::any) {
+            if (params_pos == std::string_view::npos) {
+                return true;
+            }
 
-                coroutine::yield(); // nickeskov: using level triggered mode
+            // nickeskov: "q=0", "q=0.0", "q=0.00" and "q=0.000" disable coding
+            const auto params = trim_whitespace(item.substr(params_pos + 1));
+            if (params.substr(0, 2) != "q=" || params.find_first_not_of("0.", 2) != std::string_view::npos) {
+                return true;
             }
+            return false;
+        }
+
+        if (comma_pos == std::string_view::npos) {
+            break;
         }
+        accept_encoding.remove_prefix(comma_pos + constants::strings::comma.size());
+    }
+
+    return false;
+}
+
+// RFC 7232, 6: If-Modified-Since is evaluated only if If-None-Match not exists
+bool is_not_modified(const FileCache::Entry &file, std::string_view if_none_match,
+                     std::string_view if_modified_since) noexcept {
+    if (!if_none_match.empty()) {
+        return is_etag_listed(if_none_match, file.etag);
+    }
+
+    time_t since = 0;
+    if (!if_modified_since.empty() && utils::parse_http_date(trim_whitespace(if_modified_since), since)) {
+        return file.mtime.tv_sec <= since;
+    }
+
+    return false;
+}
+
+// RFC 7233, 3.2: range is applied only if representation is not changed since If-Range validator
+bool is_range_applicable(const FileCache::Entry &file, std::string_view if_range) noexcept {
+    if_range = trim_whitespace(if_range);
+    if (if_range.empty()) {
+        return true;
+    }
+
+    if (if_range.front() == '"' || if_range.substr(0, 2) == "W/") {
+        return if_range == file.etag; // nickeskov: strong comparison, weak tags never match
+    }
+
+    time_t date = 0;
+    return utils::parse_http_date(if_range, date) && date == file.mtime.tv_sec;
+}
+
+}
+
+BasicStaticServer::BasicStaticServer(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger,
+                                     std::string_view document_root, const FileCache::Config &file_cache_cfg)
+        : Server(ip, port, logger), file_cache_(get_canonical_directory(document_root), file_cache_cfg) {}
+
+HttpResponse BasicStaticServer::on_request(const HttpRequest &request) {
+    const auto &headers = request.get_headers();
+
+    auto get_header = [&headers](constants::well_known_header header) {
+        return headers.contains(header) ? std::string_view(headers.at(header)) : std::string_view();
     };
 
-    response.set_sender(std::move(sender));
+    const FileRequestHeaders request_headers{
+            get_header(constants::well_known_header::IF_NONE_MATCH),
+            get_header(constants::well_known_header::IF_MODIFIED_SINCE),
+            get_header(constants::well_known_header::RANGE),
+            get_header(constants::well_known_header::IF_RANGE),
+            get_header(constants::well_known_header::ACCEPT_ENCODING),
+    };
+
+    return serve_file(request.get_request_line().get_method(),
+                      request.get_request_line().get_version(),
+                      request.get_request_line().get_url(),
+                      request_headers,
+                      request.get_memory_resource());
+}
+
+HttpResponse BasicStaticServer::on_request_view(const HttpRequestView &request) {
+    const FileRequestHeaders request_headers{
+            request.get_header(constants::well_known_header::IF_NONE_MATCH),
+            request.get_header(constants::well_known_header::IF_MODIFIED_SINCE),
+            request.get_header(constants::well_known_header::RANGE),
+            request.get_header(constants::well_known_header::IF_RANGE),
+            request.get_header(constants::well_known_header::ACCEPT_ENCODING),
+    };
+
+    if (request.is_path_encoded()) {
+        return serve_file(request.get_method(), request.get_version(), request.decode_path(), request_headers,
+                          request.get_memory_resource());
+    }
+    return serve_file(request.get_method(), request.get_version(), request.get_path(), request_headers,
+                      request.get_memory_resource());
+}
+
+const FileCache &BasicStaticServer::get_file_cache() const noexcept {
+    return file_cache_;
+}
+
+HttpResponse BasicStaticServer::serve_file(constants::http_method method, constants::http_version http_version,
+                                           std::string_view url, const FileRequestHeaders &request_headers,
+                                           std::pmr::memory_resource *resource) {
+    if (method != constants::http_method::HEAD
+        && method != constants::http_method::GET) {
+        return HttpResponse(constants::http_response_status::MethodNotAllowed, http_version, resource);
+    }
+
+    auto[status, file] = file_cache_.lookup(url);
+    if (status != constants::http_response_status::OK) {
+        return HttpResponse(status, http_version, resource);
+    }
+
+    if (file->gzip_variant && is_gzip_accepted(request_headers.accept_encoding)) {
+        file = file->gzip_variant;
+    }
+
+    if (is_not_modified(*file, request_headers.if_none_match, request_headers.if_modified_since)) {
+        HttpResponse response(constants::http_response_status::NotModified, http_version, resource);
+        set_file_sender(response, FileSender{&file_cache_, file, file->validator_headers, 0, 0});
+        return response;
+    }
+
+    // nickeskov: Range is defined only for GET, RFC 7233, 3.1
+    ByteRange byte_range{0, file->size};
+    auto byte_range_status = range_status::NONE;
+
+    if (method == constants::http_method::GET && !request_headers.range.empty()
+        && is_range_applicable(*file, request_headers.if_range)) {
+        byte_range_status = parse_byte_range(request_headers.range, file->size, byte_range);
+    }
+
+    if (byte_range_status == range_status::UNSATISFIABLE) {
+        HttpResponse response(constants::http_response_status::RequestedRangeNotSatisfiable, http_version, resource);
+        response.get_headers().emplace(constants::headers::content_range, format_unsatisfied_range(file->size));
+        return response;
+    }
+
+    if (byte_range_status == range_status::SATISFIABLE) {
+        HttpResponse response(constants::http_response_status::PartialContent, http_version, resource);
+
+        auto &headers = response.get_headers();
+        headers.emplace(constants::headers::content_length, std::to_string(byte_range.length));
+        headers.emplace(constants::headers::content_type, file->mime_type);
+        if (!file->content_encoding.empty()) {
+            headers.emplace(constants::headers::content_encoding, file->content_encoding);
+        }
+        headers.emplace(constants::headers::content_range, format_content_range(byte_range, file->size));
+
+        set_file_sender(response, FileSender{&file_cache_, file, file->validator_headers,
+                                             byte_range.first, byte_range.length});
+        return response;
+    }
+
+    HttpResponse response(constants::http_response_status::OK, http_version, resource);
+
+    // nickeskov: if head request response must have empty body
+    const size_t content_length = method == constants::http_method::HEAD ? 0 : file->size;
+
+    // nickeskov: entity headers are preformatted in cache entry, so they are not copied into headers map
+    set_file_sender(response, FileSender{&file_cache_, file, file->headers, 0, content_length});
 
     return response;
 }
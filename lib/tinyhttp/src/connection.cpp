@@ -3,6 +3,7 @@
 #include "tinyhttp/utils.h"
 
 #include <string>
+#include <algorithm>
 
 extern "C" {
 #include <sys/socket.h>
@@ -139,9 +140,40 @@ bool Connection::is_readable() const noexcept {
     return is_readable_;
 }
 
+bool Connection::is_edge_triggered() const noexcept {
+    return is_edge_triggered_;
+}
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+Connection::IoAwaiter Connection::wait_io() noexcept {
+    return IoAwaiter(*this);
+}
+
+bool Connection::has_io_waiter() const noexcept {
+    return static_cast<bool>(io_waiter_);
+}
+
+void Connection::resume_io_waiter() {
+    std::exchange(io_waiter_, nullptr).resume();
+}
+
+void Connection::cancel_io_waiter(const std::exception_ptr &io_error) {
+    io_error_ = io_error;
+    resume_io_waiter();
+}
+
+#endif
+
 void Connection::close() {
     if (is_opened()) {
         int sock_fd = sock_fd_.data();
+
+        // nickeskov: fd may be reused by next connection, so poller drops data received for this one
+        if (poller_ != nullptr) {
+            poller_->forget(sock_fd);
+        }
+
         int status = ::shutdown(sock_fd, SHUT_RDWR);
 
         if (sock_fd_.close() < 0) {
@@ -201,6 +233,30 @@ ssize_t Connection::write(const void *buf, size_t len) {
     return bytes_written;
 }
 
+ssize_t Connection::writev(const iovec *iov, size_t iovcnt, int flags) {
+    if (!is_opened()) {
+        throw errors::ClosedEndpointError("write to closed endpoint, sock_fd="
+                                          + std::to_string(sock_fd_.data()));
+    }
+
+    // nickeskov: sendmsg instead of ::writev, because MSG_NOSIGNAL needed to prevent SIGPIPE
+    msghdr message{};
+    message.msg_iov = const_cast<iovec *>(iov);
+    message.msg_iovlen = iovcnt;
+
+    ssize_t bytes_written = ::sendmsg(sock_fd_.data(), &message, flags | MSG_NOSIGNAL);
+
+    if (bytes_written == -1
+        && errno != EAGAIN
+        && errno != EWOULDBLOCK) {
+
+        throw errors::WriteError(
+                "writev error occurs while writing to endpoint, sock_fd="
+                + std::to_string(sock_fd_.data()));
+    }
+    return bytes_written;
+}
+
 ssize_t Connection::read(void *buf, size_t len) {
     if (!is_opened()) {
         throw errors::ClosedEndpointError("write to closed endpoint, sock_fd="
@@ -209,7 +265,9 @@ ssize_t Connection::read(void *buf, size_t len) {
 
     ssize_t bytes_read = 0;
     if (len != 0) {
-        bytes_read = ::recv(sock_fd_.data(), buf, len, MSG_NOSIGNAL);
+        bytes_read = poller_ != nullptr
+                     ? poller_->recv(sock_fd_.data(), buf, len)
+                     : ::recv(sock_fd_.data(), buf, len, MSG_NOSIGNAL);
         if (bytes_read == 0) {
             is_readable_ = false;
         }
@@ -234,16 +292,20 @@ const std::string &Connection::get_io_buffer() const noexcept {
 }
 
 ssize_t Connection::read_in_io_buff(size_t len) {
-    tmp_read_buffer_.clear();
-    tmp_read_buffer_.resize(len);
+    const size_t old_size = io_buffer_.size();
 
-    ssize_t bytes_read = read(tmp_read_buffer_.data(), len);
-    if (bytes_read <= 0) {
-        return bytes_read;
+    // nickeskov: read directly into io buffer tail without temporary buffer
+    io_buffer_.resize(old_size + len);
+
+    ssize_t bytes_read = 0;
+    try {
+        bytes_read = read(io_buffer_.data() + old_size, len);
+    } catch (...) {
+        io_buffer_.resize(old_size);
+        throw;
     }
 
-    tmp_read_buffer_.resize(bytes_read);
-    io_buffer_ += tmp_read_buffer_;
+    io_buffer_.resize(old_size + std::max<ssize_t>(bytes_read, 0));
 
     return bytes_read;
 }
@@ -257,7 +319,7 @@ ssize_t Connection::write_from_io_buff(size_t len) {
         return bytes_written;
     }
 
-    io_buffer_.erase(0, len);
+    io_buffer_.erase(0, bytes_written);
     return bytes_written;
 }
 
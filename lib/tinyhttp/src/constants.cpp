@@ -1,110 +1,278 @@
 #include "tinyhttp/constants.h"
+#include "tinyhttp/utils.h"
 
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
 
 namespace tinyhttp::constants {
 
 namespace {
 
-const std::unordered_map<http_response_status, std::string_view> http_response_status_text = {
-        {http_response_status::Continue,                      "Continue"},
-        {http_response_status::SwitchingProtocols,            "Switching Protocols"},
-        {http_response_status::Processing,                    "Processing"},
-        {http_response_status::EarlyHints,                    "Early Hints"},
-
-        {http_response_status::OK,                            "OK"},
-        {http_response_status::Created,                       "Created"},
-        {http_response_status::Accepted,                      "Accepted"},
-        {http_response_status::NonAuthoritativeInfo,          "Non-Authoritative Information"},
-        {http_response_status::NoContent,                     "No Content"},
-        {http_response_status::ResetContent,                  "Reset Content"},
-        {http_response_status::PartialContent,                "Partial Content"},
-        {http_response_status::MultiStatus,                   "Multi-Status"},
-        {http_response_status::AlreadyReported,               "Already Reported"},
-        {http_response_status::IMUsed,                        "IM Used"},
-
-        {http_response_status::MultipleChoices,               "Multiple Choices"},
-        {http_response_status::MovedPermanently,              "Moved Permanently"},
-        {http_response_status::Found,                         "Found"},
-        {http_response_status::SeeOther,                      "See Other"},
-        {http_response_status::NotModified,                   "Not Modified"},
-        {http_response_status::UseProxy,                      "Use Proxy"},
-        {http_response_status::TemporaryRedirect,             "Temporary Redirect"},
-        {http_response_status::PermanentRedirect,             "Permanent Redirect"},
-
-        {http_response_status::BadRequest,                    "Bad Request"},
-        {http_response_status::Unauthorized,                  "Unauthorized"},
-        {http_response_status::PaymentRequired,               "Payment Required"},
-        {http_response_status::Forbidden,                     "Forbidden"},
-        {http_response_status::NotFound,                      "Not Found"},
-        {http_response_status::MethodNotAllowed,              "Method Not Allowed"},
-        {http_response_status::NotAcceptable,                 "Not Acceptable"},
-        {http_response_status::ProxyAuthRequired,             "Proxy Authentication Required"},
-        {http_response_status::RequestTimeout,                "Request Timeout"},
-        {http_response_status::Conflict,                      "Conflict"},
-        {http_response_status::Gone,                          "Gone"},
-        {http_response_status::LengthRequired,                "Length Required"},
-        {http_response_status::PreconditionFailed,            "Precondition Failed"},
-        {http_response_status::RequestEntityTooLarge,         "Request Entity Too Large"},
-        {http_response_status::RequestURITooLong,             "Request URI Too Long"},
-        {http_response_status::UnsupportedMediaType,          "Unsupported Media Type"},
-        {http_response_status::RequestedRangeNotSatisfiable,  "Requested Range Not Satisfiable"},
-        {http_response_status::ExpectationFailed,             "Expectation Failed"},
-        {http_response_status::Teapot,                        "I'm a teapot"},
-        {http_response_status::MisdirectedRequest,            "Misdirected Request"},
-        {http_response_status::UnprocessableEntity,           "Unprocessable Entity"},
-        {http_response_status::Locked,                        "Locked"},
-        {http_response_status::FailedDependency,              "Failed Dependency"},
-        {http_response_status::TooEarly,                      "Too Early"},
-        {http_response_status::UpgradeRequired,               "Upgrade Required"},
-        {http_response_status::PreconditionRequired,          "Precondition Required"},
-        {http_response_status::TooManyRequests,               "Too Many Requests"},
-        {http_response_status::RequestHeaderFieldsTooLarge,   "Request Header Fields Too Large"},
-        {http_response_status::UnavailableForLegalReasons,    "Unavailable For Legal Reasons"},
-
-        {http_response_status::InternalServerError,           "Internal Server Error"},
-        {http_response_status::NotImplemented,                "Not Implemented"},
-        {http_response_status::BadGateway,                    "Bad Gateway"},
-        {http_response_status::ServiceUnavailable,            "Service Unavailable"},
-        {http_response_status::GatewayTimeout,                "Gateway Timeout"},
-        {http_response_status::HTTPVersionNotSupported,       "HTTP Version Not Supported"},
-        {http_response_status::VariantAlsoNegotiates,         "Variant Also Negotiates"},
-        {http_response_status::InsufficientStorage,           "Insufficient Storage"},
-        {http_response_status::LoopDetected,                  "Loop Detected"},
-        {http_response_status::NotExtended,                   "Not Extended"},
-        {http_response_status::NetworkAuthenticationRequired, "Network Authentication Required"},
-};
-
-const std::unordered_map<http_method, std::string_view> http_method_text = {
-        {http_method::GET,     "GET"},
-        {http_method::HEAD,    "HEAD"},
-        {http_method::POST,    "POST"},
-        {http_method::PUT,     "PUT"},
-        {http_method::DELETE,  "DELETE"},
-        {http_method::CONNECT, "CONNECT"},
-        {http_method::OPTIONS, "OPTIONS"},
-        {http_method::TRACE,   "TRACE"},
-};
-
-const std::unordered_map<std::string_view, http_method> http_method_code = {
-        {"GET",     http_method::GET},
-        {"HEAD",    http_method::HEAD,},
-        {"POST",    http_method::POST},
-        {"PUT",     http_method::PUT},
-        {"DELETE",  http_method::DELETE},
-        {"CONNECT", http_method::CONNECT},
-        {"OPTIONS", http_method::OPTIONS},
-        {"TRACE",   http_method::TRACE},
-};
+constexpr std::string_view http_method_GET_text = "GET";
+constexpr std::string_view http_method_HEAD_text = "HEAD";
+constexpr std::string_view http_method_POST_text = "POST";
+constexpr std::string_view http_method_PUT_text = "PUT";
+constexpr std::string_view http_method_DELETE_text = "DELETE";
+constexpr std::string_view http_method_CONNECT_text = "CONNECT";
+constexpr std::string_view http_method_OPTIONS_text = "OPTIONS";
+constexpr std::string_view http_method_TRACE_text = "TRACE";
 
 constexpr std::string_view http_version_V0_9_text = "0.9";
 constexpr std::string_view http_version_V1_0_text = "1.0";
 constexpr std::string_view http_version_V1_1_text = "1.1";
 
+constexpr std::array<std::string_view, WELL_KNOWN_HEADERS_COUNT> well_known_header_text = {
+        std::string_view(),
+        headers::server,
+        headers::date,
+        headers::connection,
+        headers::content_type,
+        headers::content_length,
+        headers::content_range,
+        headers::accept_ranges,
+        headers::range,
+        headers::if_range,
+        headers::etag,
+        headers::last_modified,
+        headers::if_none_match,
+        headers::if_modified_since,
+        headers::accept_encoding,
+        headers::content_encoding,
+        headers::vary,
+        headers::allow,
+        headers::transfer_encoding,
+};
+
+constexpr size_t get_max_well_known_header_size() noexcept {
+    size_t max_size = 0;
+    for (const auto text : well_known_header_text) {
+        max_size = std::max(max_size, text.size());
+    }
+    return max_size;
+}
+
+constexpr size_t WELL_KNOWN_HEADER_GROUPS_COUNT = get_max_well_known_header_size() + 1;
+
+constexpr size_t MAX_WELL_KNOWN_HEADERS_WITH_SAME_SIZE = 4;
+
+using well_known_header_group_t = std::array<well_known_header, MAX_WELL_KNOWN_HEADERS_WITH_SAME_SIZE>;
+
+// nickeskov: headers are grouped by name length, so lookup compares name with one or few candidates.
+//  Group overflow is out of bounds access, so it fails compilation of constexpr table
+constexpr std::array<well_known_header_group_t, WELL_KNOWN_HEADER_GROUPS_COUNT> make_well_known_header_groups() {
+    std::array<well_known_header_group_t, WELL_KNOWN_HEADER_GROUPS_COUNT> groups{};
+    std::array<size_t, WELL_KNOWN_HEADER_GROUPS_COUNT> sizes{};
+
+    for (size_t i = 1; i < well_known_header_text.size(); ++i) {
+        const auto size = well_known_header_text[i].size();
+        groups[size][sizes[size]++] = static_cast<well_known_header>(i);
+    }
+
+    return groups;
+}
+
+constexpr auto well_known_header_groups = make_well_known_header_groups();
+
 }
 
 std::string_view get_http_response_status_text(http_response_status status) {
-    return http_response_status_text.at(status);
+    // nickeskov: switch over dense enum values is compiled into jump table
+    switch (status) {
+        case http_response_status::Continue: {
+            return "Continue";
+        }
+        case http_response_status::SwitchingProtocols: {
+            return "Switching Protocols";
+        }
+        case http_response_status::Processing: {
+            return "Processing";
+        }
+        case http_response_status::EarlyHints: {
+            return "Early Hints";
+        }
+
+        case http_response_status::OK: {
+            return "OK";
+        }
+        case http_response_status::Created: {
+            return "Created";
+        }
+        case http_response_status::Accepted: {
+            return "Accepted";
+        }
+        case http_response_status::NonAuthoritativeInfo: {
+            return "Non-Authoritative Information";
+        }
+        case http_response_status::NoContent: {
+            return "No Content";
+        }
+        case http_response_status::ResetContent: {
+            return "Reset Content";
+        }
+        case http_response_status::PartialContent: {
+            return "Partial Content";
+        }
+        case http_response_status::MultiStatus: {
+            return "Multi-Status";
+        }
+        case http_response_status::AlreadyReported: {
+            return "Already Reported";
+        }
+        case http_response_status::IMUsed: {
+            return "IM Used";
+        }
+
+        case http_response_status::MultipleChoices: {
+            return "Multiple Choices";
+        }
+        case http_response_status::MovedPermanently: {
+            return "Moved Permanently";
+        }
+        case http_response_status::Found: {
+            return "Found";
+        }
+        case http_response_status::SeeOther: {
+            return "See Other";
+        }
+        case http_response_status::NotModified: {
+            return "Not Modified";
+        }
+        case http_response_status::UseProxy: {
+            return "Use Proxy";
+        }
+        case http_response_status::TemporaryRedirect: {
+            return "Temporary Redirect";
+        }
+        case http_response_status::PermanentRedirect: {
+            return "Permanent Redirect";
+        }
+
+        case http_response_status::BadRequest: {
+            return "Bad Request";
+        }
+        case http_response_status::Unauthorized: {
+            return "Unauthorized";
+        }
+        case http_response_status::PaymentRequired: {
+            return "Payment Required";
+        }
+        case http_response_status::Forbidden: {
+            return "Forbidden";
+        }
+        case http_response_status::NotFound: {
+            return "Not Found";
+        }
+        case http_response_status::MethodNotAllowed: {
+            return "Method Not Allowed";
+        }
+        case http_response_status::NotAcceptable: {
+            return "Not Acceptable";
+        }
+        case http_response_status::ProxyAuthRequired: {
+            return "Proxy Authentication Required";
+        }
+        case http_response_status::RequestTimeout: {
+            return "Request Timeout";
+        }
+        case http_response_status::Conflict: {
+            return "Conflict";
+        }
+        case http_response_status::Gone: {
+            return "Gone";
+        }
+        case http_response_status::LengthRequired: {
+            return "Length Required";
+        }
+        case http_response_status::PreconditionFailed: {
+            return "Precondition Failed";
+        }
+        case http_response_status::RequestEntityTooLarge: {
+            return "Request Entity Too Large";
+        }
+        case http_response_status::RequestURITooLong: {
+            return "Request URI Too Long";
+        }
+        case http_response_status::UnsupportedMediaType: {
+            return "Unsupported Media Type";
+        }
+        case http_response_status::RequestedRangeNotSatisfiable: {
+            return "Requested Range Not Satisfiable";
+        }
+        case http_response_status::ExpectationFailed: {
+            return "Expectation Failed";
+        }
+        case http_response_status::Teapot: {
+            return "I'm a teapot";
+        }
+        case http_response_status::MisdirectedRequest: {
+            return "Misdirected Request";
+        }
+        case http_response_status::UnprocessableEntity: {
+            return "Unprocessable Entity";
+        }
+        case http_response_status::Locked: {
+            return "Locked";
+        }
+        case http_response_status::FailedDependency: {
+            return "Failed Dependency";
+        }
+        case http_response_status::TooEarly: {
+            return "Too Early";
+        }
+        case http_response_status::UpgradeRequired: {
+            return "Upgrade Required";
+        }
+        case http_response_status::PreconditionRequired: {
+            return "Precondition Required";
+        }
+        case http_response_status::TooManyRequests: {
+            return "Too Many Requests";
+        }
+        case http_response_status::RequestHeaderFieldsTooLarge: {
+            return "Request Header Fields Too Large";
+        }
+        case http_response_status::UnavailableForLegalReasons: {
+            return "Unavailable For Legal Reasons";
+        }
+
+        case http_response_status::InternalServerError: {
+            return "Internal Server Error";
+        }
+        case http_response_status::NotImplemented: {
+            return "Not Implemented";
+        }
+        case http_response_status::BadGateway: {
+            return "Bad Gateway";
+        }
+        case http_response_status::ServiceUnavailable: {
+            return "Service Unavailable";
+        }
+        case http_response_status::GatewayTimeout: {
+            return "Gateway Timeout";
+        }
+        case http_response_status::HTTPVersionNotSupported: {
+            return "HTTP Version Not Supported";
+        }
+        case http_response_status::VariantAlsoNegotiates: {
+            return "Variant Also Negotiates";
+        }
+        case http_response_status::InsufficientStorage: {
+            return "Insufficient Storage";
+        }
+        case http_response_status::LoopDetected: {
+            return "Loop Detected";
+        }
+        case http_response_status::NotExtended: {
+            return "Not Extended";
+        }
+        case http_response_status::NetworkAuthenticationRequired: {
+            return "Network Authentication Required";
+        }
+        default: {
+            throw std::out_of_range("unknown http response status");
+        }
+    }
 }
 
 std::string_view get_http_version_text(http_version version) noexcept {
@@ -147,17 +315,107 @@ http_version get_http_version_code(std::string_view version_text) noexcept {
 }
 
 std::string_view get_http_method_text(http_method method) {
-    return http_method_text.at(method);
+    switch (method) {
+        case http_method::GET: {
+            return http_method_GET_text;
+        }
+        case http_method::HEAD: {
+            return http_method_HEAD_text;
+        }
+        case http_method::POST: {
+            return http_method_POST_text;
+        }
+        case http_method::PUT: {
+            return http_method_PUT_text;
+        }
+        case http_method::DELETE: {
+            return http_method_DELETE_text;
+        }
+        case http_method::CONNECT: {
+            return http_method_CONNECT_text;
+        }
+        case http_method::OPTIONS: {
+            return http_method_OPTIONS_text;
+        }
+        case http_method::TRACE: {
+            return http_method_TRACE_text;
+        }
+        case http_method::UNSUPPORTED_: // fallthrough
+        default: {
+            throw std::out_of_range("unknown http method");
+        }
+    }
 }
 
+// nickeskov: methods are case sensitive and differ by length, so one comparison is enough for most of them
 http_method get_http_method_code(std::string_view method_text) noexcept {
     http_method method = http_method::UNSUPPORTED_;
 
-    if (http_method_code.count(method_text) > 0) {
-        method = http_method_code.at(method_text);
+    switch (method_text.size()) {
+        case http_method_GET_text.size(): { // PUT has the same size
+            if (method_text == http_method_GET_text) {
+                method = http_method::GET;
+            } else if (method_text == http_method_PUT_text) {
+                method = http_method::PUT;
+            }
+            break;
+        }
+        case http_method_POST_text.size(): { // HEAD has the same size
+            if (method_text == http_method_POST_text) {
+                method = http_method::POST;
+            } else if (method_text == http_method_HEAD_text) {
+                method = http_method::HEAD;
+            }
+            break;
+        }
+        case http_method_TRACE_text.size(): {
+            if (method_text == http_method_TRACE_text) {
+                method = http_method::TRACE;
+            }
+            break;
+        }
+        case http_method_DELETE_text.size(): {
+            if (method_text == http_method_DELETE_text) {
+                method = http_method::DELETE;
+            }
+            break;
+        }
+        case http_method_OPTIONS_text.size(): { // CONNECT has the same size
+            if (method_text == http_method_OPTIONS_text) {
+                method = http_method::OPTIONS;
+            } else if (method_text == http_method_CONNECT_text) {
+                method = http_method::CONNECT;
+            }
+            break;
+        }
+        default: {
+            break;
+        }
     }
 
     return method;
 }
 
+std::string_view get_well_known_header_text(well_known_header header) noexcept {
+    const auto index = static_cast<size_t>(header);
+    return index < well_known_header_text.size() ? well_known_header_text[index] : std::string_view();
+}
+
+well_known_header get_well_known_header(std::string_view header_text) noexcept {
+    if (header_text.size() >= well_known_header_groups.size()) {
+        return well_known_header::UNKNOWN_;
+    }
+
+    for (const auto header : well_known_header_groups[header_text.size()]) {
+        if (header == well_known_header::UNKNOWN_) {
+            break;
+        }
+        if (utils::iequals(header_text, well_known_header_text[static_cast<size_t>(header)])) {
+            return header;
+        }
+    }
+
+    return well_known_header::UNKNOWN_;
+}
+
 }
@@ -2,18 +2,24 @@
 #include "tinyhttp/errors.h"
 #include "tinyhttp/utils.h"
 #include "tinyhttp/constants.h"
-#include "tinyhttp/http_request_line.h"
-#include "tinyhttp/http_headers.h"
-#include "tinyhttp/http_request.h"
+#include "tinyhttp/http_request_parser.h"
+#include "tinyhttp/http_request_view.h"
 #include "tinyhttp/http_response.h"
+#include "tinyhttp/iovec_writer.h"
 
 #include "coroutine/coroutine.h"
+#include "unixprimwrap/errors.h"
 
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <cerrno>
 #include <cstring>
 #include <exception>
+#include <memory>
+#include <stdexcept>
 
 extern "C" {
 #include <sys/socket.h>
@@ -27,76 +33,102 @@ using namespace std::literals::string_literals;
 
 namespace {
 
-int epoll_act(int epoll_fd, int act, int fd, uint32_t events);
+constexpr uint32_t SHARED_ACCEPTOR_EVENTS = EPOLLIN | EPOLLEXCLUSIVE;
+constexpr uint32_t OWN_ACCEPTOR_EVENTS = EPOLLIN;
+constexpr size_t MAX_READ_BYTES_PER_CALL = 2048;
+constexpr size_t MAX_DRAIN_READ_BYTES_PER_CALL = 65536;
+constexpr std::chrono::milliseconds TIMER_WHEEL_TICK(10);
+constexpr size_t CHUNK_SIZE_LINE_CAPACITY = 2 * sizeof(size_t) + 2; // nickeskov: hex digits and CRLF
+
+// nickeskov: chunk size line is formatted in caller storage, it must be alive until writer is flushed
+using chunk_size_line_t = std::array<char, CHUNK_SIZE_LINE_CAPACITY>;
 
-int epoll_add(int epoll_fd, int fd, uint32_t events);
+// nickeskov: negative timeout means infinite one
+inline int min_timeout(int lhs, int rhs) noexcept {
+    if (lhs < 0) {
+        return rhs;
+    }
+    if (rhs < 0) {
+        return lhs;
+    }
+    return std::min(lhs, rhs);
+}
 
-int epoll_mod(int epoll_fd, int fd, uint32_t new_events);
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+Task<> send_http_response_async(Connection &connection, const HttpResponse &response);
+#else
+void send_http_response(Connection &connection, const HttpResponse &response);
+#endif
 
-//int epoll_del(int epoll_fd, int fd);
+void append_body_part(IovecWriter &writer, chunk_size_line_t &size_line, std::string_view part, bool is_chunked);
 
-constexpr uint32_t ACCEPTOR_EVENTS = EPOLLIN | EPOLLEXCLUSIVE;
-constexpr size_t MAX_ACCEPTIONS_PER_LOOP = 1;
-constexpr size_t MAX_READ_BYTES_PER_CALL = 2048;
-constexpr size_t MAX_WRITE_BYTES_PER_CALL = 2048;
+bool has_sender(const HttpResponse &response) noexcept;
 
-std::string_view read_body(Connection &connection, size_t start_pos, ssize_t body_len);
+bool is_produced_body_sent(const HttpResponse &response) noexcept;
 
-size_t read_until_headers_end(Connection &connection);
+size_t read_size_per_call(const Connection &connection, size_t expected_size);
 
-HttpRequest read_http_request(Connection &connection);
+bool is_keepalive_requested(const HttpRequestView &request);
 
-void send_http_response(Connection &connection, const HttpResponse &response);
+bool is_body_allowed(constants::http_response_status status) noexcept;
 
 }
 
 
 EpollWorker::EpollWorker(int worker_id, Server &server)
-        : worker_id_(worker_id), server_(server), logger_(server.get_logger()), epoll_fd_(epoll_create(1)) {
-
-    if (!epoll_fd_.is_valid()) {
-        throw errors::EpollCreateError("cannot create epoll entity: "s + strerror(errno));
-    }
+        : EpollWorker(worker_id, server, unixprimwrap::Descriptor()) {}
 
-    // add server socket to epoll
-    const int srv_status = epoll_add(epoll_fd_.data(),
-                                     server_.get_acceptor_service().data(),
-                                     ACCEPTOR_EVENTS);
-
-    if (srv_status < 0) {
-        throw errors::EpollAddError(
-                "cannot add to epoll server socket: "s + std::strerror(errno));
-    }
-}
+EpollWorker::EpollWorker(int worker_id, Server &server, unixprimwrap::Descriptor &&acceptor_service)
+        : worker_id_(worker_id), server_(server), logger_(server.get_logger()),
+          own_acceptor_service_(std::move(acceptor_service)),
+          basic_acceptor_service_(own_acceptor_service_.is_valid()
+                                  ? own_acceptor_service_.data()
+                                  : server.get_acceptor_service().data()),
+          timers_(TIMER_WHEEL_TICK, clock_t::now()) {}
 
 bool EpollWorker::add_to_event_loop(Connection &&connection, uint32_t events) {
     auto conn_io_service = connection.get_io_service().data();
 
-    auto client = Client{std::move(connection), events};
+    auto client = std::make_unique<Client>(std::move(connection), events, cfg_.request_arena_size,
+                                           server_.get_allocation_counter());
+    const auto client_index = static_cast<size_t>(conn_io_service);
 
     try {
-        clients_.emplace(conn_io_service, std::move(client));
+        if (clients_.size() <= client_index) {
+            clients_.resize(client_index + 1);
+        }
     } catch (std::exception &) {
-        // Fallback if emplace fails
-        connection = std::move(client.connection);
+        // Fallback if resize fails
+        connection = std::move(client->connection);
         throw;
     }
 
-    if (epoll_fd_.is_valid()
-        && epoll_add(epoll_fd_.data(), conn_io_service, events) < 0) {
+    clients_[client_index] = std::move(client);
+
+    if (poller_ && poller_->add_receiver(conn_io_service, events) < 0) {
         // Fallback if epoll_ctl fails
-        connection = std::move(clients_.at(conn_io_service).connection);
-        clients_.erase(conn_io_service);
+        connection = std::move(clients_[client_index]->connection);
+        clients_[client_index].reset();
         return false;
     }
+
+    clients_[client_index]->connection.poller_ = poller_.get();
     return true;
 }
 
+EpollWorker::Client &EpollWorker::get_client(EpollWorker::basic_io_service_t basic_io_service) {
+    const auto client_index = static_cast<size_t>(basic_io_service);
+
+    if (basic_io_service < 0 || client_index >= clients_.size() || !clients_[client_index]) {
+        throw std::out_of_range("no client with io_service=" + std::to_string(basic_io_service));
+    }
+    return *clients_[client_index];
+}
+
 bool EpollWorker::change_event(EpollWorker::Client &client, uint32_t epoll_events) {
     int conn_io_service = client.connection.get_io_service().data();
 
-    if (epoll_fd_.is_valid()
-        && epoll_mod(epoll_fd_.data(), conn_io_service, epoll_events) < 0) {
+    if (poller_ && poller_->modify(conn_io_service, epoll_events) < 0) {
         return false;
     }
 
@@ -105,27 +137,116 @@ bool EpollWorker::change_event(EpollWorker::Client &client, uint32_t epoll_event
 }
 
 void EpollWorker::close_connection(EpollWorker::basic_io_service_t basic_io_service) {
-    const auto &client = clients_.at(basic_io_service);
+    const auto &client = get_client(basic_io_service);
 
     const auto dst_addr = client.connection.dst_addr_;
     const auto dst_port = client.connection.dst_port_;
 
-    clients_.erase(basic_io_service);
+    if (poller_) {
+        poller_->forget(basic_io_service);
+    }
+    clients_[basic_io_service].reset();
+    timers_.cancel(basic_io_service);
+
     logger_.info("[worker " + std::to_string(worker_id_) + "] " +
                  "Disconnect with " + dst_addr + ":" + std::to_string(dst_port)
                  + " [io_service=" + std::to_string(basic_io_service) + "]");
 }
 
-void EpollWorker::accept_connections(size_t max_count) {
-    sockaddr_in client_addr{};
-    socklen_t addr_size = sizeof(client_addr);
+void EpollWorker::kill_client(EpollWorker::basic_io_service_t basic_io_service,
+                              const std::exception_ptr &killer_exception) {
+    try {
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+        // nickeskov: exception ends client task, which is destroyed with connection
+        auto &connection = get_client(basic_io_service).connection;
+        if (connection.has_io_waiter()) {
+            connection.cancel_io_waiter(killer_exception);
+        }
+#else
+        coroutine::kill(basic_io_service, killer_exception);
+#endif
+    } catch (errors::RuntimeError &) {
+        // ignored
+    }
+    close_connection(basic_io_service);
+}
+
+void EpollWorker::set_phase(EpollWorker::Client &client, EpollWorker::client_phase phase,
+                            EpollWorker::clock_t::time_point now) {
+    const auto basic_io_service = client.connection.get_io_service().data();
+    const int timeout = get_phase_timeout(phase);
+
+    client.phase = phase;
+
+    if (timeout < 0) {
+        timers_.cancel(basic_io_service);
+    } else {
+        timers_.schedule(basic_io_service, now + std::chrono::milliseconds(timeout));
+    }
+}
+
+int EpollWorker::get_phase_timeout(EpollWorker::client_phase phase) const noexcept {
+    switch (phase) {
+        case client_phase::IDLE: {
+            return cfg_.keepalive_timeout;
+        }
+        case client_phase::HEADERS: {
+            return cfg_.header_timeout;
+        }
+        case client_phase::BODY: {
+            return cfg_.body_timeout;
+        }
+        case client_phase::WRITE: {
+            return cfg_.write_timeout;
+        }
+        default: {
+            return -1;
+        }
+    }
+}
+
+void EpollWorker::close_expired_connections(EpollWorker::clock_t::time_point now) {
+    expired_clients_.clear();
+    timers_.expire(now, expired_clients_);
+
+    for (auto basic_io_service : expired_clients_) {
+        std::string reason;
+        switch (get_client(basic_io_service).phase) {
+            case client_phase::IDLE: {
+                reason = "keep-alive timeout";
+                break;
+            }
+            case client_phase::HEADERS: {
+                reason = "request headers timeout";
+                break;
+            }
+            case client_phase::BODY: {
+                reason = "request body timeout";
+                break;
+            }
+            case client_phase::WRITE: {
+                reason = "response write timeout";
+                break;
+            }
+        }
+
+        logger_.info("[worker " + std::to_string(worker_id_) + "] " + reason
+                     + " [io_service=" + std::to_string(basic_io_service) + "]");
 
-    const int basic_acceptor_service = server_.get_acceptor_service().data();
+        kill_client(basic_io_service, std::make_exception_ptr(errors::TimeoutError(reason)));
+    }
+}
+
+void EpollWorker::accept_connections(int max_count) {
+    for (int i = 0; (max_count < 0 || i < max_count) && !server_.is_stopped(); ++i) {
+        sockaddr_in client_addr{};
+        socklen_t addr_size = sizeof(client_addr);
 
-    for (size_t i = 0; i < max_count && !server_.is_stopped(); ++i) {
+        // nickeskov: poller accepts like accept4 with SOCK_NONBLOCK, so there are no additional fcntl calls.
+        //  io_uring poller returns connections accepted in advance by multishot accept without syscall
         unixprimwrap::Descriptor client_fd{
-                ::accept(
-                        basic_acceptor_service,
+                poller_->accept(
+                        basic_acceptor_service_,
                         reinterpret_cast<sockaddr *>(&client_addr),
                         &addr_size
                 )
@@ -141,15 +262,10 @@ void EpollWorker::accept_connections(size_t max_count) {
                 } else {
                     throw errors::AcceptError(
                             "cannot accept new connection, server_sock_fd="
-                            + std::to_string(basic_acceptor_service));
+                            + std::to_string(basic_acceptor_service_));
                 }
             }
         }
-        if (utils::set_nonblock(client_fd.data(), true) < 0) {
-            throw errors::AcceptError(
-                    "cannot cannot set nonblock for new connection, server_sock_fd="
-                    + std::to_string(basic_acceptor_service));
-        }
 
         char buff[INET_ADDRSTRLEN];
 
@@ -161,13 +277,23 @@ void EpollWorker::accept_connections(size_t max_count) {
         const basic_io_service_t client_conn_io_service = client_fd.data();
 
         auto connection = Connection(std::move(client_fd), std::move(dst_addr), dst_port);
+        connection.is_edge_triggered_ = cfg_.edge_triggered;
 
         const std::string client_dst_addr = connection.get_dst_addr();
         const uint32_t client_dst_port = connection.get_dst_port();
 
-        add_to_event_loop(std::move(connection), EPOLLIN);
+        if (!add_to_event_loop(std::move(connection), EPOLLIN | client_events_flags_)) {
+            continue;
+        }
+
+        set_phase(get_client(client_conn_io_service), client_phase::HEADERS, clock_t::now());
 
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+        auto &client = get_client(client_conn_io_service);
+        client.task = client_task(client);
+#else
         coroutine::create(client_conn_io_service, &EpollWorker::client_routine, this);
+#endif
 
         logger_.info("[worker " + std::to_string(worker_id_) + "] " +
                      "Accepted new connection from " + client_dst_addr + ":" +
@@ -177,16 +303,46 @@ void EpollWorker::accept_connections(size_t max_count) {
 }
 
 void EpollWorker::event_loop(const Server::EventLoopConfig &cfg) {
-    std::vector<struct epoll_event> fd_events(cfg.epoll_max_events);
+    cfg_ = cfg;
+    client_events_flags_ = cfg.edge_triggered ? static_cast<uint32_t>(EPOLLET) : 0;
+    coroutine::set_stack_pool_config(cfg.client_stacks);
 
-    const int basic_acceptor_service = server_.get_acceptor_service().data();
+    try {
+        poller_ = unixprimwrap::make_poller(cfg.event_backend);
+    } catch (unixprimwrap::errors::PollerError &e) {
+        throw errors::EpollCreateError("cannot create event loop: "s + e.what());
+    }
+
+    // add server socket to event loop
+    const int srv_status = poller_->add_acceptor(basic_acceptor_service_,
+                                                 own_acceptor_service_.is_valid()
+                                                 ? OWN_ACCEPTOR_EVENTS
+                                                 : SHARED_ACCEPTOR_EVENTS);
+
+    if (srv_status < 0) {
+        throw errors::EpollAddError(
+                "cannot add to event loop server socket: "s + std::strerror(errno));
+    }
+
+    if (server_.get_handler_pool() != nullptr
+        && poller_->add(completions_.get_event_service().data(), EPOLLIN) < 0) {
+        throw errors::EpollAddError(
+                "cannot add to event loop handler completions: "s + std::strerror(errno));
+    }
+
+    logger_.info("[worker " + std::to_string(worker_id_) + "] event loop backend: "
+                 + unixprimwrap::to_string(poller_->get_backend()));
+
+    std::vector<struct epoll_event> fd_events(cfg.epoll_max_events);
 
     while (!server_.is_stopped()) {
-        const int loop_events_count = epoll_pwait(epoll_fd_.data(),
-                                                  fd_events.data(),
-                                                  cfg.epoll_max_events,
-                                                  cfg.epoll_timeout,
-                                                  cfg.epoll_sigmask);
+        // nickeskov: wake up not later than next client deadline
+        const int epoll_timeout = min_timeout(cfg.epoll_timeout, timers_.get_timeout(clock_t::now()));
+
+        const int loop_events_count = poller_->wait(fd_events.data(),
+                                                    cfg.epoll_max_events,
+                                                    epoll_timeout,
+                                                    cfg.epoll_sigmask);
 
         if (loop_events_count < 0) {
             if (errno != EINTR) {
@@ -199,13 +355,19 @@ void EpollWorker::event_loop(const Server::EventLoopConfig &cfg) {
         for (int i = 0; i < loop_events_count && !server_.is_stopped(); ++i) {
             const struct epoll_event fd_event = fd_events[i];
 
-            if (fd_event.data.fd == basic_acceptor_service) {
-                accept_connections(MAX_ACCEPTIONS_PER_LOOP);
+            if (fd_event.data.fd == basic_acceptor_service_) {
+                accept_connections(cfg.max_accept_clients_per_loop);
+            } else if (fd_event.data.fd == completions_.get_event_service().data()) {
+                complete_offloaded_requests();
             } else {
                 handle_client(fd_event);
             }
         }
+
+        close_expired_connections(clock_t::now());
     }
+
+    wait_offloaded_requests();
 }
 
 void EpollWorker::operator()(const Server::EventLoopConfig &cfg) {
@@ -215,20 +377,34 @@ void EpollWorker::operator()(const Server::EventLoopConfig &cfg) {
 void EpollWorker::handle_client(epoll_event fd_event) {
     const auto client_conn_io_service = fd_event.data.fd;
 
+    auto &client = get_client(client_conn_io_service);
+
+    if (client.is_offloaded) {
+        return;
+    }
+
     if (fd_event.events & EPOLLHUP || fd_event.events & EPOLLERR) {
-        try {
-            auto killer_exception = std::make_exception_ptr(errors::EpollError("epollhup err"));
-            coroutine::kill(client_conn_io_service, killer_exception);
-        } catch (errors::EpollError &) {
-            // ignored
-        }
-        close_connection(client_conn_io_service);
+        kill_client(client_conn_io_service,
+                    std::make_exception_ptr(errors::EpollError("epollhup err")));
         return;
     }
 
+    // nickeskov: headers deadline is absolute, other phases are limited by inactivity time
+    if (client.phase != client_phase::HEADERS) {
+        set_phase(client,
+                  client.phase == client_phase::IDLE ? client_phase::HEADERS : client.phase,
+                  clock_t::now());
+    }
+
+    run_client(client_conn_io_service);
+}
+
+void EpollWorker::run_client(EpollWorker::basic_io_service_t basic_io_service) {
+    auto &client = get_client(basic_io_service);
+
     coroutine::coroutine_status status = coroutine::coroutine_status::NONE;
     try {
-        status = coroutine::resume(client_conn_io_service);
+        status = resume_client(client);
     } catch (const errors::EofError &e) {
         logger_.info("[worker " + std::to_string(worker_id_) + "] " + e.what());
     }
@@ -237,175 +413,678 @@ void EpollWorker::handle_client(epoll_event fd_event) {
                      + ": " + std::strerror(e.errno_code()));
         // TODO(nickeckov): ignored, need handle all exception types
     }
+    catch (const errors::HttpBaseError &) {
+        logger_.info("[worker " + std::to_string(worker_id_) + "] invalid http request"
+                     + " [io_service=" + std::to_string(basic_io_service) + "]");
+    }
 
     if (status != coroutine::coroutine_status::AGAIN) {
-        close_connection(client_conn_io_service);
+        close_connection(basic_io_service);
+    }
+}
+
+bool EpollWorker::offload_request(EpollWorker::Client &client, EpollWorker::OffloadedRequest &offloaded) {
+    auto *handler_pool = server_.get_handler_pool();
+    if (handler_pool == nullptr) {
+        return false;
+    }
+
+    const auto basic_io_service = client.connection.get_io_service().data();
+
+    // nickeskov: request view points into io buffer, which isn't touched until completion
+    const bool is_submitted = handler_pool->try_submit([this, basic_io_service, &offloaded] {
+        try {
+            offloaded.response.emplace(server_.on_request_view(offloaded.request));
+        } catch (...) {
+            offloaded.error = std::current_exception();
+        }
+        completions_.push(basic_io_service);
+    });
+
+    if (!is_submitted) {
+        return false;
+    }
+
+    // nickeskov: client must not be resumed or killed by its events or timer while handler uses it
+    poller_->remove(basic_io_service);
+    timers_.cancel(basic_io_service);
+    client.is_offloaded = true;
+    ++offloaded_count_;
+
+    return true;
+}
+
+void EpollWorker::complete_offloaded_requests() {
+    completions_.pop_all(completed_clients_, false);
+    offloaded_count_ -= completed_clients_.size();
+
+    for (auto basic_io_service : completed_clients_) {
+        auto &client = get_client(basic_io_service);
+        client.is_offloaded = false;
+
+        if (poller_->add(basic_io_service, client.current_events) < 0) {
+            kill_client(basic_io_service, std::make_exception_ptr(
+                    errors::EpollAddError("cannot return client to event loop: "s + std::strerror(errno))));
+            continue;
+        }
+
+        run_client(basic_io_service);
+    }
+}
+
+void EpollWorker::wait_offloaded_requests() {
+    // nickeskov: handlers use requests of clients, so clients can't be destroyed until handlers are finished
+    while (offloaded_count_ > 0) {
+        completions_.pop_all(completed_clients_, true);
+        offloaded_count_ -= completed_clients_.size();
+    }
+}
+
+coroutine::coroutine_status EpollWorker::resume_client(EpollWorker::Client &client) {
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    if (client.connection.has_io_waiter()) {
+        client.connection.resume_io_waiter();
+    } else if (!client.is_task_started) {
+        client.is_task_started = true;
+        client.task.start();
+    }
+
+    if (!client.task.is_done()) {
+        return coroutine::coroutine_status::AGAIN;
+    }
+
+    client.task.rethrow_if_failed();
+    return coroutine::coroutine_status::FINISHED;
+#else
+    return coroutine::resume(client.connection.get_io_service().data());
+#endif
+}
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+Task<> EpollWorker::client_task(EpollWorker::Client &client) {
+    auto error_status = constants::http_response_status::OK;
+
+    // nickeskov: co_await isn't allowed in handler, so error response is sent after it
+    try {
+        co_await serve_client_async(client);
+        co_return;
+    } catch (const errors::HttpStandardError &e) {
+        // nickeskov: response is already being sent, so connection can only be closed
+        if (client.phase == client_phase::WRITE) {
+            throw;
+        }
+        error_status = e.get_code();
     }
+
+    co_await send_error_response_async(client, error_status);
 }
 
+Task<> EpollWorker::serve_client_async(EpollWorker::Client &client) {
+    Connection &connection = client.connection;
+
+    HttpRequestParser parser;
+    parser.set_memory_resource(&client.arena);
+    parser.set_max_headers_size(cfg_.max_headers_size);
+    parser.set_max_body_size(cfg_.max_body_size);
+
+    for (bool keep_alive = true; keep_alive;) {
+        co_await read_http_request_async(client, parser);
+
+        const HttpRequestView &request = parser.get_request();
+
+        keep_alive = begin_request(client, request);
+
+        // nickeskov: task is bound to variable, co_await of conditional temporary is miscompiled by gcc
+        Task<HttpResponse> handler = parser.is_body_streamed()
+                                     ? call_stream_handler_async(client, parser)
+                                     : call_handler_async(client, request);
+        HttpResponse response = co_await handler;
+
+        // nickeskov: rest of streamed body can't be told apart from next request
+        keep_alive = keep_alive && parser.is_body_finished();
+
+        keep_alive = begin_response(client, request, response, keep_alive);
+
+        if (response.get_async_sender()) {
+            co_await response.get_async_sender()(connection, response);
+        } else if (response.get_sender()) {
+            throw std::logic_error("synchronous response sender is not supported by stackless build");
+        } else {
+            co_await send_http_response_async(connection, response);
+        }
+
+        end_response(client, keep_alive);
+    }
+}
+
+Task<> EpollWorker::read_http_request_async(EpollWorker::Client &client, HttpRequestParser &parser) {
+    auto &buffer = client.connection.get_io_buffer();
+
+    parser.reset();
+
+    bool need_wait = false;
+    bool is_stream_checked = false;
+    for (;;) {
+        const auto status = parser.parse(buffer);
+
+        if (!is_stream_checked && parser.is_headers_parsed()) {
+            is_stream_checked = true;
+            if (try_stream_body(client, parser)) {
+                break;
+            }
+        }
+        if (status == HttpRequestParser::parse_status::COMPLETE) {
+            break;
+        }
+
+        if (client.phase == client_phase::HEADERS && parser.is_headers_parsed()) {
+            set_phase(client, client_phase::BODY, clock_t::now());
+        }
+
+        if (need_wait) {
+            co_await client.connection.wait_io(); // nickeskov: using level triggered mode
+        }
+
+        if (!read_http_request_part(client, parser)) {
+            co_await client.connection.wait_io();
+            need_wait = false;
+            continue;
+        }
+
+        need_wait = !client.connection.is_edge_triggered();
+    }
+}
+
+Task<HttpResponse> EpollWorker::call_handler_async(EpollWorker::Client &client, const HttpRequestView &request) {
+    OffloadedRequest offloaded{request, std::nullopt, nullptr};
+
+    if (!offload_request(client, offloaded)) {
+        co_return co_await server_.on_request_async(request, client.connection);
+    }
+
+    while (client.is_offloaded) {
+        co_await client.connection.wait_io();
+    }
+
+    if (offloaded.error) {
+        std::rethrow_exception(offloaded.error);
+    }
+    co_return std::move(*offloaded.response);
+}
+
+Task<HttpResponse> EpollWorker::call_stream_handler_async(EpollWorker::Client &client, HttpRequestParser &parser) {
+    BodyReader body(*this, client, parser);
+
+    co_return co_await server_.on_request_stream_async(parser.get_request(), body, client.connection);
+}
+
+Task<> EpollWorker::send_error_response_async(EpollWorker::Client &client, constants::http_response_status status) {
+    HttpResponse response(status, constants::http_version::V1_1, &client.arena);
+
+    begin_error_response(client, response);
+
+    co_await send_http_response_async(client.connection, response);
+}
+
+Task<std::string_view> EpollWorker::BodyReader::read_async() {
+    auto &buffer = client_.connection.get_io_buffer();
+
+    if (is_part_returned_) {
+        parser_.consume_body(buffer);
+    }
+    is_part_returned_ = true;
+
+    bool need_wait = false;
+    while (parser_.parse(buffer) == HttpRequestParser::parse_status::INCOMPLETE
+           && parser_.get_request().get_body().empty()) {
+        if (need_wait) {
+            co_await client_.connection.wait_io(); // nickeskov: using level triggered mode
+        }
+
+        if (!worker_.read_http_request_part(client_, parser_)) {
+            co_await client_.connection.wait_io();
+            need_wait = false;
+            continue;
+        }
+
+        need_wait = !client_.connection.is_edge_triggered();
+    }
+
+    co_return parser_.get_request().get_body();
+}
+
+#else
+
 void EpollWorker::client_routine() {
     auto client_conn_io_service = coroutine::current();
 
-    Client &client = clients_.at(client_conn_io_service);
+    Client &client = get_client(client_conn_io_service);
+
+    auto error_status = constants::http_response_status::OK;
 
+    // nickeskov: client must not yield in exception handler, because other clients may throw meanwhile
+    try {
+        serve_client(client);
+        return;
+    } catch (const errors::HttpStandardError &e) {
+        // nickeskov: response is already being sent, so connection can only be closed
+        if (client.phase == client_phase::WRITE) {
+            throw;
+        }
+        error_status = e.get_code();
+    }
+
+    send_error_response(client, error_status);
+}
+
+void EpollWorker::serve_client(EpollWorker::Client &client) {
     Connection &connection = client.connection;
 
-    while (true) {
-        HttpRequest request = read_http_request(connection);
+    HttpRequestParser parser;
+    parser.set_memory_resource(&client.arena);
+    parser.set_max_headers_size(cfg_.max_headers_size);
+    parser.set_max_body_size(cfg_.max_body_size);
+
+    for (bool keep_alive = true; keep_alive;) {
+        const HttpRequestView &request = read_http_request(client, parser);
+
+        keep_alive = begin_request(client, request);
 
-        change_event(client, EPOLLOUT);
+        // nickeskov: request view points into io buffer, so it must not be changed while handling
+        HttpResponse response = parser.is_body_streamed()
+                                ? call_stream_handler(client, parser)
+                                : call_handler(client, request);
 
-        HttpResponse response = server_.on_request(request);
+        // nickeskov: rest of streamed body can't be told apart from next request
+        keep_alive = keep_alive && parser.is_body_finished();
+
+        keep_alive = begin_response(client, request, response, keep_alive);
 
         if (response.get_sender()) {
             auto &sender = response.get_sender();
 
             sender(connection, response);
-
-            connection.get_io_buffer().clear();
         } else {
             send_http_response(connection, response);
         }
 
-        // TODO(nickeskov): need implement keepalive connection type
-        break;
+        end_response(client, keep_alive);
     }
 }
 
-namespace {
+const HttpRequestView &EpollWorker::read_http_request(EpollWorker::Client &client, HttpRequestParser &parser) {
+    auto &buffer = client.connection.get_io_buffer();
+
+    parser.reset();
+
+    // nickeskov: pipelined request may be already in buffer, so parse before reading
+    bool need_yield = false;
+    bool is_stream_checked = false;
+    for (;;) {
+        const auto status = parser.parse(buffer);
+
+        if (!is_stream_checked && parser.is_headers_parsed()) {
+            is_stream_checked = true;
+            if (try_stream_body(client, parser)) {
+                break;
+            }
+        }
+        if (status == HttpRequestParser::parse_status::COMPLETE) {
+            break;
+        }
 
-int epoll_act(int epoll_fd, int act, int fd, uint32_t events) {
-    struct epoll_event epoll_event{};
-    epoll_event.events = events;
-    epoll_event.data.fd = fd;
-    return epoll_ctl(epoll_fd, act, fd, &epoll_event);
+        if (client.phase == client_phase::HEADERS && parser.is_headers_parsed()) {
+            set_phase(client, client_phase::BODY, clock_t::now());
+        }
+
+        if (need_yield) {
+            coroutine::yield(); // nickeskov: using level triggered mode
+        }
+
+        if (!read_http_request_part(client, parser)) {
+            coroutine::yield();
+            need_yield = false;
+            continue;
+        }
+
+        // nickeskov: no more events may come after last chunk, so yield only if request is incomplete
+        need_yield = !client.connection.is_edge_triggered();
+    }
+
+    return parser.get_request();
 }
 
-int epoll_add(int epoll_fd, int fd, uint32_t events) {
-    return epoll_act(epoll_fd, EPOLL_CTL_ADD, fd, events);
+HttpResponse EpollWorker::call_handler(EpollWorker::Client &client, const HttpRequestView &request) {
+    OffloadedRequest offloaded{request, std::nullopt, nullptr};
+
+    if (!offload_request(client, offloaded)) {
+        return server_.on_request_view(request);
+    }
+
+    while (client.is_offloaded) {
+        coroutine::yield();
+    }
+
+    if (offloaded.error) {
+        std::rethrow_exception(offloaded.error);
+    }
+    return std::move(*offloaded.response);
 }
 
-int epoll_mod(int epoll_fd, int fd, uint32_t new_events) {
-    return epoll_act(epoll_fd, EPOLL_CTL_MOD, fd, new_events);
+HttpResponse EpollWorker::call_stream_handler(EpollWorker::Client &client, HttpRequestParser &parser) {
+    BodyReader body(*this, client, parser);
+
+    return server_.on_request_stream(parser.get_request(), body);
 }
 
-//int epoll_del(int epoll_fd, int fd) {
-//    return epoll_act(epoll_fd, EPOLL_CTL_DEL, fd, 0);
-//}
+void EpollWorker::send_error_response(EpollWorker::Client &client, constants::http_response_status status) {
+    HttpResponse response(status, constants::http_version::V1_1, &client.arena);
 
-std::string_view read_body(Connection &connection, size_t start_pos, ssize_t body_len) {
-    if (body_len > 0) {
-        auto &buffer = connection.get_io_buffer();
+    begin_error_response(client, response);
 
-        auto buff_size = buffer.size();
+    send_http_response(client.connection, response);
+}
 
-        ssize_t was_read = buff_size - start_pos;
-        while (was_read < body_len) {
-            ssize_t bytes = connection.read_in_io_buff(MAX_READ_BYTES_PER_CALL);
-            if (bytes <= 0) {
-                if (bytes == 0) {
-                    throw errors::EofError("Connection closed while receiving BODY");
-                }
-                coroutine::yield();
-                continue;
-            }
+std::string_view EpollWorker::BodyReader::read() {
+    auto &buffer = client_.connection.get_io_buffer();
 
-            was_read += bytes;
+    if (is_part_returned_) {
+        parser_.consume_body(buffer);
+    }
+    is_part_returned_ = true;
 
+    bool need_yield = false;
+    while (parser_.parse(buffer) == HttpRequestParser::parse_status::INCOMPLETE
+           && parser_.get_request().get_body().empty()) {
+        if (need_yield) {
             coroutine::yield(); // nickeskov: using level triggered mode
         }
 
-        return std::string_view(buffer).substr(start_pos, body_len);
+        if (!worker_.read_http_request_part(client_, parser_)) {
+            coroutine::yield();
+            need_yield = false;
+            continue;
+        }
+
+        need_yield = !client_.connection.is_edge_triggered();
     }
 
-    return {};
+    return parser_.get_request().get_body();
 }
 
-size_t read_until_headers_end(Connection &connection) {
-    auto &buffer = connection.get_io_buffer();
+#endif
 
-    size_t headers_end_pos = std::string::npos;
+EpollWorker::BodyReader::BodyReader(EpollWorker &worker, EpollWorker::Client &client,
+                                    HttpRequestParser &parser) noexcept
+        : worker_(worker), client_(client), parser_(parser) {}
 
-    while (true) {
-        size_t pos = 0;
-        if (buffer.size() > constants::strings::headers_end.size()) {
-            pos = buffer.size() - constants::strings::headers_end.size();
-        }
+bool EpollWorker::BodyReader::is_finished() const noexcept {
+    return parser_.is_body_finished();
+}
 
-        ssize_t bytes = connection.read_in_io_buff(MAX_READ_BYTES_PER_CALL);
-        if (bytes <= 0) {
-            if (bytes == 0) {
-                throw errors::EofError("Connection closed while receiving HEADERS");
+bool EpollWorker::read_http_request_part(EpollWorker::Client &client, const HttpRequestParser &parser) {
+    auto &connection = client.connection;
+
+    ssize_t bytes = connection.read_in_io_buff(read_size_per_call(connection, parser.get_missing_size()));
+    if (bytes == 0) {
+        throw errors::EofError(parser.is_headers_parsed()
+                               ? "Connection closed while receiving BODY"
+                               : "Connection closed while receiving HEADERS");
+    }
+    return bytes > 0;
+}
+
+bool EpollWorker::try_stream_body(EpollWorker::Client &client, HttpRequestParser &parser) {
+    if (!server_.is_body_streamed(parser.get_request())) {
+        return false;
+    }
+
+    parser.stream_body();
+
+    // nickeskov: handler reads body, so body timeout is applied instead of headers deadline
+    if (client.phase == client_phase::HEADERS) {
+        set_phase(client, client_phase::BODY, clock_t::now());
+    }
+    return true;
+}
+
+bool EpollWorker::begin_request(EpollWorker::Client &client, const HttpRequestView &request) {
+    ++client.requests_count;
+
+    // nickeskov: objects of previous request are already destroyed
+    client.arena.begin_request();
+
+    return is_keepalive_requested(request)
+           && (cfg_.keepalive_max_requests == 0
+               || client.requests_count < cfg_.keepalive_max_requests);
+}
+
+bool EpollWorker::begin_response(EpollWorker::Client &client, const HttpRequestView &request,
+                                 HttpResponse &response, bool keep_alive) {
+    auto &connection = client.connection;
+
+    // nickeskov: leave only pipelined requests in io buffer and save them while sending response
+    connection.get_io_buffer().erase(0, request.size());
+    connection.get_io_buffer().swap(client.pipelined_input);
+    connection.get_io_buffer().clear();
+
+    change_event(client, EPOLLOUT | client_events_flags_);
+    set_phase(client, client_phase::WRITE, clock_t::now());
+
+    if (response.get_response_line().get_http_version() > constants::http_version::V0_9) {
+        auto &headers = response.get_headers();
+
+        if (is_produced_body_sent(response) && !headers.contains(constants::well_known_header::CONTENT_LENGTH)) {
+            if (response.get_response_line().get_http_version() == constants::http_version::V1_1) {
+                headers.insert_or_assign(constants::headers::transfer_encoding,
+                                         constants::transfer_codings::chunked);
+            } else {
+                keep_alive = false; // nickeskov: HTTP/1.0 body without length is terminated by close
             }
-            coroutine::yield(); // TODO(nickeskov): 0 means connection closed!
-            continue;
         }
 
-        headers_end_pos = buffer.find(constants::strings::headers_end, pos);
-        if (headers_end_pos != std::string::npos) {
-            break;
+        headers.insert_or_assign(constants::headers::connection,
+                                 keep_alive
+                                 ? constants::connection_types::keep_alive
+                                 : constants::connection_types::close);
+
+        // nickeskov: persistent connection needs explicit message length, even if body is empty
+        if (!has_sender(response)
+            && !response.get_body_producer()
+            && !headers.contains(constants::well_known_header::CONTENT_LENGTH)
+            && is_body_allowed(response.get_response_line().get_response_status())) {
+            headers.emplace(constants::headers::content_length, std::to_string(response.get_body().size()));
         }
-
-        coroutine::yield(); // nickeskov: using level triggered mode
     }
 
-    return headers_end_pos;
+    return keep_alive;
 }
 
-HttpRequest read_http_request(Connection &connection) {
+void EpollWorker::begin_error_response(EpollWorker::Client &client, HttpResponse &response) {
+    auto &connection = client.connection;
+
+    logger_.info("[worker " + std::to_string(worker_id_) + "] invalid http request, responding "
+                 + std::to_string(static_cast<int>(response.get_response_line().get_response_status()))
+                 + " [io_service=" + std::to_string(connection.get_io_service().data()) + "]");
+
+    // nickeskov: rest of request is unknown, so input is dropped and connection is closed after response
     connection.get_io_buffer().clear();
+    client.pipelined_input.clear();
 
-    size_t headers_end_pos = read_until_headers_end(connection);
+    change_event(client, EPOLLOUT | client_events_flags_);
+    set_phase(client, client_phase::WRITE, clock_t::now());
 
-    std::string_view buff = connection.get_io_buffer();
-    auto newline_pos = buff.find(constants::strings::newline);
+    auto &headers = response.get_headers();
+    headers.insert_or_assign(constants::headers::connection, constants::connection_types::close);
+    headers.insert_or_assign(constants::headers::content_length, "0");
+}
 
-    auto request_line_str = buff.substr(0, newline_pos);
-    auto headers_str = buff.substr(newline_pos + constants::strings::newline.size(),
-                                   headers_end_pos - newline_pos);
+void EpollWorker::end_response(EpollWorker::Client &client, bool keep_alive) {
+    auto &connection = client.connection;
 
-    HttpRequestLine request_line(request_line_str);
-    HttpHeaders headers(headers_str);
+    connection.get_io_buffer().clear();
+    connection.get_io_buffer().swap(client.pipelined_input);
 
-    std::string_view body;
+    if (keep_alive) {
+        change_event(client, EPOLLIN | client_events_flags_);
 
-    if (headers.contains(constants::headers::content_length)) {
-        size_t start_pos = headers_end_pos + constants::strings::headers_end.size();
-        ssize_t body_len = std::stoll(headers.at(constants::headers::content_length));
+        set_phase(client,
+                  connection.get_io_buffer().empty() ? client_phase::IDLE : client_phase::HEADERS,
+                  clock_t::now());
+    }
+}
+
+namespace {
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+Task<> send_http_response_async(Connection &connection, const HttpResponse &response) {
+    auto &head = connection.get_io_buffer();
 
-        // TODO(nickeskov): check if body size lower than zero (<0)
+    head.clear();
+    response.serialize_head(head);
 
-        body = read_body(connection, start_pos, body_len);
+    IovecWriter writer;
+    writer.append(head);
+
+    if (!is_produced_body_sent(response)) {
+        writer.append(response.get_body());
+
+        co_await writer.flush_async(connection);
+
+        head.clear();
+        co_return;
     }
 
-    auto request = HttpRequest(std::move(request_line), std::move(headers), body);
+    // nickeskov: head is sent together with first part, parts are flushed as soon as they are produced
+    const bool is_chunked = response.get_headers().contains(constants::well_known_header::TRANSFER_ENCODING);
+    std::pmr::string part(response.get_memory_resource());
+    chunk_size_line_t size_line{};
 
-    connection.get_io_buffer().clear();
+    for (bool has_more = true; has_more;) {
+        part.clear();
+        has_more = response.get_body_producer()(part);
 
-    return request;
+        append_body_part(writer, size_line, part, is_chunked);
+        if (!has_more && is_chunked) {
+            writer.append(constants::strings::last_chunk);
+        }
+
+        co_await writer.flush_async(connection);
+    }
+
+    head.clear();
 }
 
+#else
+
 void send_http_response(Connection &connection, const HttpResponse &response) {
-    connection.get_io_buffer().clear();
+    // nickeskov: only head is serialized into io buffer, body is written directly from response
+    auto &head = connection.get_io_buffer();
 
-    connection.get_io_buffer() += response.to_string();
+    head.clear();
+    response.serialize_head(head);
 
-    auto write_size = connection.get_io_buffer().size();
+    IovecWriter writer;
+    writer.append(head);
 
-    for (size_t written = 0; written < write_size;) {
-        auto bytes = connection.write_from_io_buff(MAX_WRITE_BYTES_PER_CALL);
+    if (!is_produced_body_sent(response)) {
+        writer.append(response.get_body());
 
-        if (bytes < 0) {
-            coroutine::yield();
-            continue;
+        writer.flush(connection);
+
+        head.clear();
+        return;
+    }
+
+    // nickeskov: head is sent together with first part, parts are flushed as soon as they are produced
+    const bool is_chunked = response.get_headers().contains(constants::well_known_header::TRANSFER_ENCODING);
+    std::pmr::string part(response.get_memory_resource());
+    chunk_size_line_t size_line{};
+
+    for (bool has_more = true; has_more;) {
+        part.clear();
+        has_more = response.get_body_producer()(part);
+
+        append_body_part(writer, size_line, part, is_chunked);
+        if (!has_more && is_chunked) {
+            writer.append(constants::strings::last_chunk);
         }
 
-        written += bytes;
+        writer.flush(connection);
+    }
+
+    head.clear();
+}
+
+#endif
+
+void append_body_part(IovecWriter &writer, chunk_size_line_t &size_line, std::string_view part, bool is_chunked) {
+    // nickeskov: empty chunk is the last one, so empty parts are skipped
+    if (part.empty()) {
+        return;
+    }
 
-        coroutine::yield(); // nickeskov: using level triggered mode
+    if (is_chunked) {
+        const auto size_end = std::to_chars(size_line.data(), size_line.data() + size_line.size(),
+                                            part.size(), 16).ptr;
+        std::copy(constants::strings::newline.begin(), constants::strings::newline.end(), size_end);
+
+        writer.append(std::string_view(size_line.data(),
+                                       size_end - size_line.data() + constants::strings::newline.size()));
+        writer.append(part);
+        writer.append(constants::strings::newline);
+    } else {
+        writer.append(part);
     }
+}
 
-    connection.get_io_buffer().clear();
+bool has_sender(const HttpResponse &response) noexcept {
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+    if (response.get_async_sender()) {
+        return true;
+    }
+#endif
+    return static_cast<bool>(response.get_sender());
+}
+
+bool is_produced_body_sent(const HttpResponse &response) noexcept {
+    return response.get_body_producer()
+           && is_body_allowed(response.get_response_line().get_response_status());
+}
+
+size_t read_size_per_call(const Connection &connection, size_t expected_size) {
+    if (!connection.is_edge_triggered()) {
+        return MAX_READ_BYTES_PER_CALL;
+    }
+    return std::clamp(expected_size, MAX_READ_BYTES_PER_CALL, MAX_DRAIN_READ_BYTES_PER_CALL);
+}
+
+bool is_body_allowed(constants::http_response_status status) noexcept {
+    // RFC 7230, 3.3.3: 1xx, 204 and 304 responses are always terminated by the first empty line
+    return status >= constants::http_response_status::OK
+           && status != constants::http_response_status::NoContent
+           && status != constants::http_response_status::NotModified;
+}
+
+bool is_keepalive_requested(const HttpRequestView &request) {
+    const auto connection_type = request.get_header(constants::well_known_header::CONNECTION);
+
+    switch (request.get_version()) {
+        case constants::http_version::V1_1: {
+            // RFC 7230, 6.3: HTTP/1.1 connections are persistent by default
+            return !utils::contains_token(connection_type, constants::connection_types::close);
+        }
+        case constants::http_version::V1_0: {
+            return utils::contains_token(connection_type, constants::connection_types::keep_alive);
+        }
+        case constants::http_version::V0_9: // fallthrough
+        case constants::http_version::UNSUPPORTED_: // fallthrough
+        default: {
+            return false;
+        }
+    }
 }
 
 }
@@ -38,6 +38,8 @@ ReadError::ReadError(std::string_view what_arg) : IoError(what_arg) {}
 
 EofError::EofError(std::string_view what_arg) : ReadError(what_arg) {}
 
+TimeoutError::TimeoutError(std::string_view what_arg) : IoError(what_arg) {}
+
 ConnectionError::ConnectionError(std::string_view what_arg)
         : RuntimeError(what_arg) {}
 
@@ -80,4 +82,8 @@ ListenError::ListenError(std::string_view what_arg) : ServerError(what_arg) {}
 
 ServerCloseError::ServerCloseError(std::string_view what_arg) : ServerError(what_arg) {}
 
+RouterError::RouterError(std::string_view what_arg) : RuntimeError(what_arg) {}
+
+HandlerPoolError::HandlerPoolError(std::string_view what_arg) : ServerError(what_arg) {}
+
 }
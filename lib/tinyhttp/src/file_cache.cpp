@@ -0,0 +1,478 @@
+#include "tinyhttp/file_cache.h"
+#include "tinyhttp/utils.h"
+
+#include <filesystem>
+#include <utility>
+#include <cerrno>
+#include <cstdio>
+
+extern "C" {
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#ifdef TINYHTTP_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace tinyhttp {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::unordered_map<std::string_view, std::string_view> mime_type_by_extension = {
+        {".html", "text/html"},
+        {".css",  "text/css"},
+        {".js",   "application/javascript"},
+        {".jpg",  "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".png",  "image/png"},
+        {".gif",  "image/gif"},
+        {".swf",  "application/x-shockwave-flash"},
+};
+
+constexpr std::string_view mime_octet_stream = "application/octet-stream";
+constexpr std::string_view index_file_name = "index.html";
+constexpr std::string_view gzip_extension = ".gz";
+constexpr std::string_view gzip_etag_suffix = "-gzip";
+
+inline bool is_same_file(const FileCache::Entry &entry, const struct stat &file_stat) noexcept {
+    return entry.inode == file_stat.st_ino
+           && static_cast<off_t>(entry.size) == file_stat.st_size
+           && entry.mtime.tv_sec == file_stat.st_mtim.tv_sec
+           && entry.mtime.tv_nsec == file_stat.st_mtim.tv_nsec;
+}
+
+inline size_t get_entry_memory_usage(const FileCache::Entry &entry) noexcept {
+    return entry.content.size() + (entry.gzip_variant ? entry.gzip_variant->content.size() : 0);
+}
+
+// nickeskov: precompressed sibling is checked too, compressed in memory variant has the same path
+bool is_entry_valid(const FileCache::Entry &entry) noexcept {
+    struct stat file_stat{};
+    if (stat(entry.path.c_str(), &file_stat) != 0 || !is_same_file(entry, file_stat)) {
+        return false;
+    }
+
+    const auto &variant = entry.gzip_variant;
+    if (variant && variant->path != entry.path) {
+        return stat(variant->path.c_str(), &file_stat) == 0 && is_same_file(*variant, file_stat);
+    }
+
+    return true;
+}
+
+inline bool is_compressible(std::string_view mime_type) noexcept {
+    constexpr std::string_view text_prefix = "text/";
+    return mime_type.substr(0, text_prefix.size()) == text_prefix
+           || mime_type == "application/javascript";
+}
+
+#ifdef TINYHTTP_WITH_ZLIB
+
+bool gzip_compress(std::string_view input, std::string &output) {
+    z_stream stream{};
+
+    // nickeskov: 15 + 16 window bits means maximum window with gzip wrapper instead of zlib one
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef *>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    const int status = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+
+    if (status != Z_STREAM_END) {
+        return false;
+    }
+
+    output.resize(stream.total_out);
+    return true;
+}
+
+#endif
+
+bool read_whole_file(int fd, std::string &content, size_t size) {
+    content.resize(size);
+
+    for (size_t offset = 0; offset < size;) {
+        ssize_t bytes = pread(fd, content.data() + offset, size - offset, static_cast<off_t>(offset));
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false; // nickeskov: error or file was truncated while reading
+        }
+        offset += bytes;
+    }
+
+    return true;
+}
+
+inline void append_header(std::string &headers, std::string_view header, std::string_view value) {
+    headers += header;
+    headers += constants::strings::colon;
+    headers += constants::strings::space;
+    headers += value;
+    headers += constants::strings::newline;
+}
+
+std::string format_etag(const struct stat &file_stat) {
+    // nickeskov: mtime and size identify version of file, like nginx does
+    char etag[64];
+    const int len = std::snprintf(etag, sizeof(etag), "\"%llx-%lx-%llx\"",
+                                  static_cast<unsigned long long>(file_stat.st_mtim.tv_sec),
+                                  static_cast<unsigned long>(file_stat.st_mtim.tv_nsec),
+                                  static_cast<unsigned long long>(file_stat.st_size));
+    return std::string(etag, static_cast<size_t>(len));
+}
+
+void set_entity_headers(FileCache::Entry &entry, bool has_variants) {
+    entry.validator_headers.clear();
+    append_header(entry.validator_headers, constants::headers::etag, entry.etag);
+    append_header(entry.validator_headers, constants::headers::last_modified, entry.last_modified);
+    if (has_variants) {
+        append_header(entry.validator_headers, constants::headers::vary, constants::headers::accept_encoding);
+    }
+
+    entry.headers.clear();
+    append_header(entry.headers, constants::headers::content_length, std::to_string(entry.size));
+    append_header(entry.headers, constants::headers::content_type, entry.mime_type);
+    if (!entry.content_encoding.empty()) {
+        append_header(entry.headers, constants::headers::content_encoding, entry.content_encoding);
+    }
+    append_header(entry.headers, constants::headers::accept_ranges, constants::range_units::bytes);
+    entry.headers += entry.validator_headers;
+}
+
+inline constants::http_response_status status_by_errno(int errno_code) noexcept {
+    if (errno_code == EACCES) {
+        return constants::http_response_status::Forbidden;
+    }
+    return constants::http_response_status::NotFound;
+}
+
+}
+
+std::string_view get_mime_type(std::string_view extension) {
+    auto mime_type_it = mime_type_by_extension.find(extension);
+    if (mime_type_it != mime_type_by_extension.end()) {
+        return mime_type_it->second;
+    }
+    return mime_octet_stream;
+}
+
+FileCache::FileCache(std::string_view document_root, const Config &cfg)
+        : document_root_(document_root), cfg_(cfg) {}
+
+FileCache::LookupResult FileCache::lookup(std::string_view url) {
+    const auto now = clock_t::now();
+
+    entry_ptr_t cached_entry;
+    {
+        std::lock_guard lock(mutex_);
+
+        auto node_it = entries_.find(url);
+        if (node_it != entries_.end()) {
+            auto &node = node_it->second;
+
+            lru_.splice(lru_.begin(), lru_, node.lru_position);
+
+            if (now < node.revalidate_at) {
+                hits_count_.fetch_add(1, std::memory_order_relaxed);
+                return LookupResult{constants::http_response_status::OK, node.entry};
+            }
+
+            cached_entry = node.entry;
+        }
+    }
+
+    // nickeskov: cheap revalidation, file is reopened only if it was changed or replaced
+    if (cached_entry && is_entry_valid(*cached_entry)) {
+        std::lock_guard lock(mutex_);
+
+        auto node_it = entries_.find(url);
+        if (node_it != entries_.end() && node_it->second.entry == cached_entry) {
+            node_it->second.revalidate_at = next_revalidation(now);
+        }
+
+        hits_count_.fetch_add(1, std::memory_order_relaxed);
+        return LookupResult{constants::http_response_status::OK, std::move(cached_entry)};
+    }
+
+    misses_count_.fetch_add(1, std::memory_order_relaxed);
+
+    // nickeskov: file is opened without lock, so other workers are not blocked by slow fs
+    auto result = load(url);
+
+    std::lock_guard lock(mutex_);
+
+    if (result.entry) {
+        insert(url, result.entry, now);
+    } else {
+        auto node_it = entries_.find(url);
+        if (node_it != entries_.end()) {
+            erase(node_it);
+        }
+    }
+
+    return result;
+}
+
+const std::string &FileCache::get_document_root() const noexcept {
+    return document_root_;
+}
+
+uint64_t FileCache::get_hits_count() const noexcept {
+    return hits_count_.load(std::memory_order_relaxed);
+}
+
+uint64_t FileCache::get_misses_count() const noexcept {
+    return misses_count_.load(std::memory_order_relaxed);
+}
+
+double FileCache::get_hit_rate() const noexcept {
+    const auto hits = get_hits_count();
+    const auto lookups = hits + get_misses_count();
+    if (lookups == 0) {
+        return 0;
+    }
+    return static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+size_t FileCache::get_memory_usage() const noexcept {
+    return memory_usage_.load(std::memory_order_relaxed);
+}
+
+size_t FileCache::size() const {
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
+
+void FileCache::invalidate(const Entry &entry) {
+    std::lock_guard lock(mutex_);
+
+    // nickeskov: entry is invalidated only if file was changed while sending, so linear search is enough
+    for (auto node_it = entries_.begin(); node_it != entries_.end(); ++node_it) {
+        const auto &cached_entry = node_it->second.entry;
+        if (cached_entry.get() == &entry || cached_entry->gzip_variant.get() == &entry) {
+            erase(node_it);
+            return;
+        }
+    }
+}
+
+void FileCache::clear() {
+    std::lock_guard lock(mutex_);
+    entries_.clear();
+    lru_.clear();
+    memory_usage_.store(0, std::memory_order_relaxed);
+}
+
+FileCache::LookupResult FileCache::load(std::string_view url) const {
+    fs::path file_path = document_root_;
+    file_path += url;
+
+    std::error_code error_code;
+
+    file_path = fs::canonical(file_path, error_code);
+    if (error_code) {
+        return LookupResult{status_by_errno(error_code.value()), nullptr};
+    }
+
+    // nickeskov: check if file not in document root
+    const auto &native_path = file_path.native();
+    if (native_path.compare(0, document_root_.size(), document_root_) != 0
+        || (native_path.size() > document_root_.size() && native_path[document_root_.size()] != '/')) {
+        return LookupResult{constants::http_response_status::BadRequest, nullptr};
+    }
+
+    auto fd = unixprimwrap::Descriptor(open(file_path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (!fd.is_valid()) {
+        return LookupResult{status_by_errno(errno), nullptr};
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd.data(), &file_stat) < 0) {
+        return LookupResult{constants::http_response_status::InternalServerError, nullptr};
+    }
+
+    if (S_ISDIR(file_stat.st_mode)) { // nickeskov: display index file
+        file_path /= index_file_name;
+
+        fd = unixprimwrap::Descriptor(open(file_path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (!fd.is_valid()) {
+            if (errno != ENOENT && errno != EACCES) {
+                return LookupResult{constants::http_response_status::InternalServerError, nullptr};
+            }
+            return LookupResult{constants::http_response_status::Forbidden, nullptr};
+        }
+
+        if (fstat(fd.data(), &file_stat) < 0) {
+            return LookupResult{constants::http_response_status::InternalServerError, nullptr};
+        }
+    }
+
+    if (!S_ISREG(file_stat.st_mode)) {
+        return LookupResult{constants::http_response_status::Forbidden, nullptr};
+    }
+
+    const auto mime_type = get_mime_type(file_path.extension().native());
+
+    auto entry = make_entry(file_path.string(), std::move(fd), file_stat, mime_type);
+    if (!entry) {
+        return LookupResult{constants::http_response_status::InternalServerError, nullptr};
+    }
+
+    if (cfg_.gzip_static) {
+        entry->gzip_variant = load_precompressed_variant(*entry);
+    }
+
+    if (!entry->gzip_variant && cfg_.gzip_compress) {
+        entry->gzip_variant = compress_variant(*entry);
+    }
+
+    set_entity_headers(*entry, entry->gzip_variant != nullptr);
+
+    return LookupResult{constants::http_response_status::OK, std::move(entry)};
+}
+
+std::shared_ptr<FileCache::Entry> FileCache::make_entry(std::string &&path, unixprimwrap::Descriptor &&fd,
+                                                        const struct stat &file_stat,
+                                                        std::string_view mime_type) const {
+    auto entry = std::make_shared<Entry>();
+    entry->path = std::move(path);
+    entry->size = static_cast<size_t>(file_stat.st_size);
+    entry->mtime = file_stat.st_mtim;
+    entry->inode = file_stat.st_ino;
+    entry->mime_type = mime_type;
+    entry->etag = format_etag(file_stat);
+    entry->last_modified = utils::format_http_date(file_stat.st_mtim.tv_sec);
+
+    if (entry->size <= cfg_.max_in_memory_file_size && entry->size <= cfg_.max_memory_usage) {
+        if (!read_whole_file(fd.data(), entry->content, entry->size)) {
+            return nullptr;
+        }
+        // nickeskov: fd is not needed anymore, so it is closed with local descriptor
+        entry->is_in_memory = true;
+    } else {
+        entry->fd = std::move(fd);
+    }
+
+    return entry;
+}
+
+FileCache::entry_ptr_t FileCache::load_precompressed_variant(const Entry &entry) const {
+    std::string path = entry.path;
+    path += gzip_extension;
+
+    auto fd = unixprimwrap::Descriptor(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (!fd.is_valid()) {
+        return nullptr;
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd.data(), &file_stat) < 0 || !S_ISREG(file_stat.st_mode)) {
+        return nullptr;
+    }
+
+    auto variant = make_entry(std::move(path), std::move(fd), file_stat, entry.mime_type);
+    if (!variant) {
+        return nullptr;
+    }
+
+    variant->content_encoding = constants::content_codings::gzip;
+    set_entity_headers(*variant, true);
+
+    return variant;
+}
+
+FileCache::entry_ptr_t FileCache::compress_variant(const Entry &entry) const {
+#ifdef TINYHTTP_WITH_ZLIB
+    if (!is_compressible(entry.mime_type) || entry.size > cfg_.max_gzip_compress_file_size) {
+        return nullptr;
+    }
+
+    std::string raw_content;
+    if (!entry.is_in_memory && !read_whole_file(entry.fd.data(), raw_content, entry.size)) {
+        return nullptr;
+    }
+
+    std::string compressed;
+    if (!gzip_compress(entry.is_in_memory ? entry.content : raw_content, compressed)
+        || compressed.size() >= entry.size) {
+        return nullptr; // nickeskov: compression is useless for this file
+    }
+
+    // nickeskov: compressed variant is always kept in memory, so it has no fd
+    auto variant = std::make_shared<Entry>();
+    variant->path = entry.path;
+    variant->size = compressed.size();
+    variant->mtime = entry.mtime;
+    variant->inode = entry.inode;
+    variant->mime_type = entry.mime_type;
+    variant->content_encoding = constants::content_codings::gzip;
+    variant->etag = entry.etag;
+    variant->etag.insert(variant->etag.size() - 1, gzip_etag_suffix);
+    variant->last_modified = entry.last_modified;
+    variant->is_in_memory = true;
+    variant->content = std::move(compressed);
+
+    set_entity_headers(*variant, true);
+
+    return variant;
+#else
+    static_cast<void>(entry);
+    return nullptr;
+#endif
+}
+
+FileCache::clock_t::time_point FileCache::next_revalidation(clock_t::time_point now) const noexcept {
+    if (cfg_.ttl < 0) {
+        return clock_t::time_point::max();
+    }
+    return now + std::chrono::milliseconds(cfg_.ttl);
+}
+
+void FileCache::insert(std::string_view url, const entry_ptr_t &entry, clock_t::time_point now) {
+    if (cfg_.max_entries == 0) {
+        return;
+    }
+
+    auto node_it = entries_.find(url);
+    if (node_it != entries_.end()) {
+        erase(node_it);
+    }
+
+    const auto entry_memory_usage = get_entry_memory_usage(*entry);
+
+    while (!lru_.empty()
+           && (entries_.size() >= cfg_.max_entries
+               || get_memory_usage() + entry_memory_usage > cfg_.max_memory_usage)) {
+        erase(entries_.find(lru_.back()));
+    }
+
+    lru_.emplace_front(url);
+    entries_.emplace(lru_.front(), Node{entry, next_revalidation(now), lru_.begin()});
+    memory_usage_.fetch_add(entry_memory_usage, std::memory_order_relaxed);
+}
+
+void FileCache::erase(entries_map_t::iterator node_it) {
+    memory_usage_.fetch_sub(get_entry_memory_usage(*node_it->second.entry), std::memory_order_relaxed);
+
+    // nickeskov: key refers to url in lru list, so node is erased before it
+    const auto lru_position = node_it->second.lru_position;
+    entries_.erase(node_it);
+    lru_.erase(lru_position);
+}
+
+}
@@ -0,0 +1,108 @@
+#include "tinyhttp/handler_pool.h"
+#include "tinyhttp/errors.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+extern "C" {
+#include <sys/eventfd.h>
+#include <unistd.h>
+}
+
+namespace tinyhttp {
+
+using namespace std::literals::string_literals;
+
+HandlerPool::HandlerPool(size_t threads_count, size_t max_queued_jobs)
+        : max_queued_jobs_(max_queued_jobs) {
+    threads_.reserve(threads_count);
+
+    for (size_t i = 0; i < threads_count; ++i) {
+        threads_.emplace_back(&HandlerPool::thread_routine, this);
+    }
+}
+
+bool HandlerPool::try_submit(HandlerPool::job_t &&job) {
+    {
+        std::lock_guard lock(mutex_);
+
+        if (jobs_.size() >= max_queued_jobs_) {
+            return false;
+        }
+        jobs_.push_back(std::move(job));
+    }
+    has_jobs_.notify_one();
+    return true;
+}
+
+HandlerPool::~HandlerPool() noexcept {
+    {
+        std::lock_guard lock(mutex_);
+        is_stopped_ = true;
+    }
+    has_jobs_.notify_all();
+
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void HandlerPool::thread_routine() {
+    for (;;) {
+        job_t job;
+        {
+            std::unique_lock lock(mutex_);
+            has_jobs_.wait(lock, [this] { return is_stopped_ || !jobs_.empty(); });
+
+            if (jobs_.empty()) {
+                return;
+            }
+
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+CompletionQueue::CompletionQueue() : event_fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    if (!event_fd_.is_valid()) {
+        throw errors::HandlerPoolError("cannot create eventfd: "s + std::strerror(errno));
+    }
+}
+
+void CompletionQueue::push(int id) {
+    std::lock_guard lock(mutex_);
+
+    ids_.push_back(id);
+
+    // nickeskov: eventfd is already signalled if queue was not empty
+    if (ids_.size() == 1) {
+        const uint64_t value = 1;
+        [[maybe_unused]] auto status = ::write(event_fd_.data(), &value, sizeof(value));
+        has_ids_.notify_one();
+    }
+}
+
+void CompletionQueue::pop_all(std::vector<int> &ids, bool wait) {
+    ids.clear();
+
+    std::unique_lock lock(mutex_);
+    if (wait) {
+        has_ids_.wait(lock, [this] { return !ids_.empty(); });
+    }
+
+    if (!ids_.empty()) {
+        uint64_t value = 0;
+        [[maybe_unused]] auto status = ::read(event_fd_.data(), &value, sizeof(value));
+    }
+    ids.swap(ids_);
+}
+
+const unixprimwrap::Descriptor &CompletionQueue::get_event_service() const noexcept {
+    return event_fd_;
+}
+
+}
@@ -0,0 +1,438 @@
+#include "tinyhttp/header_scanner.h"
+#include "tinyhttp/constants.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#define TINYHTTP_SCANNER_WITH_VECTORS
+extern "C" {
+#include <immintrin.h>
+}
+#endif
+
+namespace tinyhttp::scanner {
+
+namespace {
+
+constexpr char CR = '\r';
+constexpr char LF = '\n';
+constexpr char HTAB = '\t';
+constexpr char COLON = ':';
+constexpr char DEL = 0x7f;
+constexpr char MAX_CONTROL = 0x1f;
+
+constexpr size_t NO_COLON = static_cast<size_t>(-1);
+
+#ifdef TINYHTTP_SCANNER_WITH_VECTORS
+
+constexpr char PADDING = 'x'; // nickeskov: not special, so padding of the last block isn't reported
+
+// nickeskov: blocks are scanned into 64-bit masks, bit i describes byte i of block
+constexpr size_t BLOCK_SIZE = 64;
+
+// nickeskov: terminator is matched by mask shifts, so last bytes of block are matched in next block
+constexpr size_t TERMINATOR_BLOCK_STEP = BLOCK_SIZE - (constants::strings::headers_end.size() - 1);
+
+struct BlockMasks {
+    // cppcheck-suppress unusedStructMember
+    uint64_t cr;
+    // cppcheck-suppress unusedStructMember
+    uint64_t lf;
+    // cppcheck-suppress unusedStructMember
+    uint64_t colon;
+    // cppcheck-suppress unusedStructMember
+    uint64_t invalid; // nickeskov: control characters except HTAB, CR and LF, DEL
+};
+
+#if defined(__AVX2__)
+
+constexpr scanner_kernel KERNEL = scanner_kernel::AVX2;
+
+class Block {
+  public:
+    explicit Block(const char *data) noexcept
+            : low_(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data))),
+              high_(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32))) {}
+
+    [[nodiscard]] uint64_t equal(char symbol) const noexcept {
+        const auto pattern = _mm256_set1_epi8(symbol);
+        return to_mask(_mm256_cmpeq_epi8(low_, pattern), _mm256_cmpeq_epi8(high_, pattern));
+    }
+
+    [[nodiscard]] BlockMasks scan() const noexcept {
+        const auto low = scan_part(low_);
+        const auto high = scan_part(high_);
+
+        // nickeskov: invalid characters are rare, so their mask is built only if block has them
+        return BlockMasks{
+                to_mask(low.cr, high.cr),
+                to_mask(low.lf, high.lf),
+                to_mask(low.colon, high.colon),
+                _mm256_testz_si256(low.invalid, low.invalid) && _mm256_testz_si256(high.invalid, high.invalid)
+                ? 0 : to_mask(low.invalid, high.invalid)
+        };
+    }
+
+  private:
+    struct PartMasks {
+        __m256i cr;
+        __m256i lf;
+        __m256i colon;
+        __m256i invalid;
+    };
+
+    __m256i low_;
+    __m256i high_;
+
+    // nickeskov: invalid mask is combined before movemask, unsigned min keeps obs-text (0x80-0xff) valid
+    static PartMasks scan_part(__m256i part) noexcept {
+        const auto cr = _mm256_cmpeq_epi8(part, _mm256_set1_epi8(CR));
+        const auto lf = _mm256_cmpeq_epi8(part, _mm256_set1_epi8(LF));
+        const auto allowed = _mm256_or_si256(_mm256_or_si256(cr, lf), _mm256_cmpeq_epi8(part, _mm256_set1_epi8(HTAB)));
+        const auto control = _mm256_cmpeq_epi8(_mm256_min_epu8(part, _mm256_set1_epi8(MAX_CONTROL)), part);
+        const auto invalid = _mm256_or_si256(_mm256_andnot_si256(allowed, control),
+                                             _mm256_cmpeq_epi8(part, _mm256_set1_epi8(DEL)));
+        return PartMasks{cr, lf, _mm256_cmpeq_epi8(part, _mm256_set1_epi8(COLON)), invalid};
+    }
+
+    static uint64_t to_mask(__m256i low, __m256i high) noexcept {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(low))
+               | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high))) << 32U);
+    }
+};
+
+#else
+
+constexpr scanner_kernel KERNEL = scanner_kernel::SSE2;
+
+// nickeskov: parts are separate members, so they stay in registers without loop unrolling
+class Block {
+  public:
+    explicit Block(const char *data) noexcept
+            : part0_(load(data)), part1_(load(data + 16)), part2_(load(data + 32)), part3_(load(data + 48)) {}
+
+    [[nodiscard]] uint64_t equal(char symbol) const noexcept {
+        const auto pattern = _mm_set1_epi8(symbol);
+        return to_mask(_mm_cmpeq_epi8(part0_, pattern), _mm_cmpeq_epi8(part1_, pattern),
+                       _mm_cmpeq_epi8(part2_, pattern), _mm_cmpeq_epi8(part3_, pattern));
+    }
+
+    [[nodiscard]] BlockMasks scan() const noexcept {
+        const auto masks0 = scan_part(part0_);
+        const auto masks1 = scan_part(part1_);
+        const auto masks2 = scan_part(part2_);
+        const auto masks3 = scan_part(part3_);
+
+        // nickeskov: invalid characters are rare, so their mask is built only if block has them
+        const auto any_invalid = _mm_or_si128(_mm_or_si128(masks0.invalid, masks1.invalid),
+                                              _mm_or_si128(masks2.invalid, masks3.invalid));
+        return BlockMasks{
+                to_mask(masks0.cr, masks1.cr, masks2.cr, masks3.cr),
+                to_mask(masks0.lf, masks1.lf, masks2.lf, masks3.lf),
+                to_mask(masks0.colon, masks1.colon, masks2.colon, masks3.colon),
+                _mm_movemask_epi8(any_invalid) == 0
+                ? 0 : to_mask(masks0.invalid, masks1.invalid, masks2.invalid, masks3.invalid)
+        };
+    }
+
+  private:
+    struct PartMasks {
+        __m128i cr;
+        __m128i lf;
+        __m128i colon;
+        __m128i invalid;
+    };
+
+    __m128i part0_;
+    __m128i part1_;
+    __m128i part2_;
+    __m128i part3_;
+
+    // nickeskov: invalid mask is combined before movemask, unsigned min keeps obs-text (0x80-0xff) valid
+    static PartMasks scan_part(__m128i part) noexcept {
+        const auto cr = _mm_cmpeq_epi8(part, _mm_set1_epi8(CR));
+        const auto lf = _mm_cmpeq_epi8(part, _mm_set1_epi8(LF));
+        const auto allowed = _mm_or_si128(_mm_or_si128(cr, lf), _mm_cmpeq_epi8(part, _mm_set1_epi8(HTAB)));
+        const auto control = _mm_cmpeq_epi8(_mm_min_epu8(part, _mm_set1_epi8(MAX_CONTROL)), part);
+        const auto invalid = _mm_or_si128(_mm_andnot_si128(allowed, control), _mm_cmpeq_epi8(part, _mm_set1_epi8(DEL)));
+        return PartMasks{cr, lf, _mm_cmpeq_epi8(part, _mm_set1_epi8(COLON)), invalid};
+    }
+
+    static __m128i load(const char *data) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    }
+
+    static uint64_t to_mask(__m128i mask0, __m128i mask1, __m128i mask2, __m128i mask3) noexcept {
+        return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(mask0)))
+               | (static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(mask1))) << 16U)
+               | (static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(mask2))) << 32U)
+               | (static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(mask3))) << 48U);
+    }
+};
+
+#endif
+
+// nickeskov: last incomplete block is copied into padded storage, so all blocks are scanned by one kernel
+class BlockReader {
+  public:
+    explicit BlockReader(std::string_view buffer) noexcept : buffer_(buffer) {}
+
+    // nickeskov: returns pointer instead of block, so vectors are loaded right where they are compared
+    [[nodiscard]] const char *read(size_t pos) noexcept {
+        if (pos + BLOCK_SIZE <= buffer_.size()) {
+            return buffer_.data() + pos;
+        }
+
+        tail_.fill(PADDING);
+        std::memcpy(tail_.data(), buffer_.data() + pos, buffer_.size() - pos);
+        return tail_.data();
+    }
+
+  private:
+    std::string_view buffer_;
+    std::array<char, BLOCK_SIZE> tail_{};
+};
+
+inline size_t lowest_bit(uint64_t mask) noexcept {
+    return static_cast<size_t>(__builtin_ctzll(mask));
+}
+
+// nickeskov: bits of block at pos that are at or after position
+inline uint64_t from_bit(size_t position, size_t pos) noexcept {
+    if (position <= pos) {
+        return ~uint64_t(0);
+    }
+    return position - pos >= BLOCK_SIZE ? 0 : ~uint64_t(0) << (position - pos);
+}
+
+#else
+
+constexpr scanner_kernel KERNEL = scanner_kernel::SCALAR;
+
+enum class symbol_class : uint8_t {
+    OTHER,
+    CR,
+    LF,
+    COLON,
+    INVALID,
+};
+
+constexpr std::array<symbol_class, 256> make_symbol_classes() noexcept {
+    std::array<symbol_class, 256> classes{};
+    for (size_t code = 0; code <= static_cast<unsigned char>(MAX_CONTROL); ++code) {
+        classes[code] = symbol_class::INVALID;
+    }
+    classes[static_cast<unsigned char>(DEL)] = symbol_class::INVALID;
+    classes[static_cast<unsigned char>(HTAB)] = symbol_class::OTHER;
+    classes[static_cast<unsigned char>(CR)] = symbol_class::CR;
+    classes[static_cast<unsigned char>(LF)] = symbol_class::LF;
+    classes[static_cast<unsigned char>(COLON)] = symbol_class::COLON;
+    return classes;
+}
+
+// nickeskov: most bytes are OTHER, so without vectors bytes are skipped by one table lookup
+constexpr auto SYMBOL_CLASSES = make_symbol_classes();
+
+#endif
+
+}
+
+scanner_kernel get_kernel() noexcept {
+    return KERNEL;
+}
+
+const char *to_string(scanner_kernel kernel) noexcept {
+    switch (kernel) {
+        case scanner_kernel::SCALAR: {
+            return "scalar";
+        }
+        case scanner_kernel::SSE2: {
+            return "sse2";
+        }
+        case scanner_kernel::AVX2: {
+            return "avx2";
+        }
+        default: {
+            return "unknown";
+        }
+    }
+}
+
+#ifdef TINYHTTP_SCANNER_WITH_VECTORS
+
+size_t find_headers_end(std::string_view buffer, size_t from) noexcept {
+    BlockReader reader(buffer);
+
+    // nickeskov: only terminators starting in the first TERMINATOR_BLOCK_STEP bytes are complete in block
+    constexpr uint64_t step_bits = (uint64_t(1) << TERMINATOR_BLOCK_STEP) - 1;
+
+    for (size_t pos = from; pos < buffer.size(); pos += TERMINATOR_BLOCK_STEP) {
+        const Block block(reader.read(pos));
+        const auto cr = block.equal(CR);
+        const auto lf = block.equal(LF);
+
+        const auto match = cr & (lf >> 1U) & (cr >> 2U) & (lf >> 3U) & step_bits;
+        if (match != 0) {
+            return pos + lowest_bit(match);
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+ScanResult index_header_lines(std::string_view block, HeaderLine *lines, size_t max_lines) noexcept {
+    constexpr uint64_t high_bit = uint64_t(1) << (BLOCK_SIZE - 1);
+
+    ScanResult result{0, 0, true};
+
+    BlockReader reader(block);
+
+    size_t line_start = 0;
+    size_t colon = NO_COLON;
+    bool is_previous_cr = false; // nickeskov: CR in the last byte of previous block
+
+    for (size_t pos = 0; pos < block.size(); pos += BLOCK_SIZE) {
+        const auto masks = Block(reader.read(pos)).scan();
+
+        const auto size = std::min(BLOCK_SIZE, block.size() - pos);
+        const auto size_bits = size == BLOCK_SIZE ? ~uint64_t(0) : (uint64_t(1) << size) - 1;
+
+        // nickeskov: CR in the last byte is checked with next block, or it ends incomplete line
+        const auto bare_cr = (masks.cr & ~(masks.lf >> 1U) & (size_bits >> 1U))
+                             | static_cast<uint64_t>(is_previous_cr && (masks.lf & 1U) == 0);
+        const auto bare_lf = masks.lf & ~((masks.cr << 1U) | static_cast<uint64_t>(is_previous_cr));
+        const auto bad = masks.invalid | bare_cr | bare_lf;
+
+        is_previous_cr = (masks.cr & high_bit) != 0;
+
+        // nickeskov: scanning may stop before the first bad byte, so it is reported only if it is reached
+        const auto allowed_bits = bad == 0 ? ~uint64_t(0) : (uint64_t(1) << lowest_bit(bad)) - 1;
+
+        // nickeskov: only line ends are iterated, first colon of line is taken from colon mask
+        const auto colons = masks.colon & allowed_bits;
+        for (auto line_ends = masks.lf & allowed_bits; line_ends != 0; line_ends &= line_ends - 1) {
+            const auto bit = lowest_bit(line_ends);
+            const auto event_pos = pos + bit;
+
+            if (colon == NO_COLON) {
+                const auto line_colons = colons & from_bit(line_start, pos) & ((uint64_t(1) << bit) - 1);
+                if (line_colons != 0) {
+                    colon = pos + lowest_bit(line_colons);
+                }
+            }
+
+            const auto line_end = event_pos - 1;
+            if (line_end == line_start) {
+                result.scanned_size = event_pos + 1;
+                return result;
+            }
+            if (result.lines_count == max_lines) {
+                return result;
+            }
+
+            lines[result.lines_count++] = HeaderLine{
+                    static_cast<uint32_t>(line_start),
+                    static_cast<uint32_t>(colon == NO_COLON ? line_end : colon),
+                    static_cast<uint32_t>(line_end)
+            };
+
+            line_start = event_pos + 1;
+            colon = NO_COLON;
+            result.scanned_size = line_start;
+        }
+
+        // nickeskov: line continues in next block
+        if (colon == NO_COLON) {
+            const auto line_colons = colons & from_bit(line_start, pos);
+            if (line_colons != 0) {
+                colon = pos + lowest_bit(line_colons);
+            }
+        }
+
+        if (bad != 0) {
+            result.is_valid = false;
+            return result;
+        }
+    }
+
+    return result;
+}
+
+
+#else
+
+// nickeskov: without vectors libc search is faster than any byte loop
+size_t find_headers_end(std::string_view buffer, size_t from) noexcept {
+    return buffer.find(constants::strings::headers_end, from);
+}
+
+ScanResult index_header_lines(std::string_view block, HeaderLine *lines, size_t max_lines) noexcept {
+    ScanResult result{0, 0, true};
+
+    size_t line_start = 0;
+    size_t colon = NO_COLON;
+
+    for (size_t pos = 0; pos < block.size(); ++pos) {
+        switch (SYMBOL_CLASSES[static_cast<unsigned char>(block[pos])]) {
+            case symbol_class::OTHER: {
+                continue;
+            }
+            case symbol_class::COLON: {
+                if (colon == NO_COLON) {
+                    colon = pos;
+                }
+                continue;
+            }
+            case symbol_class::CR: {
+                // nickeskov: CR in the last byte ends incomplete line
+                if (pos + 1 == block.size()) {
+                    return result;
+                }
+                if (block[pos + 1] != LF) {
+                    result.is_valid = false;
+                    return result;
+                }
+                continue;
+            }
+            case symbol_class::LF: {
+                break;
+            }
+            default: {
+                result.is_valid = false;
+                return result;
+            }
+        }
+
+        if (pos == 0 || block[pos - 1] != CR) {
+            result.is_valid = false;
+            return result;
+        }
+
+        const auto line_end = pos - 1;
+        if (line_end == line_start) {
+            result.scanned_size = pos + 1;
+            return result;
+        }
+        if (result.lines_count == max_lines) {
+            return result;
+        }
+
+        lines[result.lines_count++] = HeaderLine{
+                static_cast<uint32_t>(line_start),
+                static_cast<uint32_t>(colon == NO_COLON ? line_end : colon),
+                static_cast<uint32_t>(line_end)
+        };
+
+        line_start = pos + 1;
+        colon = NO_COLON;
+        result.scanned_size = line_start;
+    }
+
+    return result;
+}
+
+#endif
+
+}
@@ -1,76 +1,111 @@
 #include "tinyhttp/http_headers.h"
 #include "tinyhttp/utils.h"
 #include "tinyhttp/errors.h"
+#include "tinyhttp/header_scanner.h"
 
 #include <algorithm>
+#include <array>
+#include <stdexcept>
 
 namespace tinyhttp {
 
-HttpHeaders::HttpHeaders(std::string_view headers_values_view) {
-    const auto headers_count = std::count(
-            headers_values_view.cbegin(),
-            headers_values_view.cend(),
-            constants::strings::newline.back()
-    );
+namespace {
 
-    reserve(headers_count);
+constexpr size_t INDEX_BATCH_SIZE = 32;
 
-    for (size_t next = headers_values_view.find(constants::strings::newline);
-         next != std::string_view::npos;
-         next = headers_values_view.find(constants::strings::newline)) {
+// nickeskov: keys are stored lowercase, so known headers are written with canonical casing of constants
+inline std::string_view get_canonical_name(std::string_view key) noexcept {
+    const auto well_known = constants::get_well_known_header(key);
+    if (well_known != constants::well_known_header::UNKNOWN_) {
+        return constants::get_well_known_header_text(well_known);
+    }
+    return key;
+}
 
-        const std::string_view header_value_view = headers_values_view.substr(0, next);
-        if (header_value_view.empty()) {
-            break; // if we get "\r\n"
-        }
+}
 
-        size_t colon_pos = header_value_view.find(constants::strings::colon);
-        if (colon_pos == std::string_view::npos) {
+HttpHeaders::HttpHeaders(std::pmr::memory_resource *resource) : headers_(resource) {}
+
+HttpHeaders::HttpHeaders(std::string_view headers_values_view, std::pmr::memory_resource *resource)
+        : headers_(resource) {
+    std::array<scanner::HeaderLine, INDEX_BATCH_SIZE> lines;
+
+    for (;;) {
+        const auto result = scanner::index_header_lines(headers_values_view, lines.data(), lines.size());
+        if (!result.is_valid) {
             throw errors::HttpInvalidHeaders();
         }
 
-        const std::string_view header_view = header_value_view.substr(0, colon_pos);
-        std::string_view value_view;
+        reserve(size() + result.lines_count);
 
-        if (colon_pos + constants::strings::colon.size() < header_value_view.size()) {
-            value_view = header_value_view.substr(colon_pos + constants::strings::colon.size());
+        for (size_t i = 0; i < result.lines_count; ++i) {
+            const auto &line = lines[i];
+            if (line.colon == line.end) {
+                throw errors::HttpInvalidHeaders();
+            }
 
-            const auto not_space_pos = std::min(
-                    value_view.find_first_not_of(constants::strings::space),
-                    value_view.size()
-            );
+            const std::string_view header_view = headers_values_view.substr(line.start, line.colon - line.start);
 
-            value_view.remove_prefix(not_space_pos);
-        }
+            const auto value_start = line.colon + constants::strings::colon.size();
+            std::string_view value_view = headers_values_view.substr(value_start, line.end - value_start);
 
-        headers_.emplace(utils::to_lower(header_view), value_view);
+            while (!value_view.empty() && value_view.front() == constants::strings::space.front()) {
+                value_view.remove_prefix(1);
+            }
 
-        headers_values_view.remove_prefix(next + constants::strings::newline.size());
+            emplace(header_view, value_view);
+        }
+
+        // nickeskov: scanner stops early only if lines are full, otherwise block is done
+        if (result.lines_count < lines.size()) {
+            break;
+        }
+        headers_values_view.remove_prefix(result.scanned_size);
     }
 }
 
-const std::string &HttpHeaders::at(std::string_view header) const {
-    return headers_.at(utils::to_lower(header));
+const std::pmr::string &HttpHeaders::at(std::string_view header) const {
+    return headers_.at(make_key(header));
 }
 
 void HttpHeaders::insert_or_assign(std::string_view header, std::string_view value) {
-    headers_.insert_or_assign(utils::to_lower(header), value);
+    headers_.insert_or_assign(make_key(header), value);
+    set_well_known(header, true);
 }
 
 void HttpHeaders::emplace(std::string_view header, std::string_view value) {
-    headers_.emplace(utils::to_lower(header), value);
+    headers_.emplace(make_key(header), value);
+    set_well_known(header, true);
 }
 
 size_t HttpHeaders::erase(std::string_view header) {
-    return headers_.erase(utils::to_lower(header));
+    const auto erased_count = headers_.erase(make_key(header));
+    set_well_known(header, false);
+    return erased_count;
 }
 
 bool HttpHeaders::contains(std::string_view header) const {
-    return headers_.count(utils::to_lower(header)) != 0;
+    const auto well_known = constants::get_well_known_header(header);
+    if (well_known != constants::well_known_header::UNKNOWN_) {
+        return contains(well_known);
+    }
+    return headers_.count(make_key(header)) != 0;
+}
+
+const std::pmr::string &HttpHeaders::at(constants::well_known_header header) const {
+    if (!contains(header)) {
+        throw std::out_of_range("header not exists");
+    }
+    return headers_.at(make_key(constants::get_well_known_header_text(header)));
+}
+
+bool HttpHeaders::contains(constants::well_known_header header) const noexcept {
+    return well_known_headers_[static_cast<size_t>(header)];
 }
 
 void HttpHeaders::clear() noexcept {
     headers_.clear();
+    well_known_headers_.reset();
 }
 
 size_t HttpHeaders::size() const noexcept {
@@ -109,12 +144,16 @@ HttpHeaders::headers_storage_t::const_iterator HttpHeaders::cend() const noexcep
     return headers_.cend();
 }
 
+std::pmr::memory_resource *HttpHeaders::get_memory_resource() const noexcept {
+    return headers_.get_allocator().resource();
+}
+
 std::string HttpHeaders::to_string() const {
     std::string buf;
 
     if (!headers_.empty()) {
         for (const auto &[header, value] : headers_) {
-            buf += header;
+            buf += get_canonical_name(header);
             buf += constants::strings::colon;
             buf += constants::strings::space;
             buf += value;
@@ -127,4 +166,27 @@ std::string HttpHeaders::to_string() const {
     return buf;
 }
 
+void HttpHeaders::append_to(std::string &buf) const {
+    for (const auto &[header, value] : headers_) {
+        buf += get_canonical_name(header);
+        buf += constants::strings::colon;
+        buf += constants::strings::space;
+        buf += value;
+        buf += constants::strings::newline;
+    }
+}
+
+void HttpHeaders::set_well_known(std::string_view header, bool is_present) noexcept {
+    const auto well_known = constants::get_well_known_header(header);
+    if (well_known != constants::well_known_header::UNKNOWN_) {
+        well_known_headers_.set(static_cast<size_t>(well_known), is_present);
+    }
+}
+
+std::pmr::string HttpHeaders::make_key(std::string_view header) const {
+    std::pmr::string key(header, headers_.get_allocator());
+    std::transform(key.begin(), key.end(), key.begin(), utils::to_lower_ascii);
+    return key;
+}
+
 }
@@ -6,7 +6,10 @@
 
 namespace tinyhttp {
 
-HttpQueryParameters::HttpQueryParameters(std::string_view query_string) {
+HttpQueryParameters::HttpQueryParameters(std::pmr::memory_resource *resource) : parameters_(resource) {}
+
+HttpQueryParameters::HttpQueryParameters(std::string_view query_string, std::pmr::memory_resource *resource)
+        : parameters_(resource) {
     if (query_string.empty()) {
         return;
     }
@@ -47,24 +50,24 @@ HttpQueryParameters::HttpQueryParameters(std::string_view query_string) {
     }
 }
 
-const std::string &HttpQueryParameters::at(std::string_view key) const {
-    return parameters_.at(std::string(key));
+const std::pmr::string &HttpQueryParameters::at(std::string_view key) const {
+    return parameters_.at(make_key(key));
 }
 
 void HttpQueryParameters::insert_or_assign(std::string_view key, std::string_view value) {
-    parameters_.insert_or_assign(std::string(key), value);
+    parameters_.insert_or_assign(make_key(key), value);
 }
 
 void HttpQueryParameters::emplace(std::string_view key, std::string_view value) {
-    parameters_.emplace(std::string(key), value);
+    parameters_.emplace(make_key(key), value);
 }
 
 size_t HttpQueryParameters::erase(std::string_view key) {
-    return parameters_.erase(std::string(key));
+    return parameters_.erase(make_key(key));
 }
 
 bool HttpQueryParameters::contains(std::string_view key) const {
-    return parameters_.count(std::string(key)) != 0;
+    return parameters_.count(make_key(key)) != 0;
 }
 
 void HttpQueryParameters::clear() noexcept {
@@ -107,6 +110,10 @@ HttpQueryParameters::param_storage_t::const_iterator HttpQueryParameters::cend()
     return parameters_.cend();
 }
 
+std::pmr::memory_resource *HttpQueryParameters::get_memory_resource() const noexcept {
+    return parameters_.get_allocator().resource();
+}
+
 std::string HttpQueryParameters::to_string() const {
     std::string buf;
 
@@ -125,4 +132,8 @@ std::string HttpQueryParameters::to_string() const {
     return buf;
 }
 
+std::pmr::string HttpQueryParameters::make_key(std::string_view key) const {
+    return std::pmr::string(key, parameters_.get_allocator());
+}
+
 }
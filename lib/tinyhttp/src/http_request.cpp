@@ -9,11 +9,18 @@ using namespace tinyhttp::constants;
 
 // cppcheck-suppress passedByValue ; passing by value and move
 HttpRequest::HttpRequest(HttpRequestLine request_line, HttpHeaders headers)
-        : request_line_(std::move(request_line)), headers_(std::move(headers)) {}
+        : request_line_(std::move(request_line)), headers_(std::move(headers)),
+          body_(headers_.get_memory_resource()) {}
 
 // cppcheck-suppress passedByValue ; passing by value and move
 HttpRequest::HttpRequest(HttpRequestLine request_line, HttpHeaders headers, std::string_view body)
-        : request_line_(std::move(request_line)), headers_(std::move(headers)), body_(body) {}
+        : request_line_(std::move(request_line)), headers_(std::move(headers)),
+          body_(body, headers_.get_memory_resource()) {}
+
+HttpRequest::HttpRequest(const HttpRequestView &request_view)
+        : request_line_(request_view.get_request_line(), request_view.get_memory_resource()),
+          headers_(request_view.get_raw_headers(), request_view.get_memory_resource()),
+          body_(request_view.get_body(), request_view.get_memory_resource()) {}
 
 HttpRequestLine &HttpRequest::get_request_line() noexcept {
     return request_line_;
@@ -31,11 +38,11 @@ const HttpHeaders &HttpRequest::get_headers() const noexcept {
     return headers_;
 }
 
-std::string &HttpRequest::get_body() noexcept {
+std::pmr::string &HttpRequest::get_body() noexcept {
     return body_;
 }
 
-const std::string &HttpRequest::get_body() const noexcept {
+const std::pmr::string &HttpRequest::get_body() const noexcept {
     return body_;
 }
 
@@ -43,7 +50,7 @@ void HttpRequest::set_body(std::string_view body) {
     body_ = body;
 }
 
-void HttpRequest::set_body(std::string &&body) noexcept {
+void HttpRequest::set_body(std::pmr::string &&body) {
     body_ = std::move(body);
 }
 
@@ -51,6 +58,10 @@ size_t HttpRequest::get_content_length() const noexcept {
     return body_.size();
 }
 
+std::pmr::memory_resource *HttpRequest::get_memory_resource() const noexcept {
+    return headers_.get_memory_resource();
+}
+
 std::string HttpRequest::to_string() const {
     std::string buf;
     buf.reserve(body_.size());
@@ -7,7 +7,8 @@
 
 namespace tinyhttp {
 
-HttpRequestLine::HttpRequestLine(std::string_view request_line) {
+HttpRequestLine::HttpRequestLine(std::string_view request_line, std::pmr::memory_resource *resource)
+        : url_(resource), query_params_(resource) {
     request_line = request_line.substr(0, request_line.find(constants::strings::newline));
 
     auto space_pos = request_line.find(constants::strings::space);
@@ -31,7 +32,7 @@ HttpRequestLine::HttpRequestLine(std::string_view request_line) {
         throw errors::HttpInvalidRequestLine();
     }
 
-    url_ = utils::decode_url(request_line.substr(0, space_pos));
+    url_.assign(utils::decode_url(request_line.substr(0, space_pos)));
     request_line.remove_prefix(space_pos + constants::strings::space.size());
 
     auto question_pos = url_.find(constants::strings::question);
@@ -41,9 +42,9 @@ HttpRequestLine::HttpRequestLine(std::string_view request_line) {
         query_string_view = query_string_view.substr(
                 question_pos + constants::strings::question.size());
 
-        query_params_ = HttpQueryParameters(query_string_view);
+        query_params_ = HttpQueryParameters(query_string_view, resource);
 
-        url_ = url_.substr(0, question_pos);
+        url_.resize(question_pos);
     }
 
     auto slash_pos = request_line.find(constants::strings::slash);
@@ -69,7 +70,7 @@ constants::http_method HttpRequestLine::get_method() const {
     return method_;
 }
 
-const std::string &HttpRequestLine::get_url() const {
+const std::pmr::string &HttpRequestLine::get_url() const {
     return url_;
 }
 
@@ -0,0 +1,437 @@
+#include "tinyhttp/http_request_parser.h"
+#include "tinyhttp/constants.h"
+#include "tinyhttp/errors.h"
+#include "tinyhttp/header_scanner.h"
+#include "tinyhttp/utils.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+namespace tinyhttp {
+
+namespace {
+
+constexpr std::string_view http_version_prefix = "HTTP/";
+constexpr std::string_view optional_whitespace = " \t";
+constexpr std::string_view chunk_extension_start = ";";
+constexpr size_t MAX_CHUNK_LINE_SIZE = 4096;
+
+inline bool is_optional_whitespace(char symbol) noexcept {
+    return symbol == optional_whitespace[0] || symbol == optional_whitespace[1];
+}
+
+// nickeskov: plain loops, values usually have one leading space and find_first_not_of is too heavy for it
+std::string_view trim_whitespace(std::string_view view) noexcept {
+    while (!view.empty() && is_optional_whitespace(view.front())) {
+        view.remove_prefix(1);
+    }
+    while (!view.empty() && is_optional_whitespace(view.back())) {
+        view.remove_suffix(1);
+    }
+    return view;
+}
+
+}
+
+HttpRequestParser::parse_status HttpRequestParser::parse(std::string &buffer) {
+    request_.buffer_ = buffer;
+    buffer_size_ = buffer.size();
+
+    if (!is_headers_parsed_) {
+        // RFC 7230, 3.5: server should ignore empty lines received prior to the request line
+        while (buffer.substr(request_start_, constants::strings::newline.size()) == constants::strings::newline) {
+            request_start_ += constants::strings::newline.size();
+        }
+
+        size_t scan_from = std::max(scanned_size_, request_start_);
+        if (scan_from >= request_start_ + constants::strings::headers_end.size()) {
+            // nickeskov: terminator can be split between reads
+            scan_from -= constants::strings::headers_end.size() - 1;
+        }
+
+        const auto headers_end_pos = scanner::find_headers_end(buffer, scan_from);
+        if (headers_end_pos == std::string_view::npos) {
+            // nickeskov: otherwise client, which never ends headers, grows buffer until header timeout
+            if (max_headers_size_ != 0 && buffer.size() - request_start_ > max_headers_size_) {
+                throw errors::HttpStandardError(constants::http_response_status::RequestHeaderFieldsTooLarge);
+            }
+            scanned_size_ = buffer.size();
+            return parse_status::INCOMPLETE;
+        }
+
+        const auto headers_size = headers_end_pos + constants::strings::headers_end.size() - request_start_;
+        if ((max_headers_size_ != 0 && headers_size > max_headers_size_)
+            || headers_end_pos + constants::strings::headers_end.size() > std::numeric_limits<uint32_t>::max()) {
+            throw errors::HttpStandardError(constants::http_response_status::RequestHeaderFieldsTooLarge);
+        }
+
+        const auto request_line_end = buffer.find(constants::strings::newline, request_start_);
+
+        parse_request_line(request_line_end);
+        parse_headers(request_line_end + constants::strings::newline.size(),
+                      headers_end_pos + constants::strings::newline.size());
+        parse_body_length(headers_end_pos + constants::strings::headers_end.size());
+
+        scanned_size_ = buffer.size();
+        is_headers_parsed_ = true;
+    }
+
+    if (is_chunked_ || is_body_streamed_) {
+        return decode_body(buffer) ? parse_status::COMPLETE : parse_status::INCOMPLETE;
+    }
+
+    if (buffer.size() < request_.size()) {
+        return parse_status::INCOMPLETE;
+    }
+
+    return parse_status::COMPLETE;
+}
+
+const HttpRequestView &HttpRequestParser::get_request() const noexcept {
+    return request_;
+}
+
+bool HttpRequestParser::is_headers_parsed() const noexcept {
+    return is_headers_parsed_;
+}
+
+size_t HttpRequestParser::get_missing_size() const noexcept {
+    if (is_chunked_ || is_body_streamed_) {
+        if (chunk_state_ != chunk_state::DATA) {
+            return 0;
+        }
+        return is_chunked_ ? chunk_remaining_ + constants::strings::newline.size() : chunk_remaining_;
+    }
+    if (!is_headers_parsed_ || buffer_size_ >= request_.size()) {
+        return 0;
+    }
+    return request_.size() - buffer_size_;
+}
+
+void HttpRequestParser::set_memory_resource(std::pmr::memory_resource *resource) noexcept {
+    request_.resource_ = resource;
+}
+
+void HttpRequestParser::set_max_body_size(size_t max_body_size) noexcept {
+    max_body_size_ = max_body_size;
+}
+
+void HttpRequestParser::set_max_headers_size(size_t max_headers_size) noexcept {
+    max_headers_size_ = max_headers_size;
+}
+
+void HttpRequestParser::stream_body() noexcept {
+    if (is_body_streamed_) {
+        return;
+    }
+    is_body_streamed_ = true;
+
+    if (is_chunked_) {
+        return;
+    }
+
+    // nickeskov: body with Content-Length is decoded as one chunk without framing
+    chunk_pos_ = request_.body_.pos;
+    chunk_remaining_ = request_.body_.len;
+    chunk_state_ = chunk_remaining_ > 0 ? chunk_state::DATA : chunk_state::DONE;
+    request_.body_.len = 0;
+    request_.size_ = request_.body_.pos;
+}
+
+void HttpRequestParser::consume_body(std::string &buffer) {
+    const auto body_pos = request_.body_.pos;
+
+    buffer.erase(body_pos, chunk_pos_ - body_pos);
+    request_.buffer_ = buffer;
+    request_.body_.len = 0;
+    chunk_pos_ = body_pos;
+
+    if (chunk_state_ == chunk_state::DONE) {
+        request_.size_ = static_cast<uint32_t>(chunk_pos_);
+    }
+}
+
+bool HttpRequestParser::is_body_streamed() const noexcept {
+    return is_body_streamed_;
+}
+
+bool HttpRequestParser::is_body_finished() const noexcept {
+    if (is_chunked_ || is_body_streamed_) {
+        return chunk_state_ == chunk_state::DONE;
+    }
+    return is_headers_parsed_ && buffer_size_ >= request_.size();
+}
+
+void HttpRequestParser::reset() noexcept {
+    request_.headers_count_ = 0;
+    request_.well_known_headers_.fill(0);
+    request_.body_ = {};
+    request_.size_ = 0;
+    request_start_ = 0;
+    scanned_size_ = 0;
+    buffer_size_ = 0;
+    is_headers_parsed_ = false;
+    body_size_ = 0;
+    is_chunked_ = false;
+    is_body_streamed_ = false;
+    chunk_state_ = chunk_state::SIZE;
+    chunk_pos_ = 0;
+    chunk_remaining_ = 0;
+}
+
+void HttpRequestParser::parse_request_line(size_t line_end) {
+    const auto &buffer = request_.buffer_;
+
+    auto request_line = buffer.substr(request_start_, line_end - request_start_);
+
+    request_.request_line_ = {static_cast<uint32_t>(request_start_), static_cast<uint32_t>(request_line.size())};
+
+    const auto method_end = request_line.find(constants::strings::space);
+    if (method_end == std::string_view::npos) {
+        throw errors::HttpInvalidRequestLine();
+    }
+
+    request_.method_ = constants::get_http_method_code(request_line.substr(0, method_end));
+    if (request_.method_ == constants::http_method::UNSUPPORTED_) {
+        throw errors::HttpMethodInvalid();
+    }
+
+    const auto target_start = method_end + constants::strings::space.size();
+    const auto target_end = request_line.find(constants::strings::space, target_start);
+    if (target_end == std::string_view::npos || target_end == target_start) {
+        throw errors::HttpInvalidRequestLine();
+    }
+
+    const auto target = request_line.substr(target_start, target_end - target_start);
+    const auto target_pos = static_cast<uint32_t>(request_start_ + target_start);
+
+    const auto question_pos = target.find(constants::strings::question);
+    if (question_pos == std::string_view::npos) {
+        request_.path_ = {target_pos, static_cast<uint32_t>(target.size())};
+        request_.query_string_ = {};
+    } else {
+        const auto query_pos = question_pos + constants::strings::question.size();
+        request_.path_ = {target_pos, static_cast<uint32_t>(question_pos)};
+        request_.query_string_ = {static_cast<uint32_t>(target_pos + query_pos),
+                                  static_cast<uint32_t>(target.size() - query_pos)};
+    }
+
+    const auto version = request_line.substr(target_end + constants::strings::space.size());
+    if (version.substr(0, http_version_prefix.size()) != http_version_prefix) {
+        throw errors::HttpVersionInvalid();
+    }
+
+    request_.version_ = constants::get_http_version_code(version.substr(http_version_prefix.size()));
+    if (request_.version_ == constants::http_version::UNSUPPORTED_) {
+        throw errors::HttpVersionInvalid();
+    }
+}
+
+void HttpRequestParser::parse_headers(size_t headers_start, size_t headers_end) {
+    const auto &buffer = request_.buffer_;
+    const auto block = buffer.substr(headers_start, headers_end - headers_start);
+
+    request_.raw_headers_ = {static_cast<uint32_t>(headers_start), static_cast<uint32_t>(block.size())};
+    request_.headers_count_ = 0;
+    request_.well_known_headers_.fill(0);
+
+    std::array<scanner::HeaderLine, HttpRequestView::MAX_HEADERS_COUNT> lines;
+    const auto result = scanner::index_header_lines(block, lines.data(), lines.size());
+
+    if (!result.is_valid) {
+        throw errors::HttpInvalidHeaders();
+    }
+    // nickeskov: block has only complete lines without empty one, so unscanned lines are over limit
+    if (result.scanned_size != block.size()) {
+        throw errors::HttpStandardError(constants::http_response_status::RequestHeaderFieldsTooLarge);
+    }
+
+    for (size_t i = 0; i < result.lines_count; ++i) {
+        const auto &line = lines[i];
+
+        // RFC 7230, 3.2.4: whitespace between field name and colon must be rejected
+        if (line.colon == line.end || line.colon == line.start
+            || is_optional_whitespace(block[line.colon - 1])) {
+            throw errors::HttpInvalidHeaders();
+        }
+
+        const auto value_start = line.colon + constants::strings::colon.size();
+        const auto value = trim_whitespace(block.substr(value_start, line.end - value_start));
+
+        const auto name = block.substr(line.start, line.colon - line.start);
+
+        // nickeskov: the first header wins, like in lookup by name
+        const auto well_known = constants::get_well_known_header(name);
+        auto &slot = request_.well_known_headers_[static_cast<size_t>(well_known)];
+        if (well_known != constants::well_known_header::UNKNOWN_ && slot == 0) {
+            slot = static_cast<uint8_t>(request_.headers_count_ + 1);
+        }
+
+        auto &header = request_.headers_[request_.headers_count_++];
+        header.name = {static_cast<uint32_t>(headers_start + line.start), static_cast<uint32_t>(name.size())};
+        header.value = {static_cast<uint32_t>(value.data() - buffer.data()), static_cast<uint32_t>(value.size())};
+    }
+}
+
+void HttpRequestParser::parse_body_length(size_t body_start) {
+    request_.body_ = {static_cast<uint32_t>(body_start), 0};
+    request_.size_ = static_cast<uint32_t>(body_start);
+
+    const auto transfer_encoding = request_.get_header(constants::well_known_header::TRANSFER_ENCODING);
+    if (!transfer_encoding.empty()) {
+        // RFC 7230, 3.3.3: message with both Transfer-Encoding and Content-Length may be
+        // request smuggling attempt, HTTP/1.0 recipient may not understand Transfer-Encoding
+        if (request_.contains(constants::well_known_header::CONTENT_LENGTH)
+            || request_.version_ != constants::http_version::V1_1) {
+            throw errors::HttpInvalidHeaders();
+        }
+        // RFC 7230, 3.3.1: 501 for unknown transfer codings, only chunked is supported
+        if (!utils::iequals(transfer_encoding, constants::transfer_codings::chunked)) {
+            throw errors::HttpNotImplemented();
+        }
+
+        is_chunked_ = true;
+        chunk_pos_ = body_start;
+        return;
+    }
+
+    if (!request_.contains(constants::well_known_header::CONTENT_LENGTH)) {
+        return;
+    }
+
+    const auto content_length_text = request_.get_header(constants::well_known_header::CONTENT_LENGTH);
+
+    // nickeskov: from_chars for unsigned type rejects signs, so negative length is invalid
+    uint64_t content_length = 0;
+    const auto text_end = content_length_text.data() + content_length_text.size();
+    const auto[parsed_end, error_code] = std::from_chars(content_length_text.data(), text_end, content_length);
+
+    if (error_code != std::errc() || parsed_end != text_end) {
+        throw errors::HttpInvalidHeaders();
+    }
+
+    if (content_length > std::numeric_limits<uint32_t>::max() - body_start
+        || (max_body_size_ != 0 && content_length > max_body_size_)) {
+        throw errors::HttpStandardError(constants::http_response_status::RequestEntityTooLarge);
+    }
+
+    request_.body_.len = static_cast<uint32_t>(content_length);
+    request_.size_ += request_.body_.len;
+}
+
+bool HttpRequestParser::decode_body(std::string &buffer) {
+    for (;;) {
+        switch (chunk_state_) {
+            case chunk_state::SIZE: {
+                const auto line_end = find_chunk_line_end(buffer);
+                if (line_end == std::string_view::npos) {
+                    return false;
+                }
+
+                // RFC 7230, 4.1: chunk-size [ chunk-ext ] CRLF, extensions are ignored
+                auto line = std::string_view(buffer).substr(chunk_pos_, line_end - chunk_pos_);
+                line = trim_whitespace(line.substr(0, line.find(chunk_extension_start)));
+
+                uint64_t chunk_size = 0;
+                const auto line_last = line.data() + line.size();
+                const auto[parsed_end, error_code] = std::from_chars(line.data(), line_last, chunk_size, 16);
+
+                if (error_code == std::errc::result_out_of_range) {
+                    throw errors::HttpStandardError(constants::http_response_status::RequestEntityTooLarge);
+                }
+                if (error_code != std::errc() || parsed_end != line_last) {
+                    throw errors::HttpInvalidChunkedBody();
+                }
+
+                chunk_pos_ = line_end + constants::strings::newline.size();
+
+                if (chunk_size > std::numeric_limits<uint32_t>::max() - chunk_pos_
+                    || (max_body_size_ != 0 && chunk_size > max_body_size_ - body_size_)) {
+                    throw errors::HttpStandardError(constants::http_response_status::RequestEntityTooLarge);
+                }
+
+                body_size_ += static_cast<size_t>(chunk_size);
+                chunk_remaining_ = static_cast<size_t>(chunk_size);
+                chunk_state_ = chunk_size == 0 ? chunk_state::TRAILERS : chunk_state::DATA;
+                break;
+            }
+            case chunk_state::DATA: {
+                const auto size = std::min(buffer.size() - chunk_pos_, chunk_remaining_);
+                const auto body_end = request_.body_.pos + request_.body_.len;
+
+                // nickeskov: decoded body end never passes chunk_pos_, so ranges may only overlap
+                if (size > 0 && body_end != chunk_pos_) {
+                    std::memmove(buffer.data() + body_end, buffer.data() + chunk_pos_, size);
+                }
+
+                request_.body_.len += static_cast<uint32_t>(size);
+                chunk_pos_ += size;
+                chunk_remaining_ -= size;
+
+                if (chunk_remaining_ > 0) {
+                    return false;
+                }
+                if (!is_chunked_) {
+                    request_.size_ = static_cast<uint32_t>(chunk_pos_);
+                    chunk_state_ = chunk_state::DONE;
+                    break;
+                }
+                chunk_state_ = chunk_state::DATA_END;
+                break;
+            }
+            case chunk_state::DATA_END: {
+                if (buffer.size() - chunk_pos_ < constants::strings::newline.size()) {
+                    return false;
+                }
+                if (std::string_view(buffer).substr(chunk_pos_, constants::strings::newline.size())
+                    != constants::strings::newline) {
+                    throw errors::HttpInvalidChunkedBody();
+                }
+
+                chunk_pos_ += constants::strings::newline.size();
+                chunk_state_ = chunk_state::SIZE;
+                break;
+            }
+            case chunk_state::TRAILERS: {
+                const auto line_end = find_chunk_line_end(buffer);
+                if (line_end == std::string_view::npos) {
+                    return false;
+                }
+
+                // nickeskov: trailer fields are skipped, empty line ends the request
+                const bool is_last_line = line_end == chunk_pos_;
+                chunk_pos_ = line_end + constants::strings::newline.size();
+
+                if (is_last_line) {
+                    request_.size_ = static_cast<uint32_t>(chunk_pos_);
+                    chunk_state_ = chunk_state::DONE;
+                }
+                break;
+            }
+            case chunk_state::DONE: {
+                return true;
+            }
+        }
+    }
+}
+
+size_t HttpRequestParser::find_chunk_line_end(std::string_view buffer) const {
+    const auto line_end = buffer.find(constants::strings::newline, chunk_pos_);
+
+    if (line_end == std::string_view::npos) {
+        if (buffer.size() - chunk_pos_ > MAX_CHUNK_LINE_SIZE) {
+            throw errors::HttpInvalidChunkedBody();
+        }
+        return std::string_view::npos;
+    }
+    if (line_end - chunk_pos_ > MAX_CHUNK_LINE_SIZE
+        || line_end + constants::strings::newline.size() > std::numeric_limits<uint32_t>::max()) {
+        throw errors::HttpInvalidChunkedBody();
+    }
+    return line_end;
+}
+
+}
@@ -0,0 +1,107 @@
+#include "tinyhttp/http_request_view.h"
+#include "tinyhttp/utils.h"
+
+namespace tinyhttp {
+
+constants::http_method HttpRequestView::get_method() const noexcept {
+    return method_;
+}
+
+constants::http_version HttpRequestView::get_version() const noexcept {
+    return version_;
+}
+
+std::string_view HttpRequestView::get_request_line() const noexcept {
+    return view(request_line_);
+}
+
+std::string_view HttpRequestView::get_path() const noexcept {
+    return view(path_);
+}
+
+std::string_view HttpRequestView::get_query_string() const noexcept {
+    return view(query_string_);
+}
+
+std::string HttpRequestView::decode_path() const {
+    if (!is_path_encoded()) {
+        return std::string(get_path());
+    }
+    return utils::decode_url(get_path());
+}
+
+bool HttpRequestView::is_path_encoded() const noexcept {
+    const auto path = get_path();
+    return path.find_first_of("%+") != std::string_view::npos;
+}
+
+size_t HttpRequestView::headers_count() const noexcept {
+    return headers_count_;
+}
+
+HttpRequestView::Header HttpRequestView::get_header(size_t index) const noexcept {
+    return Header{view(headers_[index].name), view(headers_[index].value)};
+}
+
+std::string_view HttpRequestView::get_header(std::string_view name) const noexcept {
+    const auto well_known = constants::get_well_known_header(name);
+    if (well_known != constants::well_known_header::UNKNOWN_) {
+        return get_header(well_known);
+    }
+
+    for (size_t i = 0; i < headers_count_; ++i) {
+        if (utils::iequals(view(headers_[i].name), name)) {
+            return view(headers_[i].value);
+        }
+    }
+    return {};
+}
+
+bool HttpRequestView::contains(std::string_view name) const noexcept {
+    const auto well_known = constants::get_well_known_header(name);
+    if (well_known != constants::well_known_header::UNKNOWN_) {
+        return contains(well_known);
+    }
+
+    for (size_t i = 0; i < headers_count_; ++i) {
+        if (utils::iequals(view(headers_[i].name), name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view HttpRequestView::get_header(constants::well_known_header header) const noexcept {
+    const auto slot = well_known_headers_[static_cast<size_t>(header)];
+    return slot == 0 ? std::string_view() : view(headers_[slot - 1].value);
+}
+
+bool HttpRequestView::contains(constants::well_known_header header) const noexcept {
+    return well_known_headers_[static_cast<size_t>(header)] != 0;
+}
+
+std::string_view HttpRequestView::get_raw_headers() const noexcept {
+    return view(raw_headers_);
+}
+
+std::string_view HttpRequestView::get_body() const noexcept {
+    return view(body_);
+}
+
+std::pmr::memory_resource *HttpRequestView::get_memory_resource() const noexcept {
+    return resource_;
+}
+
+size_t HttpRequestView::get_content_length() const noexcept {
+    return body_.len;
+}
+
+size_t HttpRequestView::size() const noexcept {
+    return size_;
+}
+
+std::string_view HttpRequestView::view(HttpRequestView::Span span) const noexcept {
+    return buffer_.substr(span.pos, span.len);
+}
+
+}
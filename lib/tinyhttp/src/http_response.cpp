@@ -5,13 +5,19 @@
 
 namespace tinyhttp {
 
-HttpResponse::HttpResponse() {
+namespace {
+
+constexpr size_t HEAD_SIZE_HINT = 512;
+
+}
+
+HttpResponse::HttpResponse(std::pmr::memory_resource *resource) : headers_(resource), body_(resource) {
     set_basic_headers();
 }
 
 HttpResponse::HttpResponse(constants::http_response_status response_status,
-                           constants::http_version http_version)
-        : response_line_(response_status, http_version) {
+                           constants::http_version http_version, std::pmr::memory_resource *resource)
+        : response_line_(response_status, http_version), headers_(resource), body_(resource) {
     set_basic_headers();
 }
 
@@ -44,7 +50,7 @@ void HttpResponse::set_headers(const HttpHeaders &headers) {
     headers_ = headers;
 }
 
-const std::string &HttpResponse::get_body() const noexcept {
+const std::pmr::string &HttpResponse::get_body() const noexcept {
     return body_;
 }
 
@@ -59,6 +65,16 @@ void HttpResponse::append_to_body(std::string_view part) {
                               std::to_string(body_.size()));
 }
 
+const HttpResponse::body_producer_t &HttpResponse::get_body_producer() const noexcept {
+    return body_producer_;
+}
+
+void HttpResponse::set_body_producer(HttpResponse::body_producer_t &&producer) {
+    body_.clear();
+    headers_.erase(constants::headers::content_length);
+    body_producer_ = std::move(producer);
+}
+
 const HttpResponse::response_sender_t &HttpResponse::get_sender() const noexcept {
     return sender_;
 }
@@ -71,30 +87,56 @@ void HttpResponse::set_sender(HttpResponse::response_sender_t &&sender) {
     sender_ = std::move(sender);
 }
 
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+const HttpResponse::async_response_sender_t &HttpResponse::get_async_sender() const noexcept {
+    return async_sender_;
+}
+
+void HttpResponse::set_async_sender(HttpResponse::async_response_sender_t &&sender) {
+    async_sender_ = std::move(sender);
+}
+
+#endif
+
+std::pmr::memory_resource *HttpResponse::get_memory_resource() const noexcept {
+    return headers_.get_memory_resource();
+}
+
 std::string HttpResponse::to_string() const {
     std::string buf;
-    buf.reserve(body_.size());
+    buf.reserve(body_.size() + HEAD_SIZE_HINT);
+
+    serialize_head(buf);
+
+    buf += body_;
+
+    return buf;
+}
+
+void HttpResponse::serialize_head(std::string &buf) const {
+    serialize_head(buf, std::string_view());
+}
 
-    buf += response_line_.to_string();
+void HttpResponse::serialize_head(std::string &buf, std::string_view raw_headers) const {
+    response_line_.append_to(buf);
 
     buf += constants::strings::newline;
 
-    buf += headers_.to_string();
+    // nickeskov: Server and Date headers are preformatted and cached, they are not stored in headers_
+    buf += utils::get_cached_basic_headers();
 
-    buf += constants::strings::headers_end;
+    headers_.append_to(buf);
 
-    buf += body_;
+    buf += raw_headers;
 
-    return buf;
+    buf += constants::strings::newline;
 }
 
 void HttpResponse::set_basic_headers() {
-    headers_.emplace(constants::headers::server, constants::server_name);
-    headers_.emplace(constants::headers::date, utils::get_date_http_str());
-
-    // TODO(nickeskov): hardcoded connection type
+    // nickeskov: connection type may be overridden by worker if connection is persistent
     if (response_line_.get_http_version() > constants::http_version::V0_9) {
-        headers_.emplace(constants::headers::connection, "closed");
+        headers_.emplace(constants::headers::connection, constants::connection_types::close);
     }
 }
 
@@ -27,26 +27,30 @@ void HttpResponseLine::set_response_status(constants::http_response_status respo
 }
 
 std::string HttpResponseLine::to_string() const {
+    std::string response_line;
+
+    append_to(response_line);
+
+    return response_line;
+}
+
+void HttpResponseLine::append_to(std::string &buf) const {
     auto version_text = constants::get_http_version_text(http_version_);
     if (version_text.empty()) {
         throw errors::HttpVersionInvalid();
     }
 
-    std::string response_line;
-
-    response_line += constants::strings::http_upper;
-    response_line += constants::strings::slash;
-    response_line += version_text;
+    buf += constants::strings::http_upper;
+    buf += constants::strings::slash;
+    buf += version_text;
 
-    response_line += constants::strings::space;
+    buf += constants::strings::space;
 
-    response_line += std::to_string(static_cast<uint16_t>(response_status_));
+    buf += std::to_string(static_cast<uint16_t>(response_status_));
 
-    response_line += constants::strings::space;
+    buf += constants::strings::space;
 
-    response_line += constants::get_http_response_status_text(response_status_);
-
-    return response_line;
+    buf += constants::get_http_response_status_text(response_status_);
 }
 
 }
@@ -0,0 +1,101 @@
+#include "tinyhttp/iovec_writer.h"
+#include "coroutine/coroutine.h"
+
+#include <stdexcept>
+
+namespace tinyhttp {
+
+void IovecWriter::append(std::string_view part) {
+    if (part.empty()) {
+        return;
+    }
+
+    if (parts_count_ == parts_.size()) {
+        throw std::length_error("too many parts for IovecWriter, max_parts_count="
+                                + std::to_string(MAX_PARTS_COUNT));
+    }
+
+    // nickeskov: iovec is a C structure, so iov_base can't be const
+    parts_[parts_count_++] = iovec{const_cast<char *>(part.data()), part.size()};
+    remaining_size_ += part.size();
+}
+
+ssize_t IovecWriter::write_to(Connection &connection, int flags) {
+    if (empty()) {
+        return 0;
+    }
+
+    ssize_t bytes = connection.writev(parts_.data() + first_part_, parts_count_ - first_part_, flags);
+    if (bytes > 0) {
+        consume(static_cast<size_t>(bytes));
+    }
+    return bytes;
+}
+
+void IovecWriter::flush(Connection &connection, int flags) {
+    while (!empty()) {
+        auto bytes = write_to(connection, flags);
+
+        if (bytes < 0) {
+            coroutine::yield();
+            continue;
+        }
+
+        if (!empty() && !connection.is_edge_triggered()) {
+            coroutine::yield(); // nickeskov: using level triggered mode
+        }
+    }
+}
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+Task<> IovecWriter::flush_async(Connection &connection, int flags) {
+    while (!empty()) {
+        auto bytes = write_to(connection, flags);
+
+        // nickeskov: in level triggered mode next event is awaited after partial write too
+        if (bytes < 0 || (!empty() && !connection.is_edge_triggered())) {
+            co_await connection.wait_io();
+        }
+    }
+}
+
+#endif
+
+bool IovecWriter::empty() const noexcept {
+    return remaining_size_ == 0;
+}
+
+size_t IovecWriter::remaining_size() const noexcept {
+    return remaining_size_;
+}
+
+void IovecWriter::clear() noexcept {
+    first_part_ = 0;
+    parts_count_ = 0;
+    remaining_size_ = 0;
+}
+
+void IovecWriter::consume(size_t bytes) noexcept {
+    remaining_size_ -= bytes;
+
+    while (bytes > 0) {
+        auto &part = parts_[first_part_];
+
+        if (bytes < part.iov_len) {
+            // nickeskov: partial write, next call starts from the middle of this part
+            part.iov_base = static_cast<char *>(part.iov_base) + bytes;
+            part.iov_len -= bytes;
+            return;
+        }
+
+        bytes -= part.iov_len;
+        ++first_part_;
+    }
+
+    if (empty()) {
+        clear();
+    }
+}
+
+}
@@ -0,0 +1,80 @@
+#include "tinyhttp/request_arena.h"
+
+#include <algorithm>
+
+namespace tinyhttp {
+
+namespace {
+
+constexpr size_t MIN_INITIAL_SIZE = 256;
+
+}
+
+void AllocationCounter::add(const AllocationCounter::Stats &stats) noexcept {
+    requests_.fetch_add(stats.requests, std::memory_order_relaxed);
+    allocations_.fetch_add(stats.allocations, std::memory_order_relaxed);
+    heap_allocations_.fetch_add(stats.heap_allocations, std::memory_order_relaxed);
+    heap_bytes_.fetch_add(stats.heap_bytes, std::memory_order_relaxed);
+}
+
+AllocationCounter::Stats AllocationCounter::get_stats() const noexcept {
+    return Stats{
+            requests_.load(std::memory_order_relaxed),
+            allocations_.load(std::memory_order_relaxed),
+            heap_allocations_.load(std::memory_order_relaxed),
+            heap_bytes_.load(std::memory_order_relaxed),
+    };
+}
+
+RequestArena::RequestArena(size_t initial_size, AllocationCounter *counter)
+        : counter_(counter),
+          initial_buffer_(std::make_unique<std::byte[]>(std::max(initial_size, MIN_INITIAL_SIZE))),
+          heap_(stats_),
+          arena_(initial_buffer_.get(), std::max(initial_size, MIN_INITIAL_SIZE), &heap_) {}
+
+void RequestArena::begin_request() noexcept {
+    report();
+    arena_.release();
+
+    stats_.requests = 1;
+}
+
+RequestArena::~RequestArena() noexcept {
+    report();
+}
+
+void RequestArena::report() noexcept {
+    if (counter_ != nullptr && stats_.requests > 0) {
+        counter_->add(stats_);
+    }
+    stats_ = AllocationCounter::Stats();
+}
+
+void *RequestArena::do_allocate(size_t bytes, size_t alignment) {
+    ++stats_.allocations;
+    return arena_.allocate(bytes, alignment);
+}
+
+void RequestArena::do_deallocate(void *, size_t, size_t) {
+    // nickeskov: memory is released only in begin_request
+}
+
+bool RequestArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+void *RequestArena::HeapResource::do_allocate(size_t bytes, size_t alignment) {
+    ++stats_.heap_allocations;
+    stats_.heap_bytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void RequestArena::HeapResource::do_deallocate(void *p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool RequestArena::HeapResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+}
@@ -0,0 +1,221 @@
+#include "tinyhttp/router.h"
+#include "tinyhttp/errors.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace tinyhttp {
+
+using namespace std::literals::string_literals;
+
+size_t RouteParams::size() const noexcept {
+    return size_;
+}
+
+RouteParams::Param RouteParams::get(size_t index) const noexcept {
+    return index < size_ ? params_[index] : Param{};
+}
+
+std::string_view RouteParams::get(std::string_view name) const noexcept {
+    for (size_t i = 0; i < size_; ++i) {
+        if (params_[i].name == name) {
+            return params_[i].value;
+        }
+    }
+    return {};
+}
+
+Router::Router() : root_(std::make_unique<Node>()) {}
+
+void Router::add(constants::http_method method, std::string_view pattern, Router::handler_t handler) {
+    if (!is_valid_route_pattern(pattern)) {
+        throw errors::RouterError("invalid route pattern: "s.append(pattern));
+    }
+
+    const auto method_index = static_cast<size_t>(method);
+    if (method == constants::http_method::UNSUPPORTED_ || method_index >= METHODS_COUNT || !handler) {
+        throw errors::RouterError("invalid method or handler of route: "s.append(pattern));
+    }
+
+    Node *node = root_.get();
+
+    for (std::string_view rest = pattern; !rest.empty();) {
+        const char symbol = rest.front();
+
+        if (symbol == ':' || symbol == '*') {
+            const size_t name_end = std::min(rest.find('/'), rest.size());
+
+            node = &insert_param(symbol == ':' ? node->param_child : node->wildcard_child,
+                                 rest.substr(1, name_end - 1));
+            rest.remove_prefix(name_end);
+        } else {
+            // nickeskov: pattern is valid, so ':' and '*' can be only at start of segment
+            const size_t label_end = std::min(rest.find_first_of(":*"), rest.size());
+
+            node = &insert_static(*node, rest.substr(0, label_end));
+            rest.remove_prefix(label_end);
+        }
+    }
+
+    if (node->handlers[method_index]) {
+        throw errors::RouterError("route already exists: "s
+                                          .append(constants::get_http_method_text(method))
+                                          .append(" ")
+                                          .append(pattern));
+    }
+
+    node->handlers[method_index] = std::move(handler);
+    node->has_handlers = true;
+}
+
+const Router::handler_t *Router::match(constants::http_method method, std::string_view path,
+                                       RouteParams &params) const noexcept {
+    const Node *path_node = nullptr;
+
+    params.size_ = 0;
+    const Node *node = find(*root_, path, static_cast<size_t>(method), params, path_node);
+
+    return node != nullptr ? &node->handlers[static_cast<size_t>(method)] : nullptr;
+}
+
+HttpResponse Router::dispatch(const HttpRequestView &request) const {
+    const auto method_index = static_cast<size_t>(request.get_method());
+    const Node *path_node = nullptr;
+    RouteParams params;
+
+    const Node *node = find(*root_, request.get_path(), method_index, params, path_node);
+    if (node != nullptr) {
+        return node->handlers[method_index](request, params);
+    }
+
+    if (path_node == nullptr) {
+        return HttpResponse(constants::http_response_status::NotFound, request.get_version(),
+                            request.get_memory_resource());
+    }
+
+    HttpResponse response(constants::http_response_status::MethodNotAllowed, request.get_version(),
+                          request.get_memory_resource());
+
+    std::string allowed_methods;
+    for (size_t i = 0; i < METHODS_COUNT; ++i) {
+        if (path_node->handlers[i]) {
+            if (!allowed_methods.empty()) {
+                allowed_methods += ", ";
+            }
+            allowed_methods += constants::get_http_method_text(static_cast<constants::http_method>(i));
+        }
+    }
+    response.get_headers().emplace(constants::headers::allow, std::move(allowed_methods));
+
+    return response;
+}
+
+Router::~Router() noexcept = default;
+
+Router::Node &Router::insert_static(Router::Node &node, std::string_view label) {
+    Node *current = &node;
+
+    while (!label.empty()) {
+        const size_t index = current->indices.find(label.front());
+
+        if (index == std::string::npos) {
+            auto child = std::make_unique<Node>();
+            child->prefix = label;
+
+            current->indices.push_back(label.front());
+            current->children.push_back(std::move(child));
+            return *current->children.back();
+        }
+
+        auto &child = current->children[index];
+        const auto common_size = static_cast<size_t>(
+                std::mismatch(label.begin(), label.end(), child->prefix.begin(), child->prefix.end()).first
+                - label.begin());
+
+        // nickeskov: edge is split, so its common part becomes node with old edge as the only child
+        if (common_size < child->prefix.size()) {
+            auto split_node = std::make_unique<Node>();
+            split_node->prefix = child->prefix.substr(0, common_size);
+
+            child->prefix.erase(0, common_size);
+            split_node->indices.push_back(child->prefix.front());
+            split_node->children.push_back(std::move(child));
+
+            child = std::move(split_node);
+        }
+
+        current = child.get();
+        label.remove_prefix(common_size);
+    }
+
+    return *current;
+}
+
+Router::Node &Router::insert_param(std::unique_ptr<Node> &param_node, std::string_view name) {
+    if (!param_node) {
+        param_node = std::make_unique<Node>();
+        param_node->param_name = name;
+    } else if (param_node->param_name != name) {
+        throw errors::RouterError("route parameter '"s.append(name)
+                                          .append("' conflicts with '")
+                                          .append(param_node->param_name)
+                                          .append("'"));
+    }
+    return *param_node;
+}
+
+const Router::Node *Router::find(const Router::Node &node, std::string_view path, size_t method_index,
+                                 RouteParams &params, const Router::Node *&path_node) noexcept {
+    if (path.empty() && node.has_handlers) {
+        if (method_index < METHODS_COUNT && node.handlers[method_index]) {
+            return &node;
+        }
+        if (path_node == nullptr) {
+            path_node = &node;
+        }
+    }
+
+    if (!path.empty()) {
+        const size_t index = node.indices.find(path.front());
+
+        if (index != std::string::npos) {
+            const Node &child = *node.children[index];
+
+            if (path.compare(0, child.prefix.size(), child.prefix) == 0) {
+                const Node *found = find(child, path.substr(child.prefix.size()), method_index, params, path_node);
+                if (found != nullptr) {
+                    return found;
+                }
+            }
+        }
+
+        const size_t segment_end = std::min(path.find('/'), path.size());
+
+        if (node.param_child && segment_end > 0 && params.size_ < RouteParams::MAX_PARAMS_COUNT) {
+            params.params_[params.size_++] = {node.param_child->param_name, path.substr(0, segment_end)};
+
+            const Node *found = find(*node.param_child, path.substr(segment_end), method_index, params, path_node);
+            if (found != nullptr) {
+                return found;
+            }
+            --params.size_;
+        }
+    }
+
+    // nickeskov: wildcard matches the rest of path, even empty one
+    if (node.wildcard_child && params.size_ < RouteParams::MAX_PARAMS_COUNT) {
+        const Node &wildcard = *node.wildcard_child;
+
+        if (method_index < METHODS_COUNT && wildcard.handlers[method_index]) {
+            params.params_[params.size_++] = {wildcard.param_name, path};
+            return &wildcard;
+        }
+        if (path_node == nullptr) {
+            path_node = &wildcard;
+        }
+    }
+
+    return nullptr;
+}
+
+}
@@ -2,11 +2,15 @@
 #include "tinyhttp/errors.h"
 #include "tinyhttp/epoll_worker.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <thread>
+#include <utility>
 
 extern "C" {
+#include <pthread.h>
+#include <sched.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -17,11 +21,17 @@ namespace tinyhttp {
 
 using namespace std::literals::string_literals;
 
-Server::Server(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger)
-        : server_sock_fd_(socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP)), logger_(logger) {
+namespace {
+
+unixprimwrap::Descriptor open_acceptor_service(std::string_view ip, uint16_t port, bool reuse_port) {
+    unixprimwrap::Descriptor sock_fd(socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP));
+
+    if (!sock_fd.is_valid()) {
+        throw errors::IoServiceError("cannot create IPV4 socket: "s + std::strerror(errno));
+    }
 
     int yes = 1;
-    int reuseaddr_status = setsockopt(server_sock_fd_.data(),
+    int reuseaddr_status = setsockopt(sock_fd.data(),
                                       SOL_SOCKET,
                                       SO_REUSEADDR,
                                       &yes, sizeof(yes));
@@ -30,6 +40,19 @@ Server::Server(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger)
                 "cannot set SO_REUSEADDR to IPV4 socket: "s + std::strerror(errno));
     }
 
+    // nickeskov: all sockets in SO_REUSEPORT group must set this option before bind,
+    //  without it bind fails if another socket listens on the same address
+    if (reuse_port) {
+        int reuseport_status = setsockopt(sock_fd.data(),
+                                          SOL_SOCKET,
+                                          SO_REUSEPORT,
+                                          &yes, sizeof(yes));
+        if (reuseport_status < 0) {
+            throw errors::IoServiceError(
+                    "cannot set SO_REUSEPORT to IPV4 socket: "s + std::strerror(errno));
+        }
+    }
+
     sockaddr_in addr{};
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port);
@@ -40,7 +63,7 @@ Server::Server(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger)
         throw errors::InvalidAddressError(msg);
     }
 
-    int bind_status = ::bind(server_sock_fd_.data(),
+    int bind_status = ::bind(sock_fd.data(),
                              reinterpret_cast<sockaddr *>(&addr),
                              sizeof(addr));
     if (bind_status < 0) {
@@ -50,14 +73,33 @@ Server::Server(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger)
         throw errors::BindError(msg);
     }
 
-    if (::listen(server_sock_fd_.data(), SOMAXCONN) < 0) {
+    if (::listen(sock_fd.data(), SOMAXCONN) < 0) {
         std::string msg = "cannot start listen on addr=";
         msg += ip;
         msg += ", port=" + std::to_string(port);
         throw errors::ListenError(msg);
     }
 
+    return sock_fd;
+}
+
+bool pin_thread_to_cpu(pthread_t thread, size_t worker_id) {
+    const size_t cpu_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(worker_id % cpu_count, &cpu_set);
+
+    return pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set) == 0;
+}
+
+}
+
+Server::Server(std::string_view ip, uint16_t port, trivilog::BaseLogger &logger)
+        : server_sock_fd_(open_acceptor_service(ip, port, false)), logger_(logger) {
+
     if (port == 0) {
+        sockaddr_in addr{};
         socklen_t addr_size = sizeof(addr);
         int status = getsockname(server_sock_fd_.data(),
                                  reinterpret_cast<sockaddr *>(&addr),
@@ -90,6 +132,18 @@ const unixprimwrap::Descriptor &Server::get_acceptor_service() const noexcept {
     return server_sock_fd_;
 }
 
+HandlerPool *Server::get_handler_pool() const noexcept {
+    return handler_pool_.get();
+}
+
+AllocationCounter &Server::get_allocation_counter() noexcept {
+    return allocation_counter_;
+}
+
+unixprimwrap::Descriptor Server::create_acceptor_service() const {
+    return open_acceptor_service(src_addr_, src_port_, true);
+}
+
 bool Server::is_opened() const noexcept {
     return server_sock_fd_.is_valid();;
 }
@@ -98,6 +152,39 @@ bool Server::is_stopped() const noexcept {
     return is_stopped_;
 }
 
+HttpResponse Server::on_request_view(const HttpRequestView &request) {
+    return on_request(HttpRequest(request));
+}
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+Task<HttpResponse> Server::on_request_async(const HttpRequestView &request, Connection &) {
+    co_return on_request_view(request);
+}
+
+#endif
+
+bool Server::is_body_streamed(const HttpRequestView &) {
+    return false;
+}
+
+#ifdef TINYHTTP_WITH_CXX20_COROUTINES
+
+Task<HttpResponse> Server::on_request_stream_async(const HttpRequestView &request, HttpBodyReader &,
+                                                   Connection &) {
+    co_return HttpResponse(constants::http_response_status::NotImplemented, request.get_version(),
+                           request.get_memory_resource());
+}
+
+#else
+
+HttpResponse Server::on_request_stream(const HttpRequestView &request, HttpBodyReader &) {
+    return HttpResponse(constants::http_response_status::NotImplemented, request.get_version(),
+                        request.get_memory_resource());
+}
+
+#endif
+
 void Server::stop() noexcept {
     is_stopped_ = true;
 }
@@ -113,21 +200,56 @@ void Server::close() {
 }
 
 void Server::run(Server::EventLoopConfig config, size_t thread_counts) {
+    if (config.handler_threads > 0) {
+        handler_pool_ = std::make_unique<HandlerPool>(config.handler_threads, config.handler_queue_size);
+    }
+
+    if (config.reuse_port) {
+        // nickeskov: server socket is bound exclusively by constructor, it is rebound as a member
+        //  of SO_REUSEPORT group, connections pending in its backlog are reset
+        close();
+        server_sock_fd_ = open_acceptor_service(src_addr_, src_port_, true);
+    }
+
     std::vector<std::thread> workers(thread_counts - 1);
 
     size_t id = 0;
 
     for (; id < workers.size(); ++id) {
-        workers[id] = std::thread([id, this](const  Server::EventLoopConfig &cfg) {
-            EpollWorker(id, *this).event_loop(cfg);
-        }, std::ref(config));
+        unixprimwrap::Descriptor acceptor_service;
+        if (config.reuse_port) {
+            acceptor_service = create_acceptor_service();
+        }
+
+        workers[id] = std::thread([id, this](const Server::EventLoopConfig &cfg,
+                                             unixprimwrap::Descriptor worker_acceptor_service) {
+            EpollWorker(id, *this, std::move(worker_acceptor_service)).event_loop(cfg);
+        }, std::ref(config), std::move(acceptor_service));
+
+        if (config.pin_workers_to_cpus && !pin_thread_to_cpu(workers[id].native_handle(), id)) {
+            logger_.warn("cannot pin worker " + std::to_string(id) + " to cpu");
+        }
+    }
+
+    if (config.pin_workers_to_cpus && !pin_thread_to_cpu(pthread_self(), id)) {
+        logger_.warn("cannot pin worker " + std::to_string(id) + " to cpu");
     }
 
+    // nickeskov: last worker accepts on server socket, with reuse_port it is a member of SO_REUSEPORT group too
     EpollWorker(id, *this).event_loop(config);
 
     for (auto &worker : workers) {
         worker.join();
     }
+
+    handler_pool_.reset();
+
+    const auto stats = allocation_counter_.get_stats();
+    if (stats.requests > 0) {
+        logger_.info("allocations per request: " + std::to_string(stats.allocations / stats.requests)
+                     + ", heap allocations per request: " + std::to_string(stats.heap_allocations / stats.requests)
+                     + " [requests=" + std::to_string(stats.requests) + "]");
+    }
 }
 
 }
@@ -0,0 +1,186 @@
+#include "tinyhttp/timer_wheel.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace tinyhttp {
+
+namespace {
+
+constexpr uint64_t SLOTS_MASK = TimerWheel::SLOTS_COUNT - 1;
+
+// nickeskov: count of ticks, which are covered by all levels
+constexpr uint64_t WHEEL_SPAN_BITS = TimerWheel::SLOTS_BITS * TimerWheel::LEVELS_COUNT;
+
+inline uint64_t level_shift(size_t level) noexcept {
+    return TimerWheel::SLOTS_BITS * level;
+}
+
+inline uint64_t low_bits_mask(size_t level) noexcept {
+    return (uint64_t{1} << level_shift(level)) - 1;
+}
+
+}
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, clock_t::time_point now)
+        : tick_(std::max(tick, std::chrono::milliseconds(1))), start_(now) {}
+
+void TimerWheel::schedule(timer_id_t id, clock_t::time_point deadline) {
+    // nickeskov: timer never expires earlier than deadline, but can expire one tick later
+    const uint64_t deadline_tick = std::max(to_tick(deadline) + 1, current_tick_ + 1);
+    if (id < 0) {
+        throw std::out_of_range("negative timer id=" + std::to_string(id));
+    }
+
+    if (timers_.size() <= static_cast<size_t>(id)) {
+        timers_.resize(static_cast<size_t>(id) + 1);
+    }
+
+    auto &timer = timers_[id];
+
+    if (is_scheduled(id)) {
+        // nickeskov: pending entry is reached not later than new deadline and is reinserted then,
+        //  so activity of client doesn't add entry on every event
+        if (deadline_tick >= timer.deadline_tick) {
+            timer.deadline_tick = deadline_tick;
+            return;
+        }
+    } else {
+        ++timers_count_;
+    }
+
+    const uint64_t generation = ++generation_;
+
+    timer = Timer{deadline_tick, generation};
+    insert(SlotEntry{id, generation}, deadline_tick);
+}
+
+void TimerWheel::cancel(timer_id_t id) {
+    if (is_scheduled(id)) {
+        timers_[id].generation = 0;
+        --timers_count_;
+    }
+}
+
+void TimerWheel::expire(clock_t::time_point now, std::vector<timer_id_t> &expired_ids) {
+    const uint64_t now_tick = to_tick(now);
+
+    if (timers_count_ == 0) {
+        // nickeskov: only cancelled timers may be in slots, so wheel can be moved without walking
+        for (auto &level : levels_) {
+            for (auto &slot : level) {
+                slot.clear();
+            }
+        }
+        current_tick_ = std::max(current_tick_, now_tick);
+        return;
+    }
+
+    slot_t slot;
+
+    while (current_tick_ < now_tick) {
+        ++current_tick_;
+
+        // nickeskov: higher levels first, their timers may be moved to lower levels, which are cascaded next
+        for (size_t level = LEVELS_COUNT - 1; level > 0; --level) {
+            if ((current_tick_ & low_bits_mask(level)) == 0) {
+                cascade(level);
+            }
+        }
+
+        slot.clear();
+        slot.swap(levels_[0][current_tick_ & SLOTS_MASK]);
+
+        for (const auto &entry : slot) {
+            if (!is_actual(entry)) {
+                continue;
+            }
+
+            const uint64_t deadline_tick = timers_[entry.id].deadline_tick;
+            if (deadline_tick <= current_tick_) {
+                cancel(entry.id);
+                expired_ids.push_back(entry.id);
+            } else {
+                insert(entry, deadline_tick); // nickeskov: deadline was beyond wheel span
+            }
+        }
+    }
+}
+
+int TimerWheel::get_timeout(clock_t::time_point now) const {
+    if (timers_count_ == 0) {
+        return -1;
+    }
+
+    // nickeskov: wait until next not empty slot of lowest level or until next cascade
+    const uint64_t current_slot = current_tick_ & SLOTS_MASK;
+    uint64_t ticks = SLOTS_COUNT - current_slot;
+
+    for (uint64_t slot = current_slot + 1; slot < SLOTS_COUNT; ++slot) {
+        if (!levels_[0][slot].empty()) {
+            ticks = slot - current_slot;
+            break;
+        }
+    }
+
+    const auto wake_up = start_ + tick_ * (current_tick_ + ticks);
+    if (wake_up <= now) {
+        return 0;
+    }
+
+    const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(wake_up - now);
+    return static_cast<int>(timeout.count());
+}
+
+size_t TimerWheel::size() const noexcept {
+    return timers_count_;
+}
+
+bool TimerWheel::empty() const noexcept {
+    return timers_count_ == 0;
+}
+
+uint64_t TimerWheel::to_tick(clock_t::time_point time_point) const noexcept {
+    if (time_point <= start_) {
+        return 0;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time_point - start_);
+    return static_cast<uint64_t>(elapsed / tick_);
+}
+
+void TimerWheel::insert(const SlotEntry &entry, uint64_t deadline_tick) {
+    // nickeskov: timers beyond wheel span wait in the last slot and are reinserted after it
+    const uint64_t span_end = current_tick_ | ((uint64_t{1} << WHEEL_SPAN_BITS) - 1);
+    const uint64_t slot_tick = std::min(deadline_tick, span_end);
+
+    // nickeskov: level is chosen by highest differing slot index, so slot is reached before wrap
+    size_t level = 0;
+    while (level + 1 < LEVELS_COUNT
+           && (slot_tick >> level_shift(level + 1)) != (current_tick_ >> level_shift(level + 1))) {
+        ++level;
+    }
+
+    levels_[level][(slot_tick >> level_shift(level)) & SLOTS_MASK].push_back(entry);
+}
+
+void TimerWheel::cascade(size_t level) {
+    slot_t slot;
+    slot.swap(levels_[level][(current_tick_ >> level_shift(level)) & SLOTS_MASK]);
+
+    for (const auto &entry : slot) {
+        if (is_actual(entry)) {
+            insert(entry, timers_[entry.id].deadline_tick);
+        }
+    }
+}
+
+bool TimerWheel::is_scheduled(timer_id_t id) const noexcept {
+    return id >= 0 && static_cast<size_t>(id) < timers_.size() && timers_[id].generation != 0;
+}
+
+bool TimerWheel::is_actual(const SlotEntry &entry) const noexcept {
+    return is_scheduled(entry.id) && timers_[entry.id].generation == entry.generation;
+}
+
+}
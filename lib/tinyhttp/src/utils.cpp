@@ -4,6 +4,7 @@
 #include <cctype>
 #include <cstdlib>
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <iomanip>
 #include <ctime>
@@ -16,7 +17,59 @@ extern "C" {
 
 namespace {
 
-constexpr char const *en_us_locale_name = "en_US.UTF8";
+constexpr std::array<std::string_view, 7> week_days = {
+        "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat",
+};
+
+constexpr std::array<std::string_view, 12> months = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec",
+};
+
+inline char *write_two_digits(char *out, int value) noexcept {
+    *out++ = static_cast<char>('0' + value / 10 % 10);
+    *out++ = static_cast<char>('0' + value % 10);
+    return out;
+}
+
+inline char *write_view(char *out, std::string_view view) noexcept {
+    return std::copy(view.begin(), view.end(), out);
+}
+
+struct DateCache {
+    time_t time = -1;
+    std::array<char, tinyhttp::utils::HTTP_DATE_LENGTH> date{};
+    std::string basic_headers;
+};
+
+// NOTE(nickeskov): cache per thread, so no synchronization needed
+thread_local DateCache date_cache; // NOLINT (nickeskov)
+
+const DateCache &get_date_cache() noexcept {
+    auto &cache = date_cache;
+
+    const time_t now = std::time(nullptr);
+    if (now == cache.time) {
+        return cache;
+    }
+
+    cache.time = now;
+    tinyhttp::utils::format_http_date(now, cache.date.data());
+
+    const std::string_view date(cache.date.data(), cache.date.size());
+
+    namespace constants = tinyhttp::constants;
+
+    // nickeskov: length of block is constant, so after first call no allocations happen
+    cache.basic_headers.clear();
+    cache.basic_headers.append(constants::headers::server).append(constants::strings::colon)
+            .append(constants::strings::space).append(constants::server_name)
+            .append(constants::strings::newline)
+            .append(constants::headers::date).append(constants::strings::colon)
+            .append(constants::strings::space).append(date)
+            .append(constants::strings::newline);
+
+    return cache;
+}
 
 }
 
@@ -33,6 +86,45 @@ std::string to_lower(std::string_view view) {
     return lowercase_string;
 }
 
+bool iequals(std::string_view lhs, std::string_view rhs) noexcept {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (to_lower_ascii(lhs[i]) != to_lower_ascii(rhs[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool contains_token(std::string_view header_value, std::string_view token) noexcept {
+    while (!header_value.empty()) {
+        const auto comma_pos = header_value.find(constants::strings::comma);
+
+        auto value_token = header_value.substr(0, comma_pos);
+
+        value_token.remove_prefix(std::min(value_token.find_first_not_of(constants::strings::space),
+                                           value_token.size()));
+        value_token.remove_suffix(value_token.size() - std::min(
+                value_token.find_last_not_of(constants::strings::space) + 1,
+                value_token.size()));
+
+        if (iequals(value_token, token)) {
+            return true;
+        }
+
+        if (comma_pos == std::string_view::npos) {
+            break;
+        }
+        header_value.remove_prefix(comma_pos + constants::strings::comma.size());
+    }
+
+    return false;
+}
+
 std::string decode_url(std::string_view url_view) {
     std::string decoded_url;
 
@@ -116,7 +208,86 @@ std::string now_time_to_str_gmt(const char *fmt, const char *locale) {
 
 std::string get_date_http_str() {
     // RFC 7231, 7.1.1.2: Date
-    return now_time_to_str_gmt("%a, %d %b %Y %T %Z", en_us_locale_name);
+    return std::string(get_cached_date_http_str());
+}
+
+void format_http_date(time_t time, char *out) noexcept {
+    tm date_time{};
+
+    // NOTE(nickeskov): std::gmtime NOT THEAD SAFE, using POSIX gmtime_r to prevent data race
+    gmtime_r(&time, &date_time);
+
+    const int year = date_time.tm_year + 1900;
+
+    out = write_view(out, week_days[date_time.tm_wday]);
+    out = write_view(out, ", ");
+    out = write_two_digits(out, date_time.tm_mday);
+    *out++ = ' ';
+    out = write_view(out, months[date_time.tm_mon]);
+    *out++ = ' ';
+    out = write_two_digits(out, year / 100);
+    out = write_two_digits(out, year);
+    *out++ = ' ';
+    out = write_two_digits(out, date_time.tm_hour);
+    *out++ = ':';
+    out = write_two_digits(out, date_time.tm_min);
+    *out++ = ':';
+    out = write_two_digits(out, date_time.tm_sec);
+    write_view(out, " GMT");
+}
+
+std::string format_http_date(time_t time) {
+    std::string date(HTTP_DATE_LENGTH, '\0');
+    format_http_date(time, date.data());
+    return date;
+}
+
+bool parse_http_date(std::string_view text, time_t &time) noexcept {
+    // nickeskov: "Sun, 06 Nov 1994 08:49:37 GMT"
+    if (text.size() != HTTP_DATE_LENGTH
+        || text.substr(3, 2) != ", " || text[7] != ' ' || text[11] != ' '
+        || text[16] != ' ' || text[19] != ':' || text[22] != ':' || text.substr(25) != " GMT") {
+        return false;
+    }
+
+    bool is_valid = true;
+    auto parse_number = [text, &is_valid](size_t pos, size_t len) {
+        int number = 0;
+        for (auto c : text.substr(pos, len)) {
+            if (!std::isdigit(static_cast<unsigned char>(c))) {
+                is_valid = false;
+                return 0;
+            }
+            number = number * 10 + (c - '0');
+        }
+        return number;
+    };
+
+    tm date_time{};
+    date_time.tm_mday = parse_number(5, 2);
+    date_time.tm_year = parse_number(12, 4) - 1900;
+    date_time.tm_hour = parse_number(17, 2);
+    date_time.tm_min = parse_number(20, 2);
+    date_time.tm_sec = parse_number(23, 2);
+
+    const auto month_it = std::find(months.begin(), months.end(), text.substr(8, 3));
+    if (!is_valid || month_it == months.end()) {
+        return false;
+    }
+    date_time.tm_mon = static_cast<int>(month_it - months.begin());
+
+    // nickeskov: timegm is not standard, but available in glibc and BSD
+    time = timegm(&date_time);
+    return time != -1;
+}
+
+std::string_view get_cached_date_http_str() noexcept {
+    const auto &date = get_date_cache().date;
+    return std::string_view(date.data(), date.size());
+}
+
+std::string_view get_cached_basic_headers() noexcept {
+    return get_date_cache().basic_headers;
 }
 
 }
@@ -0,0 +1,106 @@
+#ifndef TRIVILOG_TRIVILOG_ASYNC_LOGGER_H
+#define TRIVILOG_TRIVILOG_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cinttypes>
+
+#include "trivilog/base_logger.h"
+
+namespace trivilog {
+
+// Logger for many threads without lock on each message. Every thread formats lines into its own
+// lock-free single producer single consumer ring, background thread drains rings into ostream
+// and flushes it once per flush interval. Messages logged after destruction start are lost.
+class AsyncLogger : public BaseLogger {
+  public:
+    enum class overflow_policy : uint8_t {
+        DROP, // message is dropped and counted, drainer reports count of dropped messages
+        BLOCK, // thread waits while drainer frees space in its ring
+    };
+
+    struct Config {
+        // cppcheck-suppress unusedStructMember
+        size_t ring_size = 64 * 1024; // per thread, rounded up to power of two, longer lines are truncated
+        // cppcheck-suppress unusedStructMember
+        std::chrono::milliseconds flush_interval = std::chrono::milliseconds(100);
+        // cppcheck-suppress unusedStructMember
+        overflow_policy policy = overflow_policy::DROP;
+    };
+
+    // Ostream (like std::cout) must outlive logger
+    explicit AsyncLogger(std::ostream &ostream, const Config &config);
+
+    explicit AsyncLogger(std::ofstream &&ofstream, const Config &config);
+
+    explicit AsyncLogger(const std::string &filename, const Config &config,
+                         std::ios::openmode openmode = std::ios::out);
+
+    AsyncLogger(const AsyncLogger &) = delete;
+
+    AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+    // Waits until all messages logged before call are written and flushed
+    void flush() override;
+
+    [[nodiscard]] uint64_t get_dropped_count() const noexcept;
+
+    ~AsyncLogger() noexcept override;
+
+  protected:
+    void log_to_ostream(std::string_view log_level_name, std::string_view msg) override;
+
+  private:
+    class Ring;
+
+    struct ThreadRing;
+
+    // nickeskov: usually thread logs into one logger, so linear search is enough
+    static thread_local std::vector<ThreadRing> thread_rings_;
+
+    const uint64_t id_;
+    const Config config_;
+
+    std::ofstream ofstream_;
+    std::ostream &ostream_;
+
+    std::atomic<uint64_t> dropped_count_ = 0;
+    std::atomic<uint64_t> unreported_dropped_count_ = 0;
+
+    // nickeskov: set by blocked producers, so drainer doesn't wait for flush interval
+    std::atomic<bool> is_ring_full_ = false;
+
+    // nickeskov: changed under mutex, atomic for blocked producers, which check it without lock
+    std::atomic<bool> is_stopped_ = false;
+
+    // nickeskov: mutex is taken only by drainer, flush and the first message of each thread,
+    //  drainer doesn't hold it while writing into ostream
+    std::mutex mutex_;
+    std::condition_variable drain_cv_;
+    std::condition_variable drained_cv_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    uint64_t drain_requests_ = 0;
+    uint64_t drained_requests_ = 0;
+
+    std::thread drainer_;
+
+    [[nodiscard]] std::ostream &get_ostream() override;
+
+    [[nodiscard]] Ring &get_thread_ring();
+
+    void run_drainer();
+
+    // nickeskov: called by drainer without lock, rings are copied from list under lock
+    void drain(const std::vector<std::shared_ptr<Ring>> &rings);
+};
+
+}
+
+#endif //TRIVILOG_TRIVILOG_ASYNC_LOGGER_H
@@ -37,6 +37,10 @@ class BaseLogger {
   protected:
     virtual void log_to_ostream(std::string_view log_level_name, std::string_view msg);
 
+    // Current GMT time like "2021-01-01 12:00:00", formatted at most once per second for each thread.
+    // View is valid until next call in the same thread
+    [[nodiscard]] static std::string_view get_cached_time() noexcept;
+
   private:
     std::atomic<log_level> level_ = log_level::INFO;
 
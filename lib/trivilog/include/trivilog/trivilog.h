@@ -15,6 +15,7 @@
 #include "trivilog/safe_stdout_logger.h"
 #include "trivilog/safe_stderr_logger.h"
 #include "trivilog/safe_stderr_buff_logger.h"
+#include "trivilog/async_logger.h"
 #include "trivilog/global_logger.h"
 
 namespace trivilog {
@@ -0,0 +1,265 @@
+#include "trivilog/async_logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace trivilog {
+
+namespace {
+
+constexpr size_t MIN_RING_SIZE = 4096;
+
+// nickeskov: head and tail are written by different threads, so they are kept in different cache lines
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+constexpr std::string_view line_start = "[";
+constexpr std::string_view time_end = "] ";
+constexpr std::string_view level_end = " ";
+constexpr std::string_view line_end = "\n";
+
+constexpr std::string_view dropped_level_name = "[WARN ]";
+constexpr std::string_view dropped_message = "trivilog: messages dropped because ring is full: ";
+
+std::atomic<uint64_t> next_logger_id = 0;
+
+size_t round_up_to_power_of_two(size_t size) noexcept {
+    size_t result = MIN_RING_SIZE;
+    while (result < size) {
+        result <<= 1U;
+    }
+    return result;
+}
+
+}
+
+// Byte ring with complete lines, producer publishes line only after it is fully copied,
+// so consumer writes everything between tail and head without parsing
+class AsyncLogger::Ring {
+  public:
+    explicit Ring(size_t size) : capacity_(round_up_to_power_of_two(size)), data_(new char[capacity_]) {}
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    // Producer side
+    bool try_push(std::initializer_list<std::string_view> parts) noexcept {
+        size_t size = 0;
+        for (const auto part : parts) {
+            size += part.size();
+        }
+
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (capacity_ - (head - tail_.load(std::memory_order_acquire)) < size) {
+            return false;
+        }
+
+        auto pos = head;
+        for (const auto part : parts) {
+            copy_in(pos, part);
+            pos += part.size();
+        }
+
+        head_.store(pos, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, returns count of written bytes
+    size_t drain_to(std::ostream &ostream) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        const auto head = head_.load(std::memory_order_acquire);
+        if (head == tail) {
+            return 0;
+        }
+
+        const auto size = head - tail;
+        const auto begin = tail & (capacity_ - 1);
+        const auto first_size = std::min(size, capacity_ - begin);
+
+        ostream.write(data_.get() + begin, static_cast<std::streamsize>(first_size));
+        if (size > first_size) {
+            ostream.write(data_.get(), static_cast<std::streamsize>(size - first_size));
+        }
+
+        tail_.store(head, std::memory_order_release);
+        return size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+  private:
+    const size_t capacity_;
+    std::unique_ptr<char[]> data_;
+
+    // nickeskov: positions only grow, index in data is position modulo capacity
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_ = 0;
+
+    void copy_in(size_t pos, std::string_view part) noexcept {
+        const auto begin = pos & (capacity_ - 1);
+        const auto first_size = std::min(part.size(), capacity_ - begin);
+
+        std::memcpy(data_.get() + begin, part.data(), first_size);
+        std::memcpy(data_.get(), part.data() + first_size, part.size() - first_size);
+    }
+};
+
+struct AsyncLogger::ThreadRing {
+    // cppcheck-suppress unusedStructMember
+    uint64_t logger_id;
+    // cppcheck-suppress unusedStructMember
+    std::shared_ptr<Ring> ring;
+};
+
+thread_local std::vector<AsyncLogger::ThreadRing> AsyncLogger::thread_rings_;
+
+AsyncLogger::AsyncLogger(std::ostream &ostream, const Config &config)
+        : id_(next_logger_id.fetch_add(1)), config_(config), ostream_(ostream) {
+    drainer_ = std::thread(&AsyncLogger::run_drainer, this);
+}
+
+AsyncLogger::AsyncLogger(std::ofstream &&ofstream, const Config &config)
+        : id_(next_logger_id.fetch_add(1)), config_(config), ofstream_(std::move(ofstream)), ostream_(ofstream_) {
+    drainer_ = std::thread(&AsyncLogger::run_drainer, this);
+}
+
+AsyncLogger::AsyncLogger(const std::string &filename, const Config &config, std::ios::openmode openmode)
+        : id_(next_logger_id.fetch_add(1)), config_(config), ofstream_(filename, openmode), ostream_(ofstream_) {
+    drainer_ = std::thread(&AsyncLogger::run_drainer, this);
+}
+
+AsyncLogger::~AsyncLogger() noexcept {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        is_stopped_.store(true, std::memory_order_relaxed);
+    }
+    drain_cv_.notify_one();
+    drainer_.join();
+}
+
+void AsyncLogger::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    const auto request = ++drain_requests_;
+    drain_cv_.notify_one();
+
+    drained_cv_.wait(lock, [this, request] {
+        return drained_requests_ >= request || is_stopped_.load(std::memory_order_relaxed);
+    });
+}
+
+uint64_t AsyncLogger::get_dropped_count() const noexcept {
+    return dropped_count_.load(std::memory_order_relaxed);
+}
+
+void AsyncLogger::log_to_ostream(std::string_view log_level_name, std::string_view msg) {
+    auto &ring = get_thread_ring();
+
+    const auto time = get_cached_time();
+
+    const auto framing_size = line_start.size() + time.size() + time_end.size() + log_level_name.size()
+                              + level_end.size() + line_end.size();
+    if (framing_size + msg.size() > ring.capacity()) {
+        msg = msg.substr(0, ring.capacity() - framing_size);
+    }
+
+    while (!ring.try_push({line_start, time, time_end, log_level_name, level_end, msg, line_end})) {
+        // nickeskov: stopped drainer never frees space, so blocked message is dropped too
+        if (config_.policy == overflow_policy::DROP || is_stopped_.load(std::memory_order_relaxed)) {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            unreported_dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // nickeskov: notify without mutex may be missed, so it is repeated while ring is full
+        is_ring_full_.store(true, std::memory_order_relaxed);
+        drain_cv_.notify_one();
+        std::this_thread::yield();
+    }
+}
+
+std::ostream &AsyncLogger::get_ostream() {
+    return ostream_;
+}
+
+AsyncLogger::Ring &AsyncLogger::get_thread_ring() {
+    for (const auto &thread_ring : thread_rings_) {
+        if (thread_ring.logger_id == id_) {
+            return *thread_ring.ring;
+        }
+    }
+
+    // nickeskov: rings of destroyed loggers are owned only by thread, they are removed here
+    thread_rings_.erase(std::remove_if(thread_rings_.begin(), thread_rings_.end(), [](const ThreadRing &thread_ring) {
+        return thread_ring.ring.use_count() == 1;
+    }), thread_rings_.end());
+
+    auto ring = std::make_shared<Ring>(config_.ring_size);
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        rings_.push_back(ring);
+    }
+
+    thread_rings_.push_back(ThreadRing{id_, ring});
+    return *thread_rings_.back().ring;
+}
+
+void AsyncLogger::run_drainer() {
+    // nickeskov: rings are drained from copy of list, so disk io doesn't block registration and flush calls
+    std::vector<std::shared_ptr<Ring>> rings;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;) {
+        drain_cv_.wait_for(lock, config_.flush_interval, [this] {
+            return is_stopped_.load(std::memory_order_relaxed) || drain_requests_ != drained_requests_
+                   || is_ring_full_.load(std::memory_order_relaxed);
+        });
+
+        is_ring_full_.store(false, std::memory_order_relaxed);
+
+        const auto requests = drain_requests_;
+        const auto is_stopped = is_stopped_.load(std::memory_order_relaxed);
+
+        rings.assign(rings_.begin(), rings_.end());
+
+        lock.unlock();
+        drain(rings);
+        rings.clear();
+        lock.lock();
+
+        // nickeskov: ring owned only by logger belongs to finished thread, it is removed after the last drain
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring> &ring) {
+            return ring.use_count() == 1 && ring->empty();
+        }), rings_.end());
+
+        drained_requests_ = requests;
+        drained_cv_.notify_all();
+
+        if (is_stopped) {
+            break;
+        }
+    }
+}
+
+void AsyncLogger::drain(const std::vector<std::shared_ptr<Ring>> &rings) {
+    for (const auto &ring : rings) {
+        ring->drain_to(ostream_);
+    }
+
+    const auto dropped_count = unreported_dropped_count_.exchange(0, std::memory_order_relaxed);
+    if (dropped_count != 0) {
+        ostream_ << line_start << get_cached_time() << time_end << dropped_level_name << level_end
+                 << dropped_message << dropped_count << line_end;
+    }
+
+    ostream_.flush();
+}
+
+}
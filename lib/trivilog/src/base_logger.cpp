@@ -1,38 +1,29 @@
 #include "trivilog/base_logger.h"
 
+#include <array>
 #include <chrono>
-#include <iomanip>
 #include <ctime>
-#include <sstream>
+#include <ostream>
 
 namespace trivilog {
 
 namespace {
 
-constexpr char const *en_us_locale_name = "en_US.UTF8";
+constexpr char const *time_format = "%Y-%m-%d %T";
 
-// TODO(nickeskov): use strftime function for reduce temporary strings creation and memory allocations
-// TODO(nickeskov): remove stringstream and use something else, because stringstream is heavy
-std::string now_time_to_str_gmt(const char *fmt, const char *locale) {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
+constexpr size_t TIME_BUFFER_SIZE = 32;
 
-    std::stringstream ss;
-    ss.imbue(std::locale(locale));
+struct CachedTime {
+    // cppcheck-suppress unusedStructMember
+    time_t time = -1;
+    // cppcheck-suppress unusedStructMember
+    size_t size = 0;
+    // cppcheck-suppress unusedStructMember
+    std::array<char, TIME_BUFFER_SIZE> buffer{};
+};
 
-    tm out_date_time{};
-
-    // NOTE(nickeskov): std::gmtime NOT THEAD SAFE, using POSIX gmtime_r to prevent data race
-    gmtime_r(&time, &out_date_time);
-
-    ss << std::put_time(&out_date_time, fmt);
-
-    return ss.str();
-}
-
-std::string now_time() {
-    return now_time_to_str_gmt("%Y-%m-%d %T", en_us_locale_name);
-}
+// nickeskov: format has only numeric fields, so strftime doesn't depend on locale here
+thread_local CachedTime cached_time;
 
 constexpr inline std::string_view trace_level_name = "[TRACE]";
 constexpr inline std::string_view debug_level_name = "[DEBUG]";
@@ -120,7 +111,24 @@ void BaseLogger::log(std::string_view msg, log_level level) {
 }
 
 void BaseLogger::log_to_ostream(std::string_view log_level_name, std::string_view msg) {
-    get_ostream() << "[" << now_time() << "] " << log_level_name << " " << msg << std::endl;
+    get_ostream() << "[" << get_cached_time() << "] " << log_level_name << " " << msg << std::endl;
+}
+
+std::string_view BaseLogger::get_cached_time() noexcept {
+    const auto time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+    if (time != cached_time.time) {
+        tm out_date_time{};
+
+        // NOTE(nickeskov): std::gmtime NOT THEAD SAFE, using POSIX gmtime_r to prevent data race
+        gmtime_r(&time, &out_date_time);
+
+        cached_time.size = std::strftime(cached_time.buffer.data(), cached_time.buffer.size(), time_format,
+                                         &out_date_time);
+        cached_time.time = time;
+    }
+
+    return std::string_view(cached_time.buffer.data(), cached_time.size);
 }
 
 }
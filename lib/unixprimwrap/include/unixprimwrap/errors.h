@@ -29,6 +29,11 @@ class DescriptorError : public RuntimeError {
     explicit DescriptorError(std::string_view what_arg);
 };
 
+class PollerError : public RuntimeError {
+  public:
+    explicit PollerError(std::string_view what_arg);
+};
+
 class PipeCreationError : public PipeError {
   public:
     explicit PipeCreationError(std::string_view what_arg);
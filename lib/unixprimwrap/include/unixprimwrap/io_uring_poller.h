@@ -0,0 +1,217 @@
+#ifndef UNIXPRIMWRAP_UNIXPRIMWRAP_IO_URING_POLLER_H
+#define UNIXPRIMWRAP_UNIXPRIMWRAP_IO_URING_POLLER_H
+
+#include <cinttypes>
+#include <vector>
+
+#include "unixprimwrap/descriptor.h"
+#include "unixprimwrap/poller.h"
+
+extern "C" {
+#include <linux/io_uring.h>
+}
+
+namespace unixprimwrap {
+
+// Poller on io_uring requests, uses raw syscalls without liburing.
+// add, modify, remove and re-arming only queue submissions, all of them are submitted
+// by single io_uring_enter call in wait, which also waits for completions.
+// Level triggered fd is watched by one-shot poll, which is re-armed on next wait, so it
+// is reported again only if it is still ready. Edge triggered fd is watched by multishot poll.
+// Acceptor is served by multishot accept and receiver by multishot recv into provided buffer ring
+// (kernel 6.0), so their connections and data are taken from poller without syscalls. They are
+// reported with EPOLLIN while poller has connections or data of them, like level triggered fds.
+// EPOLLEXCLUSIVE is not supported by io_uring poll and is ignored.
+// Writes don't go through ring, owners write by writev and sendfile after EPOLLOUT: linked send/splice
+// requests would read caller buffers and files after forget, until their cancellation completes.
+class IoUringPoller : public Poller {
+  public:
+    static constexpr unsigned DEFAULT_ENTRIES = 4096;
+    static constexpr unsigned DEFAULT_RECV_BUFFERS_COUNT = 256; // power of two
+    static constexpr unsigned DEFAULT_RECV_BUFFER_SIZE = 16384;
+
+    // throws errors::PollerError if io_uring can't be created or kernel is older than 5.13.
+    // Acceptors and receivers are watched by poll like other fds, if kernel is older than 6.0
+    explicit IoUringPoller(unsigned entries = DEFAULT_ENTRIES,
+                           unsigned recv_buffers_count = DEFAULT_RECV_BUFFERS_COUNT,
+                           unsigned recv_buffer_size = DEFAULT_RECV_BUFFER_SIZE);
+
+    int add(int fd, uint32_t events) override;
+
+    int modify(int fd, uint32_t events) override;
+
+    int remove(int fd) override;
+
+    int add_acceptor(int fd, uint32_t events) override;
+
+    int accept(int fd, sockaddr *addr, socklen_t *addr_len) override;
+
+    int add_receiver(int fd, uint32_t events) override;
+
+    ssize_t recv(int fd, void *buf, size_t len) override;
+
+    void forget(int fd) noexcept override;
+
+    int wait(epoll_event *events, int max_events, int timeout, const sigset_t *sigmask) override;
+
+    [[nodiscard]] poller_backend get_backend() const noexcept override;
+
+    ~IoUringPoller() noexcept override;
+
+  private:
+    enum class stream_type : uint8_t {
+        NONE, // nickeskov: fd is watched only by poll
+        ACCEPTOR,
+        RECEIVER,
+    };
+
+    struct Mapping {
+        // cppcheck-suppress unusedStructMember
+        void *data = nullptr;
+        // cppcheck-suppress unusedStructMember
+        size_t size = 0;
+    };
+
+    struct ReceivedBuffer {
+        // cppcheck-suppress unusedStructMember
+        uint16_t id;
+        // cppcheck-suppress unusedStructMember
+        uint32_t offset;
+        // cppcheck-suppress unusedStructMember
+        uint32_t size;
+    };
+
+    // nickeskov: accepted fds or received buffers, which are not taken yet
+    struct Stream {
+        // cppcheck-suppress unusedStructMember
+        stream_type type = stream_type::NONE;
+        // cppcheck-suppress unusedStructMember
+        uint32_t generation = 0; // nickeskov: completions of older requests are dropped
+        // cppcheck-suppress unusedStructMember
+        bool is_armed = false;
+        // cppcheck-suppress unusedStructMember
+        bool is_stalled = false; // nickeskov: recv is stopped by lack of buffers, fd is watched by poll meanwhile
+        // cppcheck-suppress unusedStructMember
+        bool is_eof = false;
+        // cppcheck-suppress unusedStructMember
+        int error = 0;
+        // cppcheck-suppress unusedStructMember
+        size_t head = 0;
+        // cppcheck-suppress unusedStructMember
+        std::vector<int> accepted_fds;
+        // cppcheck-suppress unusedStructMember
+        std::vector<ReceivedBuffer> buffers;
+    };
+
+    struct Watch {
+        // cppcheck-suppress unusedStructMember
+        uint32_t events = 0;
+        // cppcheck-suppress unusedStructMember
+        uint32_t generation = 0; // nickeskov: completions of older requests are ignored
+        // cppcheck-suppress unusedStructMember
+        bool is_watched = false;
+        // cppcheck-suppress unusedStructMember
+        bool is_polled = false; // nickeskov: poll request is armed
+        // cppcheck-suppress unusedStructMember
+        bool is_pending = false; // nickeskov: fd is in pending list
+        // cppcheck-suppress unusedStructMember
+        uint64_t batch = 0; // nickeskov: events of fd are merged into one entry per wait call
+        // cppcheck-suppress unusedStructMember
+        int event_index = 0;
+        // cppcheck-suppress unusedStructMember
+        Stream stream;
+    };
+
+    struct Rearm {
+        // cppcheck-suppress unusedStructMember
+        int fd;
+        // cppcheck-suppress unusedStructMember
+        uint32_t generation;
+    };
+
+    Descriptor ring_fd_;
+
+    Mapping rings_; // nickeskov: submission and completion rings share one mapping
+    Mapping sqes_;
+
+    unsigned *sq_head_ = nullptr;
+    unsigned *sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_sqe *sqe_array_ = nullptr;
+    io_uring_cqe *cqe_array_ = nullptr;
+
+    unsigned pending_count_ = 0; // nickeskov: queued, but not submitted entries
+
+    // nickeskov: provided buffers for multishot recv, ring header is followed by buffers data
+    Mapping recv_buffers_;
+    io_uring_buf *recv_ring_ = nullptr;
+    char *recv_data_ = nullptr;
+    unsigned recv_buffers_count_ = 0;
+    unsigned recv_buffer_size_ = 0;
+    unsigned recv_free_count_ = 0; // nickeskov: buffers owned by kernel
+    uint16_t recv_ring_tail_ = 0;
+
+    bool is_accept_supported_ = false;
+    bool is_recv_supported_ = false;
+
+    uint64_t batch_ = 0;
+
+    std::vector<Watch> watches_; // nickeskov: indexed by fd
+    std::vector<Rearm> rearms_;
+    std::vector<Rearm> stream_rearms_; // nickeskov: generations of streams, not of polls
+    std::vector<int> pending_fds_; // nickeskov: fds with accepted connections or received data
+
+    io_uring_sqe *get_sqe();
+
+    int submit(unsigned min_complete, int timeout, const sigset_t *sigmask);
+
+    void setup_recv_buffers(unsigned count, unsigned size) noexcept;
+
+    void provide_recv_buffer(uint16_t id) noexcept;
+
+    int watch(int fd, uint32_t events, stream_type type);
+
+    [[nodiscard]] Watch *find_watch(int fd) noexcept;
+
+    [[nodiscard]] static uint32_t get_poll_events(const Watch &watch) noexcept;
+
+    void arm(int fd);
+
+    void cancel(int fd);
+
+    void arm_stream(int fd);
+
+    void cancel_stream(int fd);
+
+    void drop_stream(int fd) noexcept;
+
+    void queue_rearms();
+
+    void queue_stream_rearms();
+
+    int reap(epoll_event *events, int max_events);
+
+    void complete_stream(int fd, uint32_t kind, const io_uring_cqe &cqe);
+
+    void drop_completion(uint32_t kind, const io_uring_cqe &cqe) noexcept;
+
+    void fall_back_to_poll(int fd);
+
+    void mark_pending(int fd);
+
+    int report_pending(epoll_event *events, int count, int max_events);
+
+    int push_event(epoll_event *events, int count, int fd, uint32_t fd_events) noexcept;
+
+    [[nodiscard]] static bool has_input(const Stream &stream) noexcept;
+
+    void unmap() noexcept;
+};
+
+}
+
+#endif //UNIXPRIMWRAP_UNIXPRIMWRAP_IO_URING_POLLER_H
@@ -0,0 +1,100 @@
+#ifndef UNIXPRIMWRAP_UNIXPRIMWRAP_POLLER_H
+#define UNIXPRIMWRAP_UNIXPRIMWRAP_POLLER_H
+
+#include <cinttypes>
+#include <memory>
+
+#include "unixprimwrap/descriptor.h"
+
+extern "C" {
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+}
+
+namespace unixprimwrap {
+
+enum class poller_backend : uint8_t {
+    EPOLL,
+    IO_URING,
+    AUTO, // io_uring if kernel supports it, epoll otherwise
+};
+
+// Readiness notification with epoll semantics, events are epoll masks (EPOLLIN, EPOLLOUT, EPOLLET, ...).
+// Methods return -1 and set errno on error like epoll_ctl and epoll_pwait, not thread safe.
+class Poller {
+  public:
+    Poller() = default;
+
+    Poller(const Poller &) = delete;
+
+    Poller &operator=(const Poller &) = delete;
+
+    virtual int add(int fd, uint32_t events) = 0;
+
+    virtual int modify(int fd, uint32_t events) = 0;
+
+    virtual int remove(int fd) = 0;
+
+    // Listening socket, backend may accept its connections in advance, so they must be taken by accept
+    virtual int add_acceptor(int fd, uint32_t events) = 0;
+
+    // Like accept4 with SOCK_NONBLOCK | SOCK_CLOEXEC, returns -1 with EAGAIN if there are no connections
+    virtual int accept(int fd, sockaddr *addr, socklen_t *addr_len) = 0;
+
+    // Connected socket, backend may receive its data in advance into own buffers, so data must be read by recv.
+    // Received data is kept after remove, so fd may be added again, and is dropped by forget
+    virtual int add_receiver(int fd, uint32_t events) = 0;
+
+    // Like recv without flags, returns -1 with EAGAIN if there is no data
+    virtual ssize_t recv(int fd, void *buf, size_t len) = 0;
+
+    // Must be called right before fd is closed, stops watching fd without syscall if backend allows it
+    virtual void forget(int fd) noexcept = 0;
+
+    virtual int wait(epoll_event *events, int max_events, int timeout, const sigset_t *sigmask) = 0;
+
+    [[nodiscard]] virtual poller_backend get_backend() const noexcept = 0;
+
+    virtual ~Poller() noexcept = default;
+};
+
+class EpollPoller : public Poller {
+  public:
+    // throws errors::PollerError if epoll can't be created
+    EpollPoller();
+
+    int add(int fd, uint32_t events) override;
+
+    int modify(int fd, uint32_t events) override;
+
+    int remove(int fd) override;
+
+    int add_acceptor(int fd, uint32_t events) override;
+
+    int accept(int fd, sockaddr *addr, socklen_t *addr_len) override;
+
+    int add_receiver(int fd, uint32_t events) override;
+
+    ssize_t recv(int fd, void *buf, size_t len) override;
+
+    // nickeskov: closed fd is removed from epoll by kernel
+    void forget(int) noexcept override {}
+
+    int wait(epoll_event *events, int max_events, int timeout, const sigset_t *sigmask) override;
+
+    [[nodiscard]] poller_backend get_backend() const noexcept override;
+
+  private:
+    Descriptor epoll_fd_;
+};
+
+// AUTO falls back to epoll if io_uring can't be created, throws errors::PollerError on failure
+std::unique_ptr<Poller> make_poller(poller_backend backend);
+
+const char *to_string(poller_backend backend) noexcept;
+
+}
+
+#endif //UNIXPRIMWRAP_UNIXPRIMWRAP_POLLER_H
@@ -16,6 +16,8 @@ PipeError::PipeError(std::string_view what_arg) : RuntimeError(what_arg) {}
 DescriptorError::DescriptorError(std::string_view what_arg)
         : RuntimeError(what_arg) {}
 
+PollerError::PollerError(std::string_view what_arg)
+        : RuntimeError(what_arg) {}
 
 PipeCreationError::PipeCreationError(std::string_view what_arg)
         : PipeError(what_arg) {}
@@ -0,0 +1,833 @@
+#include "unixprimwrap/io_uring_poller.h"
+#include "unixprimwrap/errors.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+extern "C" {
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+namespace unixprimwrap {
+
+namespace {
+
+// nickeskov: internal requests (poll removals) have this bit in user_data, their completions are skipped
+constexpr uint64_t INTERNAL_REQUEST_BIT = uint64_t{1} << 63u;
+
+// nickeskov: user_data is fd in low half, generation and kind of request in high half
+constexpr uint32_t GENERATION_MASK = 0x1fffffffu;
+constexpr uint32_t KIND_SHIFT = 61u;
+constexpr uint32_t KIND_MASK = 0x3u;
+
+constexpr uint32_t KIND_POLL = 0;
+constexpr uint32_t KIND_ACCEPT = 1;
+constexpr uint32_t KIND_RECV = 2;
+
+constexpr uint16_t RECV_BUFFER_GROUP = 0;
+constexpr unsigned MAX_RECV_BUFFERS_COUNT = 32768;
+
+// nickeskov: these flags are meaningful only for epoll_ctl, they must not get into poll mask
+constexpr uint32_t EPOLL_ONLY_FLAGS = EPOLLET | EPOLLONESHOT | EPOLLEXCLUSIVE | EPOLLWAKEUP;
+
+// nickeskov: EXT_ARG (5.11) is needed for timeout with sigmask, RSRC_TAGS (5.13) marks multishot poll support
+constexpr uint32_t REQUIRED_FEATURES = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP
+                                       | IORING_FEAT_EXT_ARG | IORING_FEAT_RSRC_TAGS;
+
+inline uint64_t make_user_data(int fd, uint32_t generation, uint32_t kind = KIND_POLL) noexcept {
+    return (uint64_t{kind} << KIND_SHIFT) | (uint64_t{generation & GENERATION_MASK} << 32u)
+           | static_cast<uint32_t>(fd);
+}
+
+inline uint32_t to_poll_mask(uint32_t events) noexcept {
+    events &= ~EPOLL_ONLY_FLAGS;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    // nickeskov: kernel swaps halfwords of poll32_events on big endian
+    events = (events << 16u) | (events >> 16u);
+#endif
+    return events;
+}
+
+int io_uring_setup(unsigned entries, io_uring_params *params) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                   const void *arg, size_t arg_size) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+int io_uring_register(int ring_fd, unsigned opcode, const void *arg, unsigned nr_args) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+template<typename T>
+T *at_offset(void *base, uint32_t offset) noexcept {
+    return reinterpret_cast<T *>(static_cast<uint8_t *>(base) + offset);
+}
+
+void *map_ring(int ring_fd, size_t size, off_t offset) noexcept {
+    void *data = ::mmap(nullptr, size,
+                        PROT_READ | PROT_WRITE, // NOLINT this is system values, it's valid
+                        MAP_SHARED | MAP_POPULATE, // NOLINT this is system values, it's valid
+                        ring_fd, offset);
+    return data == MAP_FAILED ? nullptr : data;
+}
+
+}
+
+IoUringPoller::IoUringPoller(unsigned entries, unsigned recv_buffers_count, unsigned recv_buffer_size) {
+    if (recv_buffers_count == 0 || recv_buffers_count > MAX_RECV_BUFFERS_COUNT
+        || (recv_buffers_count & (recv_buffers_count - 1)) != 0 || recv_buffer_size == 0) {
+        throw errors::PollerError("count of io_uring recv buffers must be power of two not greater than "
+                                  + std::to_string(MAX_RECV_BUFFERS_COUNT) + ", buffer size must be positive");
+    }
+
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 2; // nickeskov: multishot polls may produce more completions than submissions
+
+    ring_fd_ = Descriptor{io_uring_setup(entries, &params)};
+    if (!ring_fd_.is_valid()) {
+        throw errors::PollerError("cannot create io_uring: " + std::string(std::strerror(errno)));
+    }
+
+    if ((params.features & REQUIRED_FEATURES) != REQUIRED_FEATURES) {
+        throw errors::PollerError("io_uring of kernel is too old, 5.13 or newer is required");
+    }
+
+    rings_.size = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                           params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    rings_.data = map_ring(ring_fd_.data(), rings_.size, IORING_OFF_SQ_RING);
+
+    sqes_.size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_.data = map_ring(ring_fd_.data(), sqes_.size, IORING_OFF_SQES);
+
+    if (rings_.data == nullptr || sqes_.data == nullptr) {
+        const int errno_code = errno;
+        unmap();
+        throw errors::PollerError("cannot map io_uring: " + std::string(std::strerror(errno_code)));
+    }
+
+    sq_head_ = at_offset<unsigned>(rings_.data, params.sq_off.head);
+    sq_tail_ = at_offset<unsigned>(rings_.data, params.sq_off.tail);
+    sq_mask_ = *at_offset<unsigned>(rings_.data, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    cq_head_ = at_offset<unsigned>(rings_.data, params.cq_off.head);
+    cq_tail_ = at_offset<unsigned>(rings_.data, params.cq_off.tail);
+    cq_mask_ = *at_offset<unsigned>(rings_.data, params.cq_off.ring_mask);
+    sqe_array_ = static_cast<io_uring_sqe *>(sqes_.data);
+    cqe_array_ = at_offset<io_uring_cqe>(rings_.data, params.cq_off.cqes);
+
+    // nickeskov: entries are always used in ring order, so index array is filled once
+    auto *sq_array = at_offset<unsigned>(rings_.data, params.sq_off.array);
+    for (unsigned i = 0; i < sq_entries_; ++i) {
+        sq_array[i] = i;
+    }
+
+    setup_recv_buffers(recv_buffers_count, recv_buffer_size);
+}
+
+int IoUringPoller::add(int fd, uint32_t events) {
+    return watch(fd, events, stream_type::NONE);
+}
+
+int IoUringPoller::modify(int fd, uint32_t events) {
+    auto *watch = find_watch(fd);
+    if (watch == nullptr || !watch->is_watched) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    cancel(fd);
+
+    watch->events = events;
+    ++watch->generation;
+
+    arm(fd);
+
+    // nickeskov: data received while fd was watched for output is reported now
+    if (has_input(watch->stream)) {
+        mark_pending(fd);
+    }
+    return 0;
+}
+
+int IoUringPoller::remove(int fd) {
+    auto *watch = find_watch(fd);
+    if (watch == nullptr || !watch->is_watched) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    cancel(fd);
+
+    watch->is_watched = false;
+    ++watch->generation;
+
+    // nickeskov: receiver keeps receiving, its data is reported when fd is added again
+    if (watch->stream.type == stream_type::ACCEPTOR) {
+        drop_stream(fd);
+    }
+    return 0;
+}
+
+int IoUringPoller::add_acceptor(int fd, uint32_t events) {
+    return watch(fd, events, stream_type::ACCEPTOR);
+}
+
+int IoUringPoller::accept(int fd, sockaddr *addr, socklen_t *addr_len) {
+    auto *watch = find_watch(fd);
+    if (watch == nullptr || watch->stream.type != stream_type::ACCEPTOR) {
+        return ::accept4(fd, addr, addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    }
+
+    auto &stream = watch->stream;
+    while (stream.head < stream.accepted_fds.size()) {
+        const int client_fd = stream.accepted_fds[stream.head++];
+        if (stream.head == stream.accepted_fds.size()) {
+            stream.accepted_fds.clear();
+            stream.head = 0;
+        }
+
+        // nickeskov: multishot accept has no address for each connection, so it is requested only if needed
+        if (addr != nullptr && ::getpeername(client_fd, addr, addr_len) < 0) {
+            ::close(client_fd);
+            continue;
+        }
+        return client_fd;
+    }
+
+    if (stream.error != 0) {
+        errno = stream.error;
+        stream.error = 0;
+        return -1;
+    }
+
+    // nickeskov: no accept request is in flight, so connection can be taken by syscall without reordering
+    if (!stream.is_armed) {
+        return ::accept4(fd, addr, addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    }
+
+    errno = EAGAIN;
+    return -1;
+}
+
+int IoUringPoller::add_receiver(int fd, uint32_t events) {
+    return watch(fd, events, stream_type::RECEIVER);
+}
+
+ssize_t IoUringPoller::recv(int fd, void *buf, size_t len) {
+    auto *watch = find_watch(fd);
+    if (watch == nullptr || watch->stream.type != stream_type::RECEIVER) {
+        return ::recv(fd, buf, len, 0);
+    }
+
+    auto &stream = watch->stream;
+    size_t bytes_read = 0;
+    while (stream.head < stream.buffers.size() && bytes_read < len) {
+        auto &received = stream.buffers[stream.head];
+        const auto size = std::min(len - bytes_read, static_cast<size_t>(received.size));
+
+        std::memcpy(static_cast<char *>(buf) + bytes_read,
+                    recv_data_ + size_t{received.id} * recv_buffer_size_ + received.offset, size);
+
+        bytes_read += size;
+        received.offset += static_cast<uint32_t>(size);
+        received.size -= static_cast<uint32_t>(size);
+
+        if (received.size == 0) {
+            provide_recv_buffer(received.id);
+            ++stream.head;
+        }
+    }
+
+    if (stream.head == stream.buffers.size()) {
+        stream.buffers.clear();
+        stream.head = 0;
+    }
+
+    if (bytes_read > 0) {
+        return static_cast<ssize_t>(bytes_read);
+    }
+
+    if (stream.is_eof) {
+        return 0;
+    }
+
+    if (stream.error != 0) {
+        errno = stream.error;
+        return -1;
+    }
+
+    // nickeskov: recv is stalled or not re-armed yet, nothing is in flight, so data can be read by syscall
+    if (!stream.is_armed) {
+        return ::recv(fd, buf, len, 0);
+    }
+
+    errno = EAGAIN;
+    return -1;
+}
+
+void IoUringPoller::forget(int fd) noexcept {
+    auto *watch = find_watch(fd);
+    if (watch == nullptr) {
+        return;
+    }
+
+    // nickeskov: poll request holds file, so socket is not closed by close() until request is cancelled
+    try {
+        if (watch->is_watched) {
+            remove(fd);
+        }
+    } catch (errors::PollerError &) {
+        // ignored, request is cancelled when ring is destroyed
+    }
+
+    drop_stream(fd);
+}
+
+int IoUringPoller::wait(epoll_event *events, int max_events, int timeout, const sigset_t *sigmask) {
+    if (max_events <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ++batch_;
+
+    // nickeskov: level triggered fds are re-armed only after their events were handled,
+    //  so fds reported by previous wait are re-armed here, before new completions are reaped
+    queue_rearms();
+
+    int count = report_pending(events, reap(events, max_events), max_events);
+
+    // nickeskov: multishot requests ended by completions above and ones, which wait for recv buffers
+    queue_stream_rearms();
+
+    if (count > 0) {
+        // nickeskov: pending fds may be reported on many waits in a row, queued requests (polls of new clients,
+        //  rearms and cancels of forgotten fds) are submitted without waiting, failed submit is retried next time
+        static_cast<void>(submit(0, 0, nullptr));
+        return count;
+    }
+
+    if (submit(timeout == 0 ? 0 : 1, timeout, sigmask) < 0) {
+        if (errno == ETIME) {
+            return 0;
+        }
+        // nickeskov: EBUSY means that completion queue is overflowed, completions must be reaped
+        if (errno != EBUSY) {
+            return -1;
+        }
+    }
+
+    return report_pending(events, reap(events, max_events), max_events);
+}
+
+poller_backend IoUringPoller::get_backend() const noexcept {
+    return poller_backend::IO_URING;
+}
+
+IoUringPoller::~IoUringPoller() noexcept {
+    for (const auto &watch : watches_) {
+        const auto &stream = watch.stream;
+        for (size_t i = stream.head; i < stream.accepted_fds.size(); ++i) {
+            ::close(stream.accepted_fds[i]);
+        }
+    }
+
+    // nickeskov: ring is released after its fd and mappings, so kernel stops receiving before buffers are unmapped
+    ring_fd_.close();
+    unmap();
+}
+
+io_uring_sqe *IoUringPoller::get_sqe() {
+    unsigned tail = *sq_tail_;
+
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        submit(0, 0, nullptr);
+
+        if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            throw errors::PollerError("io_uring submission queue is full");
+        }
+    }
+
+    auto *sqe = &sqe_array_[tail & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    // nickeskov: without SQPOLL kernel reads entries only in io_uring_enter, so tail can be moved before filling
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++pending_count_;
+
+    return sqe;
+}
+
+int IoUringPoller::submit(unsigned min_complete, int timeout, const sigset_t *sigmask) {
+    if (pending_count_ == 0 && min_complete == 0) {
+        return 0;
+    }
+
+    unsigned flags = 0;
+    io_uring_getevents_arg arg{};
+    __kernel_timespec timeout_spec{};
+
+    if (min_complete > 0) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+
+        arg.sigmask = reinterpret_cast<uint64_t>(sigmask);
+        arg.sigmask_sz = _NSIG / 8;
+
+        if (timeout > 0) {
+            timeout_spec.tv_sec = timeout / 1000;
+            timeout_spec.tv_nsec = static_cast<long long>(timeout % 1000) * 1000000;
+            arg.ts = reinterpret_cast<uint64_t>(&timeout_spec);
+        }
+    }
+
+    const int submitted = io_uring_enter(ring_fd_.data(), pending_count_, min_complete, flags,
+                                         min_complete > 0 ? &arg : nullptr,
+                                         min_complete > 0 ? sizeof(arg) : 0);
+    if (submitted > 0) {
+        pending_count_ -= std::min(pending_count_, static_cast<unsigned>(submitted));
+    }
+    return submitted;
+}
+
+void IoUringPoller::setup_recv_buffers(unsigned count, unsigned size) noexcept {
+    const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const auto ring_size = (count * sizeof(io_uring_buf) + page_size - 1) / page_size * page_size;
+
+    recv_buffers_.size = ring_size + size_t{count} * size;
+    recv_buffers_.data = ::mmap(nullptr, recv_buffers_.size,
+                                PROT_READ | PROT_WRITE, // NOLINT this is system values, it's valid
+                                MAP_PRIVATE | MAP_ANONYMOUS, // NOLINT this is system values, it's valid
+                                -1, 0);
+    if (recv_buffers_.data == MAP_FAILED) {
+        recv_buffers_.data = nullptr;
+        return;
+    }
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(recv_buffers_.data);
+    reg.ring_entries = count;
+    reg.bgid = RECV_BUFFER_GROUP;
+
+    // nickeskov: provided buffer rings appeared in 5.19, without them acceptors and receivers are polled
+    if (io_uring_register(ring_fd_.data(), IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        ::munmap(recv_buffers_.data, recv_buffers_.size);
+        recv_buffers_.data = nullptr;
+        return;
+    }
+
+    recv_ring_ = static_cast<io_uring_buf *>(recv_buffers_.data);
+    recv_data_ = static_cast<char *>(recv_buffers_.data) + ring_size;
+    recv_buffers_count_ = count;
+    recv_buffer_size_ = size;
+
+    for (unsigned id = 0; id < count; ++id) {
+        provide_recv_buffer(static_cast<uint16_t>(id));
+    }
+
+    // nickeskov: multishot recv needs 6.0, if it is missing the first recv fails with EINVAL
+    is_accept_supported_ = true;
+    is_recv_supported_ = true;
+}
+
+void IoUringPoller::provide_recv_buffer(uint16_t id) noexcept {
+    auto &buf = recv_ring_[recv_ring_tail_ & (recv_buffers_count_ - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(recv_data_ + size_t{id} * recv_buffer_size_);
+    buf.len = recv_buffer_size_;
+    buf.bid = id;
+
+    // nickeskov: tail of ring overlays resv of the first entry, io_uring_buf_ring has other layout in C++
+    ++recv_ring_tail_;
+    __atomic_store_n(&recv_ring_[0].resv, recv_ring_tail_, __ATOMIC_RELEASE);
+    ++recv_free_count_;
+}
+
+int IoUringPoller::watch(int fd, uint32_t events, stream_type type) {
+    if (fd < 0) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (watches_.size() <= static_cast<size_t>(fd)) {
+        watches_.resize(static_cast<size_t>(fd) + 1);
+    }
+
+    auto &watch = watches_[fd];
+    if (watch.is_watched) {
+        errno = EEXIST;
+        return -1;
+    }
+
+    // nickeskov: stream of fd added again after remove is resumed as is
+    auto &stream = watch.stream;
+    if (stream.type == stream_type::NONE && type != stream_type::NONE
+        && (type == stream_type::ACCEPTOR ? is_accept_supported_ : is_recv_supported_)) {
+        stream.type = type;
+        arm_stream(fd);
+    }
+
+    watch.events = events;
+    watch.is_watched = true;
+    ++watch.generation;
+
+    // nickeskov: errors of poll request (e.g. bad fd) are reported later as EPOLLERR event
+    arm(fd);
+
+    if (has_input(stream)) {
+        mark_pending(fd);
+    }
+    return 0;
+}
+
+IoUringPoller::Watch *IoUringPoller::find_watch(int fd) noexcept {
+    if (fd < 0 || static_cast<size_t>(fd) >= watches_.size()) {
+        return nullptr;
+    }
+    return &watches_[fd];
+}
+
+uint32_t IoUringPoller::get_poll_events(const Watch &watch) noexcept {
+    // nickeskov: input of streams is reported by their completions, poll waits only for the rest
+    if (watch.stream.type != stream_type::NONE && !watch.stream.is_stalled) {
+        return watch.events & ~static_cast<uint32_t>(EPOLLIN);
+    }
+    return watch.events;
+}
+
+void IoUringPoller::arm(int fd) {
+    auto &watch = watches_[fd];
+
+    const auto events = get_poll_events(watch);
+    if (to_poll_mask(events) == 0) {
+        return;
+    }
+
+    auto *sqe = get_sqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = to_poll_mask(events);
+    sqe->len = (events & EPOLLET) ? IORING_POLL_ADD_MULTI : 0;
+    sqe->user_data = make_user_data(fd, watch.generation);
+
+    watch.is_polled = true;
+}
+
+void IoUringPoller::cancel(int fd) {
+    auto &watch = watches_[fd];
+    if (!watch.is_polled) {
+        return;
+    }
+
+    auto *sqe = get_sqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = make_user_data(fd, watch.generation);
+    sqe->user_data = INTERNAL_REQUEST_BIT;
+
+    watch.is_polled = false;
+}
+
+void IoUringPoller::arm_stream(int fd) {
+    auto &stream = watches_[fd].stream;
+
+    auto *sqe = get_sqe();
+    sqe->fd = fd;
+
+    if (stream.type == stream_type::ACCEPTOR) {
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        sqe->user_data = make_user_data(fd, stream.generation, KIND_ACCEPT);
+    } else {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = RECV_BUFFER_GROUP;
+        sqe->user_data = make_user_data(fd, stream.generation, KIND_RECV);
+    }
+
+    stream.is_armed = true;
+    stream.is_stalled = false;
+}
+
+void IoUringPoller::cancel_stream(int fd) {
+    auto &stream = watches_[fd].stream;
+    if (!stream.is_armed) {
+        return;
+    }
+
+    auto *sqe = get_sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = make_user_data(fd, stream.generation,
+                               stream.type == stream_type::ACCEPTOR ? KIND_ACCEPT : KIND_RECV);
+    sqe->user_data = INTERNAL_REQUEST_BIT;
+
+    stream.is_armed = false;
+}
+
+void IoUringPoller::drop_stream(int fd) noexcept {
+    auto &stream = watches_[fd].stream;
+    if (stream.type == stream_type::NONE) {
+        return;
+    }
+
+    try {
+        cancel_stream(fd);
+    } catch (errors::PollerError &) {
+        // ignored, completions of old generation are dropped
+    }
+
+    for (size_t i = stream.head; i < stream.accepted_fds.size(); ++i) {
+        ::close(stream.accepted_fds[i]);
+    }
+    for (size_t i = stream.head; i < stream.buffers.size(); ++i) {
+        provide_recv_buffer(stream.buffers[i].id);
+    }
+
+    // nickeskov: generation is kept growing, so late completions of dropped requests are recognized
+    const auto generation = stream.generation + 1;
+    stream = Stream{};
+    stream.generation = generation;
+}
+
+void IoUringPoller::queue_rearms() {
+    for (const auto &rearm : rearms_) {
+        const auto &watch = watches_[rearm.fd];
+
+        // nickeskov: fd may be modified or removed after its event
+        if (watch.is_watched && watch.generation == rearm.generation && !watch.is_polled) {
+            arm(rearm.fd);
+        }
+    }
+    rearms_.clear();
+}
+
+void IoUringPoller::queue_stream_rearms() {
+    // nickeskov: each recv takes at least one buffer, the rest wait until recv calls return buffers
+    auto free_count = recv_free_count_;
+    size_t kept_count = 0;
+    for (const auto &rearm : stream_rearms_) {
+        const auto &stream = watches_[rearm.fd].stream;
+        if (stream.type == stream_type::NONE || stream.generation != rearm.generation || stream.is_armed) {
+            continue;
+        }
+
+        if (stream.type == stream_type::RECEIVER) {
+            if (free_count == 0) {
+                stream_rearms_[kept_count++] = rearm;
+                continue;
+            }
+            --free_count;
+        }
+
+        arm_stream(rearm.fd);
+    }
+    stream_rearms_.resize(kept_count);
+}
+
+int IoUringPoller::reap(epoll_event *events, int max_events) {
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+    int count = 0;
+    for (; head != tail; ++head) {
+        const auto &cqe = cqe_array_[head & cq_mask_];
+
+        if (cqe.user_data & INTERNAL_REQUEST_BIT) {
+            continue;
+        }
+
+        const auto fd = static_cast<int>(cqe.user_data & 0xffffffffu);
+        const auto generation = static_cast<uint32_t>(cqe.user_data >> 32u) & GENERATION_MASK;
+        const auto kind = static_cast<uint32_t>(cqe.user_data >> KIND_SHIFT) & KIND_MASK;
+
+        auto *watch = find_watch(fd);
+
+        // nickeskov: stream completions are only queued, so they are reaped even if events array is full
+        if (kind != KIND_POLL) {
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                --recv_free_count_;
+            }
+
+            if (watch == nullptr || (watch->stream.generation & GENERATION_MASK) != generation) {
+                drop_completion(kind, cqe);
+            } else {
+                complete_stream(fd, kind, cqe);
+            }
+            continue;
+        }
+
+        if (watch == nullptr || !watch->is_watched || (watch->generation & GENERATION_MASK) != generation) {
+            continue; // nickeskov: completion of cancelled or replaced request
+        }
+
+        if (watch->batch != batch_ && count == max_events) {
+            break;
+        }
+
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            watch->is_polled = false;
+        }
+
+        count = push_event(events, count, fd,
+                           cqe.res < 0 ? static_cast<uint32_t>(EPOLLERR) : static_cast<uint32_t>(cqe.res));
+
+        // nickeskov: failed request is not re-armed, owner closes fd after EPOLLERR
+        if (!watch->is_polled && cqe.res >= 0) {
+            rearms_.push_back(Rearm{fd, watch->generation});
+        }
+    }
+
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return count;
+}
+
+void IoUringPoller::complete_stream(int fd, uint32_t kind, const io_uring_cqe &cqe) {
+    auto &watch = watches_[fd];
+    auto &stream = watch.stream;
+
+    const bool has_more = cqe.flags & IORING_CQE_F_MORE;
+    if (!has_more) {
+        stream.is_armed = false;
+    }
+
+    if (cqe.res == -EINVAL) {
+        if (kind == KIND_ACCEPT) {
+            is_accept_supported_ = false;
+        } else {
+            is_recv_supported_ = false;
+        }
+        fall_back_to_poll(fd);
+        return;
+    }
+
+    if (kind == KIND_ACCEPT) {
+        if (cqe.res >= 0) {
+            stream.accepted_fds.push_back(cqe.res);
+        } else {
+            stream.error = -cqe.res;
+        }
+    } else if (cqe.res > 0) {
+        stream.buffers.push_back(ReceivedBuffer{
+                static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT), 0, static_cast<uint32_t>(cqe.res)});
+    } else if (cqe.res == 0) {
+        stream.is_eof = true;
+    } else if (cqe.res == -ENOBUFS) {
+        // nickeskov: fd is polled for input until recv gets buffers back, recv calls read it by syscall meanwhile
+        stream.is_stalled = true;
+        if (watch.is_watched) {
+            cancel(fd);
+            ++watch.generation;
+            arm(fd);
+        }
+    } else {
+        stream.error = -cqe.res;
+    }
+
+    if (has_input(stream)) {
+        mark_pending(fd);
+    }
+
+    if (!has_more && !stream.is_eof && (kind == KIND_ACCEPT || stream.error == 0)) {
+        stream_rearms_.push_back(Rearm{fd, stream.generation});
+    }
+}
+
+void IoUringPoller::drop_completion(uint32_t kind, const io_uring_cqe &cqe) noexcept {
+    if (kind == KIND_ACCEPT && cqe.res >= 0) {
+        ::close(cqe.res);
+    }
+
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+        provide_recv_buffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+}
+
+void IoUringPoller::fall_back_to_poll(int fd) {
+    auto &watch = watches_[fd];
+
+    // nickeskov: stream is never armed again, fd is polled for input like any other fd
+    drop_stream(fd);
+
+    if (watch.is_watched) {
+        cancel(fd);
+        ++watch.generation;
+        arm(fd);
+    }
+}
+
+void IoUringPoller::mark_pending(int fd) {
+    auto &watch = watches_[fd];
+    if (!watch.is_pending) {
+        watch.is_pending = true;
+        pending_fds_.push_back(fd);
+    }
+}
+
+int IoUringPoller::report_pending(epoll_event *events, int count, int max_events) {
+    size_t kept_count = 0;
+    for (const auto fd : pending_fds_) {
+        auto &watch = watches_[fd];
+
+        bool is_kept = false;
+        if (watch.is_watched && (watch.events & EPOLLIN) && has_input(watch.stream)) {
+            if (watch.batch == batch_ || count < max_events) {
+                count = push_event(events, count, fd, EPOLLIN);
+                // nickeskov: level triggered fd is reported on each wait until its input is taken
+                is_kept = !(watch.events & EPOLLET);
+            } else {
+                is_kept = true;
+            }
+        }
+
+        if (is_kept) {
+            pending_fds_[kept_count++] = fd;
+        } else {
+            watch.is_pending = false;
+        }
+    }
+    pending_fds_.resize(kept_count);
+
+    return count;
+}
+
+int IoUringPoller::push_event(epoll_event *events, int count, int fd, uint32_t fd_events) noexcept {
+    auto &watch = watches_[fd];
+
+    // nickeskov: poll and stream completions of one fd are merged, epoll reports fd once per wait too
+    if (watch.batch == batch_) {
+        events[watch.event_index].events |= fd_events;
+        return count;
+    }
+
+    watch.batch = batch_;
+    watch.event_index = count;
+
+    events[count].events = fd_events;
+    events[count].data.fd = fd;
+    return count + 1;
+}
+
+bool IoUringPoller::has_input(const Stream &stream) noexcept {
+    return stream.head < stream.accepted_fds.size() || stream.head < stream.buffers.size()
+           || stream.is_eof || stream.error != 0;
+}
+
+void IoUringPoller::unmap() noexcept {
+    for (auto *mapping : {&rings_, &sqes_, &recv_buffers_}) {
+        if (mapping->data != nullptr) {
+            ::munmap(mapping->data, mapping->size);
+            mapping->data = nullptr;
+        }
+    }
+}
+
+}
@@ -0,0 +1,100 @@
+#include "unixprimwrap/poller.h"
+#include "unixprimwrap/io_uring_poller.h"
+#include "unixprimwrap/errors.h"
+
+#include <cstring>
+#include <string>
+
+namespace unixprimwrap {
+
+namespace {
+
+int epoll_act(int epoll_fd, int act, int fd, uint32_t events) {
+    struct epoll_event epoll_event{};
+    epoll_event.events = events;
+    epoll_event.data.fd = fd;
+    return epoll_ctl(epoll_fd, act, fd, &epoll_event);
+}
+
+}
+
+EpollPoller::EpollPoller() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {
+    if (!epoll_fd_.is_valid()) {
+        throw errors::PollerError("cannot create epoll entity: " + std::string(std::strerror(errno)));
+    }
+}
+
+int EpollPoller::add(int fd, uint32_t events) {
+    return epoll_act(epoll_fd_.data(), EPOLL_CTL_ADD, fd, events);
+}
+
+int EpollPoller::modify(int fd, uint32_t events) {
+    return epoll_act(epoll_fd_.data(), EPOLL_CTL_MOD, fd, events);
+}
+
+int EpollPoller::remove(int fd) {
+    return epoll_act(epoll_fd_.data(), EPOLL_CTL_DEL, fd, 0);
+}
+
+int EpollPoller::add_acceptor(int fd, uint32_t events) {
+    return add(fd, events);
+}
+
+int EpollPoller::accept(int fd, sockaddr *addr, socklen_t *addr_len) {
+    return ::accept4(fd, addr, addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+}
+
+int EpollPoller::add_receiver(int fd, uint32_t events) {
+    return add(fd, events);
+}
+
+ssize_t EpollPoller::recv(int fd, void *buf, size_t len) {
+    return ::recv(fd, buf, len, 0);
+}
+
+int EpollPoller::wait(epoll_event *events, int max_events, int timeout, const sigset_t *sigmask) {
+    return epoll_pwait(epoll_fd_.data(), events, max_events, timeout, sigmask);
+}
+
+poller_backend EpollPoller::get_backend() const noexcept {
+    return poller_backend::EPOLL;
+}
+
+std::unique_ptr<Poller> make_poller(poller_backend backend) {
+    switch (backend) {
+        case poller_backend::IO_URING: {
+            return std::make_unique<IoUringPoller>();
+        }
+        case poller_backend::AUTO: {
+            try {
+                return std::make_unique<IoUringPoller>();
+            } catch (errors::PollerError &) {
+                // nickeskov: io_uring may be disabled by sysctl or seccomp, or kernel is too old
+                return std::make_unique<EpollPoller>();
+            }
+        }
+        case poller_backend::EPOLL: // fallthrough
+        default: {
+            return std::make_unique<EpollPoller>();
+        }
+    }
+}
+
+const char *to_string(poller_backend backend) noexcept {
+    switch (backend) {
+        case poller_backend::EPOLL: {
+            return "epoll";
+        }
+        case poller_backend::IO_URING: {
+            return "io_uring";
+        }
+        case poller_backend::AUTO: {
+            return "auto";
+        }
+        default: {
+            return "unknown";
+        }
+    }
+}
+
+}